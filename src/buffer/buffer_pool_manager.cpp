@@ -12,15 +12,71 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <sys/mman.h>
+#include <algorithm>
+#include <future>  // NOLINT
 #include <list>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
 
 namespace bustub {
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager)
+
+namespace {
+
+/** Waits for an asynchronous page read or write, false if it failed. */
+bool CompletedIO(std::future<void> *io) {
+  try {
+    io->get();
+    return true;
+  } catch (const Exception &e) {
+    return false;
+  }
+}
+
+}  // namespace
+
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager,
+                                     ReplacerType replacer_type, bool use_huge_pages)
     : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // We allocate a consecutive memory space for the buffer pool.
-  pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size);
+  // We allocate a consecutive memory space for the buffer pool. Frame data is page aligned, so a disk manager doing
+  // direct I/O transfers straight into it, and only faulted in once a frame is first used.
+  frames_size_ = pool_size_ * PAGE_SIZE;
+  if (use_huge_pages) {
+    // explicit huge pages come in 2 MB units and only exist if the administrator reserved some
+    size_t huge_size = (frames_size_ + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    void *frames = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (frames != MAP_FAILED) {
+      frames_ = static_cast<char *>(frames);
+      frames_size_ = huge_size;
+    }
+  }
+  if (frames_ == nullptr && frames_size_ > 0) {
+    void *frames = mmap(nullptr, frames_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (frames == MAP_FAILED) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the buffer pool frames");
+    }
+    frames_ = static_cast<char *>(frames);
+    if (use_huge_pages) {
+      // fall back to transparent huge pages
+      madvise(frames_, frames_size_, MADV_HUGEPAGE);
+    }
+  }
+  pages_ = static_cast<Page *>(::operator new(sizeof(Page) * pool_size_));
+  for (size_t i = 0; i < pool_size_; ++i) {
+    new (pages_ + i) Page(frames_ + i * PAGE_SIZE);
+  }
+  io_cv_ = new std::condition_variable[pool_size_];
+  if (replacer_type == ReplacerType::CLOCK) {
+    replacer_ = new ClockReplacer(pool_size);
+  } else if (replacer_type == ReplacerType::LRUK) {
+    // remember the history of as many evicted pages as there are frames
+    replacer_ = new LRUKReplacer(pool_size, LRUK_REPLACER_K, pool_size);
+  } else {
+    replacer_ = new LRUReplacer(pool_size);
+  }
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
@@ -28,8 +84,26 @@ BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager
   }
 }
 
+BufferPoolManager::BufferPoolManager(DiskManager *disk_manager, LogManager *log_manager)
+    : pool_size_(0),
+      pages_(nullptr),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      replacer_(nullptr),
+      io_cv_(nullptr) {}
+
 BufferPoolManager::~BufferPoolManager() {
-  delete[] pages_;
+  StopFlusherThread();
+  StopPrefetchThread();
+  // a parallel pool has no frames of its own, only the pool size of its instances
+  if (pages_ != nullptr) {
+    for (size_t i = 0; i < pool_size_; ++i) {
+      pages_[i].~Page();
+    }
+    ::operator delete(pages_);
+    munmap(frames_, frames_size_);
+  }
+  delete[] io_cv_;
   delete replacer_;
 }
 
@@ -44,49 +118,80 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   if (page_id == INVALID_PAGE_ID) {
     return nullptr;
   }
-  latch_.lock();
-
+  std::unique_lock<std::mutex> lock(latch_);
   frame_id_t frame_num = -1;
+  page_id_t dirty_pageId = INVALID_PAGE_ID;
   Page *ptr = nullptr;
-  auto itor = page_table_.find(page_id);
-  if (itor != page_table_.end()) {
-    frame_num = itor->second;
-    ptr = pages_ + frame_num;
-    replacer_->Pin(frame_num);
-    ptr->pin_count_++;
-    latch_.unlock();
-    return ptr;
-  }
-  page_id_t dirty_pageId = -1;
-  if (!free_list_.empty()) {
-    frame_num = free_list_.back();
-    free_list_.pop_back();
-    ptr = pages_ + frame_num;
-  } else if (replacer_->Victim(&frame_num)) {
-    ptr = pages_ + frame_num;
-    assert(ptr->GetPinCount() == 0);
-    page_table_.erase(ptr->GetPageId());
-    if (ptr->IsDirty()) {
-      dirty_pageId = ptr->GetPageId();
+  while (true) {
+    // An eviction may still be writing P back; reading it from disk before that finishes would see stale data.
+    auto evict_itor = evicting_.find(page_id);
+    while (evict_itor != evicting_.end()) {
+      io_cv_[evict_itor->second].wait(lock);
+      evict_itor = evicting_.find(page_id);
     }
-  } else {
-    latch_.unlock();
 
-    return nullptr;
+    auto itor = page_table_.find(page_id);
+    if (itor != page_table_.end()) {
+      frame_num = itor->second;
+      ptr = pages_ + frame_num;
+      replacer_->Pin(frame_num);
+      replacer_->RecordAccess(frame_num, page_id);
+      ptr->pin_count_++;
+      // another thread may still be reading P in, wait for it instead of reading P twice
+      io_cv_[frame_num].wait(lock, [ptr] { return !ptr->io_in_progress_; });
+      if (ptr->page_id_ != page_id) {
+        // a read-ahead failed to read P, the last fetch that waited for it gives the frame back
+        if (--ptr->pin_count_ == 0) {
+          free_list_.push_back(frame_num);
+        }
+        return nullptr;
+      }
+      return ptr;
+    }
+    frame_id_t busy_frame = -1;
+    if (AcquireFrame(&frame_num, &dirty_pageId, &busy_frame)) {
+      break;
+    }
+    if (busy_frame == -1) {
+      return nullptr;
+    }
+    // every evictable frame is being written by the flusher or read by a read-ahead, wait for one and look again
+    io_cv_[busy_frame].wait(lock, [this, busy_frame] { return !pages_[busy_frame].io_in_progress_; });
   }
+  ptr = pages_ + frame_num;
+  if (dirty_pageId != INVALID_PAGE_ID) {
+    evicting_[dirty_pageId] = frame_num;
+  }
+  // reserve the frame for P, it stays pinned so nobody can evict it while the latch is released
   page_table_[page_id] = frame_num;
   ptr->page_id_ = page_id;
   ptr->pin_count_ = 1;
   ptr->is_dirty_ = false;
+  ptr->io_in_progress_ = true;
+  replacer_->RecordAccess(frame_num, page_id);
+  LoadFrame(&lock, frame_num, dirty_pageId);
+  lock.unlock();
+  io_cv_[frame_num].notify_all();
+
+  return ptr;
+}
+
+void BufferPoolManager::LoadFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_num, page_id_t dirty_page_id) {
+  Page *ptr = pages_ + frame_num;
+  lock->unlock();
+
   // io operation
-  if (dirty_pageId != -1) {
-    disk_manager_->WritePage(dirty_pageId, ptr->GetData());
+  if (dirty_page_id != INVALID_PAGE_ID) {
+    disk_manager_->WritePage(dirty_page_id, ptr->GetData());
   }
   ptr->ResetMemory();
-  disk_manager_->ReadPage(page_id, ptr->GetData());
-  latch_.unlock();
+  disk_manager_->ReadPage(ptr->page_id_, ptr->GetData());
 
-  return ptr;
+  lock->lock();
+  ptr->io_in_progress_ = false;
+  if (dirty_page_id != INVALID_PAGE_ID) {
+    evicting_.erase(dirty_page_id);
+  }
 }
 
 bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
@@ -110,87 +215,178 @@ bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
 // flush the page whether the page is dirty or not
 bool BufferPoolManager::FlushPageImpl(page_id_t page_id) {
   // Make sure you call DiskManager::WritePage!
-  latch_.lock();
+  std::unique_lock<std::mutex> lock(latch_);
   if (page_id == INVALID_PAGE_ID || page_table_.find(page_id) == page_table_.end()) {
-    latch_.unlock();
-
     return false;
   }
   frame_id_t frame_num = page_table_[page_id];
   Page *ptr = pages_ + frame_num;
+  // the frame does not hold the page's data until its read finishes; the reader keeps it pinned meanwhile
+  io_cv_[frame_num].wait(lock, [ptr] { return !ptr->io_in_progress_; });
   ptr->is_dirty_ = false;
   // io
   disk_manager_->WritePage(page_id, ptr->GetData());
-  latch_.unlock();
 
   return true;
 }
 
-Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
+Page *BufferPoolManager::NewPageImpl(page_id_t *page_id, page_id_t hint) {
   // 0.   Make sure you call DiskManager::AllocatePage!
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
-  latch_.lock();
+  std::unique_lock<std::mutex> lock(latch_);
   // all pined
   if (free_list_.empty() && replacer_->Size() == 0) {
     *page_id = INVALID_PAGE_ID;
-    latch_.unlock();
+    return nullptr;
+  }
+  page_id_t newid = disk_manager_->AllocatePage(hint);
+  Page *ptr = InstallNewPage(newid, &lock);
+  if (ptr == nullptr) {
+    disk_manager_->DeallocatePage(newid);
+    newid = INVALID_PAGE_ID;
+  }
+  *page_id = newid;
 
+  return ptr;
+}
+
+Page *BufferPoolManager::NewPageWithId(page_id_t page_id) {
+  std::unique_lock<std::mutex> lock(latch_);
+  if (free_list_.empty() && replacer_->Size() == 0) {
     return nullptr;
   }
+  return InstallNewPage(page_id, &lock);
+}
+
+bool BufferPoolManager::HasFreeFrame() {
+  std::scoped_lock lock(latch_);
+  return !free_list_.empty() || replacer_->Size() > 0;
+}
+
+Page *BufferPoolManager::InstallNewPage(page_id_t newid, std::unique_lock<std::mutex> *lock) {
   frame_id_t frame_num = -1;
+  page_id_t dirty_pageId = INVALID_PAGE_ID;
   Page *ptr = nullptr;
-  page_id_t dirty_pageId = -1;
-  if (!free_list_.empty()) {
-    frame_num = free_list_.back();
-    free_list_.pop_back();
-    ptr = pages_ + frame_num;
-  } else if (replacer_->Victim(&frame_num)) {
-    ptr = pages_ + frame_num;
-    assert(ptr->GetPinCount() == 0);
-    page_table_.erase(ptr->GetPageId());
-    if (ptr->IsDirty()) {
-      dirty_pageId = ptr->GetPageId();
+  while (true) {
+    // a read-ahead may have loaded the page while its id was already allocated, reuse that frame
+    auto itor = page_table_.find(newid);
+    if (itor != page_table_.end()) {
+      frame_num = itor->second;
+      ptr = pages_ + frame_num;
+      replacer_->Pin(frame_num);
+      replacer_->RecordAccess(frame_num, newid);
+      ptr->pin_count_++;
+      io_cv_[frame_num].wait(*lock, [ptr] { return !ptr->io_in_progress_; });
+      // the read-ahead may have failed and given up the frame, which the new page takes over all the same
+      page_table_[newid] = frame_num;
+      ptr->page_id_ = newid;
+      ptr->is_dirty_ = false;
+      ptr->ResetMemory();
+      disk_manager_->WritePage(newid, ptr->GetData());
+      return ptr;
+    }
+    frame_id_t busy_frame = -1;
+    if (AcquireFrame(&frame_num, &dirty_pageId, &busy_frame)) {
+      break;
+    }
+    if (busy_frame == -1) {
+      return nullptr;
     }
+    io_cv_[busy_frame].wait(*lock, [this, busy_frame] { return !pages_[busy_frame].io_in_progress_; });
   }
-  page_id_t newid = disk_manager_->AllocatePage();
+  ptr = pages_ + frame_num;
   page_table_[newid] = frame_num;
-  assert(ptr != nullptr);
   ptr->page_id_ = newid;
   ptr->pin_count_ = 1;
   ptr->is_dirty_ = false;
+  replacer_->RecordAccess(frame_num, newid);
   // io
-  if (dirty_pageId != -1) {
+  if (dirty_pageId != INVALID_PAGE_ID) {
     disk_manager_->WritePage(dirty_pageId, ptr->GetData());
   }
   ptr->ResetMemory();
   disk_manager_->WritePage(newid, ptr->GetData());
-  *page_id = newid;
-  latch_.unlock();
 
   return ptr;
 }
 
+bool BufferPoolManager::AcquireFrame(frame_id_t *frame_num, page_id_t *dirty_page_id, frame_id_t *busy_frame) {
+  *dirty_page_id = INVALID_PAGE_ID;
+  *busy_frame = -1;
+  if (!free_list_.empty()) {
+    *frame_num = free_list_.back();
+    free_list_.pop_back();
+    return true;
+  }
+  // skip victims the flusher is still writing, reusing their frame now would corrupt that write
+  std::vector<frame_id_t> busy_frames;
+  bool found = false;
+  while (replacer_->Victim(frame_num)) {
+    if (!pages_[*frame_num].io_in_progress_) {
+      found = true;
+      break;
+    }
+    busy_frames.push_back(*frame_num);
+  }
+  for (frame_id_t busy : busy_frames) {
+    replacer_->Unpin(busy);
+  }
+  if (!found) {
+    if (!busy_frames.empty()) {
+      *busy_frame = busy_frames.front();
+      return false;
+    }
+    // frames a read-ahead is still reading are out of the replacer, but become victims once it is done
+    for (size_t i = 0; i < pool_size_; i++) {
+      if (pages_[i].io_in_progress_ && pages_[i].GetPinCount() == 0) {
+        *busy_frame = static_cast<frame_id_t>(i);
+        break;
+      }
+    }
+    return false;
+  }
+  Page *ptr = pages_ + *frame_num;
+  assert(ptr->GetPinCount() == 0);
+  page_table_.erase(ptr->GetPageId());
+  num_evictions_++;
+  if (ptr->IsDirty()) {
+    *dirty_page_id = ptr->GetPageId();
+    num_dirty_evictions_++;
+    flusher_cv_.notify_one();
+  }
+  return true;
+}
+
 bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   // 0.   Make sure you call DiskManager::DeallocatePage!
   // 1.   Search the page table for the requested page (P).
   // 1.   If P does not exist, return true.
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-  latch_.lock();
+  std::unique_lock<std::mutex> lock(latch_);
+  // an eviction still writing P back would overwrite the page once its id is reused
+  auto evict_itor = evicting_.find(page_id);
+  while (evict_itor != evicting_.end()) {
+    io_cv_[evict_itor->second].wait(lock);
+    evict_itor = evicting_.find(page_id);
+  }
   auto itor = page_table_.find(page_id);
+  // the flusher may be writing P out, its frame cannot be reused until that write is done
+  while (itor != page_table_.end() && pages_[itor->second].io_in_progress_) {
+    io_cv_[itor->second].wait(lock);
+    itor = page_table_.find(page_id);
+  }
   if (itor == page_table_.end()) {
-    latch_.unlock();
-
+    // P is only on disk, its id can be reused all the same
+    disk_manager_->DeallocatePage(page_id);
     return true;
   }
   frame_id_t frame_num = itor->second;
   Page *ptr = pages_ + frame_num;
   if (ptr->GetPinCount() > 0) {
-    latch_.unlock();
-
     return false;
   }
   assert(ptr->GetPinCount() == 0);
@@ -208,8 +404,6 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   }
   ptr->ResetMemory();
 
-  latch_.unlock();
-
   return true;
 }
 
@@ -223,6 +417,10 @@ void BufferPoolManager::FlushAllPagesImpl() {
     page_num = itor.first;
     frame_num = itor.second;
     ptr = pages_ + frame_num;
+    // a frame still being read in holds nothing that is not already on disk
+    if (ptr->io_in_progress_) {
+      continue;
+    }
     // if (ptr->IsDirty()) {
     disk_manager_->WritePage(page_num, ptr->GetData());
     ptr->is_dirty_ = false;
@@ -231,4 +429,258 @@ void BufferPoolManager::FlushAllPagesImpl() {
   latch_.unlock();
 }
 
+void BufferPoolManager::RunFlusherThread(double target_clean_ratio, std::chrono::milliseconds interval) {
+  std::scoped_lock lock(flusher_latch_);
+  if (flusher_thread_ != nullptr) {
+    return;
+  }
+  flusher_running_ = true;
+  flusher_thread_ = new std::thread([this, target_clean_ratio, interval] {
+    std::unique_lock<std::mutex> flusher_lock(flusher_latch_);
+    while (flusher_running_) {
+      // woken early when a foreground eviction had to write a dirty page
+      flusher_cv_.wait_for(flusher_lock, interval);
+      if (!flusher_running_) {
+        break;
+      }
+      flusher_lock.unlock();
+      WriteBackDirtyPages(target_clean_ratio);
+      flusher_lock.lock();
+    }
+  });
+}
+
+void BufferPoolManager::StopFlusherThread() {
+  std::thread *flusher_thread;
+  {
+    std::scoped_lock lock(flusher_latch_);
+    flusher_running_ = false;
+    flusher_thread = flusher_thread_;
+    flusher_thread_ = nullptr;
+  }
+  if (flusher_thread != nullptr) {
+    flusher_cv_.notify_all();
+    flusher_thread->join();
+    delete flusher_thread;
+  }
+}
+
+size_t BufferPoolManager::WriteBackDirtyPages(double target_clean_ratio) {
+  std::vector<std::pair<page_id_t, frame_id_t>> batch;
+  {
+    std::scoped_lock lock(latch_);
+    size_t num_dirty = 0;
+    for (size_t i = 0; i < pool_size_; i++) {
+      Page *ptr = pages_ + i;
+      if (!ptr->is_dirty_) {
+        continue;
+      }
+      num_dirty++;
+      // pinned pages may be modified at any moment and frames under I/O are someone else's business
+      if (ptr->pin_count_ == 0 && !ptr->io_in_progress_) {
+        batch.emplace_back(ptr->page_id_, static_cast<frame_id_t>(i));
+      }
+    }
+    auto target_clean = static_cast<size_t>(target_clean_ratio * pool_size_);
+    size_t num_clean = pool_size_ - num_dirty;
+    if (num_clean >= target_clean) {
+      return 0;
+    }
+    // write in page id order so the batch turns into sequential I/O
+    std::sort(batch.begin(), batch.end());
+    if (batch.size() > target_clean - num_clean) {
+      batch.resize(target_clean - num_clean);
+    }
+    // the frames stay evictable; an eviction that picks one waits for its write instead of writing it again
+    for (const auto &[page_id, frame_num] : batch) {
+      pages_[frame_num].is_dirty_ = false;
+      pages_[frame_num].io_in_progress_ = true;
+    }
+  }
+
+  // all writes of the batch are in flight at once
+  std::vector<std::future<void>> writes;
+  writes.reserve(batch.size());
+  for (const auto &[page_id, frame_num] : batch) {
+    writes.push_back(disk_manager_->WritePageAsync(page_id, pages_[frame_num].GetData(), false));
+  }
+  disk_manager_->SubmitAsync();
+  std::vector<bool> written(batch.size());
+  for (size_t i = 0; i < batch.size(); i++) {
+    written[i] = CompletedIO(&writes[i]);
+  }
+
+  {
+    std::scoped_lock lock(latch_);
+    for (size_t i = 0; i < batch.size(); i++) {
+      Page *ptr = pages_ + batch[i].second;
+      ptr->io_in_progress_ = false;
+      // the page is still only in memory, an eviction has to write it
+      ptr->is_dirty_ |= !written[i];
+    }
+    num_background_writes_ += batch.size();
+  }
+  for (const auto &[page_id, frame_num] : batch) {
+    io_cv_[frame_num].notify_all();
+  }
+  return batch.size();
+}
+
+void BufferPoolManager::Prefetch(page_id_t first_page_id, size_t num_pages, const void *owner) {
+  std::scoped_lock lock(prefetch_latch_);
+  if (prefetch_thread_ == nullptr) {
+    prefetch_running_ = true;
+    prefetch_thread_ = new std::thread([this] {
+      std::unique_lock<std::mutex> prefetch_lock(prefetch_latch_);
+      while (true) {
+        prefetch_cv_.wait(prefetch_lock, [this] { return !prefetch_running_ || !prefetch_queue_.empty(); });
+        if (!prefetch_running_) {
+          break;
+        }
+        // everything queued so far is read as one batch of asynchronous I/O
+        std::vector<page_id_t> page_ids;
+        for (const auto &[page_id, page_owner] : prefetch_queue_) {
+          page_ids.push_back(page_id);
+          prefetch_busy_owners_.push_back(page_owner);
+        }
+        prefetch_queue_.clear();
+        prefetch_busy_ = true;
+        prefetch_lock.unlock();
+        PrefetchPages(page_ids);
+        prefetch_lock.lock();
+        prefetch_busy_ = false;
+        prefetch_busy_owners_.clear();
+        prefetch_idle_cv_.notify_all();
+      }
+    });
+  }
+  // a request that would not fit in the pool anyway is cut short
+  for (size_t i = 0; i < num_pages && prefetch_queue_.size() < pool_size_; i++) {
+    prefetch_queue_.emplace_back(first_page_id + static_cast<page_id_t>(i), owner);
+  }
+  prefetch_cv_.notify_one();
+}
+
+void BufferPoolManager::WaitForPrefetches() {
+  std::unique_lock<std::mutex> lock(prefetch_latch_);
+  prefetch_idle_cv_.wait(lock, [this] { return prefetch_queue_.empty() && !prefetch_busy_; });
+}
+
+void BufferPoolManager::CancelPrefetches(const void *owner) {
+  std::unique_lock<std::mutex> lock(prefetch_latch_);
+  prefetch_queue_.erase(std::remove_if(prefetch_queue_.begin(), prefetch_queue_.end(),
+                                       [owner](const auto &request) { return request.second == owner; }),
+                        prefetch_queue_.end());
+  prefetch_idle_cv_.wait(lock, [this, owner] {
+    return std::find(prefetch_busy_owners_.begin(), prefetch_busy_owners_.end(), owner) ==
+           prefetch_busy_owners_.end();
+  });
+}
+
+void BufferPoolManager::StopPrefetchThread() {
+  std::thread *prefetch_thread;
+  {
+    std::scoped_lock lock(prefetch_latch_);
+    prefetch_running_ = false;
+    prefetch_queue_.clear();
+    prefetch_thread = prefetch_thread_;
+    prefetch_thread_ = nullptr;
+  }
+  if (prefetch_thread != nullptr) {
+    prefetch_cv_.notify_all();
+    prefetch_thread->join();
+    delete prefetch_thread;
+  }
+}
+
+void BufferPoolManager::PrefetchPages(const std::vector<page_id_t> &page_ids) {
+  // the frames reserved for the batch, with the dirty page each of them evicted
+  std::vector<std::pair<frame_id_t, page_id_t>> loads;
+  std::unique_lock<std::mutex> lock(latch_);
+  for (page_id_t page_id : page_ids) {
+    // ids that were never allocated have nothing on disk, and NewPage will create them
+    if (page_id < 0 || page_id >= disk_manager_->GetNextPageId() || page_table_.count(page_id) > 0 ||
+        evicting_.count(page_id) > 0) {
+      continue;
+    }
+    // read-ahead is a hint, it never waits for a frame
+    frame_id_t frame_num = -1;
+    page_id_t dirty_pageId = INVALID_PAGE_ID;
+    frame_id_t busy_frame = -1;
+    if (!AcquireFrame(&frame_num, &dirty_pageId, &busy_frame)) {
+      break;
+    }
+    Page *ptr = pages_ + frame_num;
+    if (dirty_pageId != INVALID_PAGE_ID) {
+      evicting_[dirty_pageId] = frame_num;
+    }
+    // the frame is kept out of the replacer until the read is done, but it is not pinned
+    page_table_[page_id] = frame_num;
+    ptr->page_id_ = page_id;
+    ptr->pin_count_ = 0;
+    ptr->is_dirty_ = false;
+    ptr->io_in_progress_ = true;
+    loads.emplace_back(frame_num, dirty_pageId);
+  }
+  lock.unlock();
+  if (loads.empty()) {
+    return;
+  }
+
+  // io operation: write back the evicted pages, then read the new ones, each step with all of its I/O in flight
+  std::vector<std::future<void>> ios;
+  for (const auto &[frame_num, dirty_page_id] : loads) {
+    if (dirty_page_id != INVALID_PAGE_ID) {
+      ios.push_back(disk_manager_->WritePageAsync(dirty_page_id, pages_[frame_num].GetData(), false));
+    }
+  }
+  disk_manager_->SubmitAsync();
+  size_t io = 0;
+  for (const auto &[frame_num, dirty_page_id] : loads) {
+    // a write-back that failed gets a second, synchronous try before the frame is overwritten, as on a miss
+    if (dirty_page_id != INVALID_PAGE_ID && !CompletedIO(&ios[io++])) {
+      disk_manager_->WritePage(dirty_page_id, pages_[frame_num].GetData());
+    }
+  }
+  ios.clear();
+  for (const auto &[frame_num, dirty_page_id] : loads) {
+    Page *ptr = pages_ + frame_num;
+    ptr->ResetMemory();
+    ios.push_back(disk_manager_->ReadPageAsync(ptr->page_id_, ptr->GetData(), false));
+  }
+  disk_manager_->SubmitAsync();
+  std::vector<bool> read(loads.size());
+  for (size_t i = 0; i < loads.size(); i++) {
+    read[i] = CompletedIO(&ios[i]);
+  }
+
+  lock.lock();
+  for (size_t i = 0; i < loads.size(); i++) {
+    auto [frame_num, dirty_page_id] = loads[i];
+    Page *ptr = pages_ + frame_num;
+    ptr->io_in_progress_ = false;
+    if (dirty_page_id != INVALID_PAGE_ID) {
+      evicting_.erase(dirty_page_id);
+    }
+    if (read[i]) {
+      if (ptr->pin_count_ == 0) {
+        replacer_->Unpin(frame_num);
+      }
+      continue;
+    }
+    // a later fetch reads the page again; the fetches pinning the frame while waiting for it fail, and the last of
+    // them frees the frame
+    page_table_.erase(ptr->page_id_);
+    ptr->page_id_ = INVALID_PAGE_ID;
+    if (ptr->pin_count_ == 0) {
+      free_list_.push_back(frame_num);
+    }
+  }
+  num_prefetches_ += loads.size();
+  lock.unlock();
+  for (const auto &[frame_num, dirty_page_id] : loads) {
+    io_cv_[frame_num].notify_all();
+  }
+}
+
 }  // namespace bustub
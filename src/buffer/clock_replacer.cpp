@@ -14,16 +14,48 @@
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : num_pages_(num_pages), states_(num_pages) {
+  for (auto &state : states_) {
+    state.store(NOT_IN_REPLACER, std::memory_order_relaxed);
+  }
+}
 
 ClockReplacer::~ClockReplacer() = default;
 
-bool ClockReplacer::Victim(frame_id_t *frame_id) { return false; }
-
-void ClockReplacer::Pin(frame_id_t frame_id) {}
-
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
-
-size_t ClockReplacer::Size() { return 0; }
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  // Each step claims its own slot of the hand, so concurrent sweepers never inspect the same frame at once.
+  while (size_.load() > 0) {
+    auto frame = static_cast<frame_id_t>(hand_.fetch_add(1) % num_pages_);
+    uint8_t state = states_[frame].load();
+    if (state == REFERENCED) {
+      states_[frame].compare_exchange_strong(state, UNREFERENCED);
+    } else if (state == UNREFERENCED && states_[frame].compare_exchange_strong(state, NOT_IN_REPLACER)) {
+      size_.fetch_sub(1);
+      *frame_id = frame;
+      return true;
+    }
+  }
+  *frame_id = -1;
+  return false;
+}
+
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  // a frame that was not in the replacer leaves the count alone
+  if (states_[frame_id].exchange(NOT_IN_REPLACER) != NOT_IN_REPLACER) {
+    size_.fetch_sub(1);
+  }
+}
+
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  // the count goes up before the frame shows up in the replacer, so a Pin() or Victim() that takes the frame right
+  // away never brings it below zero; unpinning a frame that is already in the replacer gives the count back
+  size_.fetch_add(1);
+  uint8_t expected = NOT_IN_REPLACER;
+  if (!states_[frame_id].compare_exchange_strong(expected, REFERENCED)) {
+    size_.fetch_sub(1);
+  }
+}
+
+size_t ClockReplacer::Size() { return size_.load(); }
 
 }  // namespace bustub
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+#include <iterator>
+#include <utility>
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k, size_t history_cap)
+    : k_(k),
+      history_cap_(history_cap),
+      frame_pages_(num_pages, INVALID_PAGE_ID),
+      frame_accesses_(num_pages),
+      evictable_(num_pages, false) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> lg(latch_);
+  // an infinite distance beats any finite one; otherwise the older K-th access has the larger distance
+  auto &frames = infinite_frames_.empty() ? finite_frames_ : infinite_frames_;
+  if (frames.empty()) {
+    *frame_id = -1;
+    return false;
+  }
+  frame_id_t victim = frames.begin()->second;
+  frames.erase(frames.begin());
+  RetainHistory(victim);
+  evictable_[victim] = false;
+  evictable_count_--;
+  *frame_id = victim;
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(latch_);
+  if (evictable_[frame_id]) {
+    OrderedFrames(frame_id)->erase(Order(frame_id));
+    evictable_[frame_id] = false;
+    evictable_count_--;
+  }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(latch_);
+  if (!evictable_[frame_id]) {
+    OrderedFrames(frame_id)->insert(Order(frame_id));
+    evictable_[frame_id] = true;
+    evictable_count_++;
+  }
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::lock_guard<std::mutex> lg(latch_);
+  auto &accesses = frame_accesses_[frame_id];
+  // the access moves the frame within the evictable frames
+  if (evictable_[frame_id]) {
+    OrderedFrames(frame_id)->erase(Order(frame_id));
+  }
+  if (frame_pages_[frame_id] != page_id) {
+    // the frame now holds another page, pick up that page's history if it was evicted recently
+    if (frame_pages_[frame_id] != INVALID_PAGE_ID) {
+      RetainHistory(frame_id);
+    }
+    frame_pages_[frame_id] = page_id;
+    auto itor = retained_.find(page_id);
+    if (itor != retained_.end()) {
+      accesses = std::move(itor->second.accesses_);
+      retained_order_.erase(itor->second.pos_);
+      retained_.erase(itor);
+    }
+  }
+  accesses.push_back(++current_timestamp_);
+  if (accesses.size() > k_) {
+    accesses.pop_front();
+  }
+  if (evictable_[frame_id]) {
+    OrderedFrames(frame_id)->insert(Order(frame_id));
+  }
+}
+
+size_t LRUKReplacer::Size() {
+  std::lock_guard<std::mutex> lg(latch_);
+  return evictable_count_;
+}
+
+std::set<LRUKReplacer::FrameOrder> *LRUKReplacer::OrderedFrames(frame_id_t frame_id) {
+  return frame_accesses_[frame_id].size() < k_ ? &infinite_frames_ : &finite_frames_;
+}
+
+LRUKReplacer::FrameOrder LRUKReplacer::Order(frame_id_t frame_id) const {
+  // the oldest remembered access is the K-th most recent one once the history is full
+  const auto &accesses = frame_accesses_[frame_id];
+  return {accesses.empty() ? 0 : accesses.front(), frame_id};
+}
+
+void LRUKReplacer::RetainHistory(frame_id_t frame_id) {
+  page_id_t page_id = frame_pages_[frame_id];
+  auto &accesses = frame_accesses_[frame_id];
+  if (page_id != INVALID_PAGE_ID && history_cap_ > 0) {
+    auto itor = retained_.find(page_id);
+    if (itor != retained_.end()) {
+      retained_order_.erase(itor->second.pos_);
+      retained_.erase(itor);
+    }
+    if (retained_.size() == history_cap_) {
+      retained_.erase(retained_order_.front());
+      retained_order_.pop_front();
+    }
+    retained_order_.push_back(page_id);
+    retained_[page_id] = RetainedHistory{std::move(accesses), std::prev(retained_order_.end())};
+  }
+  accesses.clear();
+  frame_pages_[frame_id] = INVALID_PAGE_ID;
+}
+
+}  // namespace bustub
@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     LogManager *log_manager, ReplacerType replacer_type,
+                                                     bool use_huge_pages)
+    : BufferPoolManager(disk_manager, log_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "ParallelBufferPoolManager needs at least one instance.");
+  pool_size_ = num_instances * pool_size;
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManager>(pool_size, disk_manager, log_manager, replacer_type,
+                                                                     use_huge_pages));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() = default;
+
+BufferPoolManager *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+Page *ParallelBufferPoolManager::FetchPageImpl(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  return GetBufferPoolManager(page_id)->FetchPageImpl(page_id);
+}
+
+bool ParallelBufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  if (page_id == INVALID_PAGE_ID) {
+    return true;
+  }
+  return GetBufferPoolManager(page_id)->UnpinPageImpl(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPageImpl(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->FlushPageImpl(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPageImpl(page_id_t *page_id, page_id_t hint) {
+  // The id closest to the hint may map to an instance that is full. Then only an instance with a free frame is asked
+  // for an id of its own, so at most that first id has to be given back.
+  page_id_t newid = disk_manager_->AllocatePage(hint);
+  Page *ptr = GetBufferPoolManager(newid)->NewPageWithId(newid);
+  if (ptr != nullptr) {
+    *page_id = newid;
+    return ptr;
+  }
+  *page_id = INVALID_PAGE_ID;
+  size_t num_instances = instances_.size();
+  size_t full_instance = static_cast<size_t>(newid) % num_instances;
+  for (size_t i = 1; i < num_instances && ptr == nullptr; i++) {
+    size_t instance = (full_instance + i) % num_instances;
+    if (!instances_[instance]->HasFreeFrame()) {
+      continue;
+    }
+    page_id_t shard_id = disk_manager_->AllocatePage(hint, num_instances, instance);
+    ptr = instances_[instance]->NewPageWithId(shard_id);
+    if (ptr == nullptr) {
+      // the frame was taken in the meantime
+      disk_manager_->DeallocatePage(shard_id);
+    } else {
+      *page_id = shard_id;
+    }
+  }
+  disk_manager_->DeallocatePage(newid);
+  return ptr;
+}
+
+bool ParallelBufferPoolManager::DeletePageImpl(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return true;
+  }
+  return GetBufferPoolManager(page_id)->DeletePageImpl(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPagesImpl() {
+  for (auto &instance : instances_) {
+    instance->FlushAllPagesImpl();
+  }
+}
+
+void ParallelBufferPoolManager::RunFlusherThread(double target_clean_ratio, std::chrono::milliseconds interval) {
+  for (auto &instance : instances_) {
+    instance->RunFlusherThread(target_clean_ratio, interval);
+  }
+}
+
+void ParallelBufferPoolManager::StopFlusherThread() {
+  for (auto &instance : instances_) {
+    instance->StopFlusherThread();
+  }
+}
+
+size_t ParallelBufferPoolManager::WriteBackDirtyPages(double target_clean_ratio) {
+  size_t num_written = 0;
+  for (auto &instance : instances_) {
+    num_written += instance->WriteBackDirtyPages(target_clean_ratio);
+  }
+  return num_written;
+}
+
+size_t ParallelBufferPoolManager::GetNumEvictions() {
+  size_t total = 0;
+  for (auto &instance : instances_) {
+    total += instance->GetNumEvictions();
+  }
+  return total;
+}
+
+size_t ParallelBufferPoolManager::GetNumDirtyEvictions() {
+  size_t total = 0;
+  for (auto &instance : instances_) {
+    total += instance->GetNumDirtyEvictions();
+  }
+  return total;
+}
+
+size_t ParallelBufferPoolManager::GetNumBackgroundWrites() {
+  size_t total = 0;
+  for (auto &instance : instances_) {
+    total += instance->GetNumBackgroundWrites();
+  }
+  return total;
+}
+
+void ParallelBufferPoolManager::Prefetch(page_id_t first_page_id, size_t num_pages, const void *owner) {
+  for (size_t i = 0; i < num_pages; i++) {
+    page_id_t page_id = first_page_id + static_cast<page_id_t>(i);
+    GetBufferPoolManager(page_id)->Prefetch(page_id, 1, owner);
+  }
+}
+
+size_t ParallelBufferPoolManager::GetNumPrefetches() {
+  size_t total = 0;
+  for (auto &instance : instances_) {
+    total += instance->GetNumPrefetches();
+  }
+  return total;
+}
+
+void ParallelBufferPoolManager::WaitForPrefetches() {
+  for (auto &instance : instances_) {
+    instance->WaitForPrefetches();
+  }
+}
+
+void ParallelBufferPoolManager::CancelPrefetches(const void *owner) {
+  for (auto &instance : instances_) {
+    instance->CancelPrefetches(owner);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.cpp
+//
+// Identification: src/buffer/read_ahead.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/read_ahead.h"
+
+#include <algorithm>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+ReadAhead::ReadAhead(BufferPoolManager *buffer_pool_manager)
+    : buffer_pool_manager_(buffer_pool_manager),
+      max_window_(buffer_pool_manager == nullptr
+                      ? 0
+                      : std::min<size_t>(READ_AHEAD_MAX_PAGES, buffer_pool_manager->GetPoolSize() / 4)) {}
+
+ReadAhead::~ReadAhead() {
+  if (requested_) {
+    buffer_pool_manager_->CancelPrefetches(this);
+  }
+}
+
+void ReadAhead::Reset(BufferPoolManager *buffer_pool_manager) {
+  if (requested_) {
+    buffer_pool_manager_->CancelPrefetches(this);
+  }
+  buffer_pool_manager_ = buffer_pool_manager;
+  max_window_ = buffer_pool_manager == nullptr
+                    ? 0
+                    : std::min<size_t>(READ_AHEAD_MAX_PAGES, buffer_pool_manager->GetPoolSize() / 4);
+  window_ = 1;
+  last_page_id_ = INVALID_PAGE_ID;
+  requested_ = false;
+  prefetched_end_ = INVALID_PAGE_ID;
+}
+
+void ReadAhead::OnPage(page_id_t page_id, page_id_t next_page_id) {
+  bool sequential = last_page_id_ != INVALID_PAGE_ID && page_id == last_page_id_ + 1 && next_page_id == page_id + 1;
+  last_page_id_ = page_id;
+  if (max_window_ == 0 || next_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  if (sequential) {
+    window_ = std::min(window_ * 2, max_window_);
+  } else {
+    window_ = 1;
+    prefetched_end_ = next_page_id;
+  }
+  page_id_t begin = std::max(next_page_id, prefetched_end_);
+  page_id_t end = next_page_id + static_cast<page_id_t>(window_);
+  if (begin < end) {
+    buffer_pool_manager_->Prefetch(begin, end - begin, this);
+    prefetched_end_ = end;
+    requested_ = true;
+  }
+}
+
+}  // namespace bustub
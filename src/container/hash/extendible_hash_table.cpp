@@ -0,0 +1,369 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+
+namespace bustub {
+
+namespace {
+HashTableDirectoryPage *AsDirectory(Page *page) { return reinterpret_cast<HashTableDirectoryPage *>(page->GetData()); }
+}  // namespace
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  // new pages come zeroed: a global depth of 0, and a bucket with nothing in it
+  Page *page = buffer_pool_manager_->NewPage(&directory_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory.");
+  }
+  auto *directory = AsDirectory(page);
+  directory->SetPageId(directory_page_id_);
+  page_id_t bucket_page_id;
+  Page *bucket_page = buffer_pool_manager_->NewPage(&bucket_page_id);
+  if (bucket_page == nullptr) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory.");
+  }
+  reinterpret_cast<BucketPage *>(bucket_page->GetData())->SetNextPageId(INVALID_PAGE_ID);
+  directory->SetBucketPageId(0, bucket_page_id);
+  directory->SetLocalDepth(0, 0);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::Hash(const KeyType &key) {
+  return static_cast<uint32_t>(hash_fn_.GetHash(key));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+  }
+  return page;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) {
+  table_latch_.RLock();
+  auto *directory = AsDirectory(FetchPage(directory_page_id_));
+  page_id_t page_id = directory->GetBucketPageId(directory->IndexOf(Hash(key)));
+  bool found = false;
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = FetchPage(page_id);
+    page->RLatch();
+    auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+    found = bucket->GetValue(key, comparator_, result) || found;
+    page_id_t next_page_id = bucket->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  auto *directory = AsDirectory(FetchPage(directory_page_id_));
+  page_id_t bucket_page_id = directory->GetBucketPageId(directory->IndexOf(Hash(key)));
+  Page *page = FetchPage(bucket_page_id);
+  page->WLatch();
+  auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+  // the pair may be in an overflow page already, chains only change under the exclusive latch
+  bool full = bucket->IsFull() || bucket->GetNextPageId() != INVALID_PAGE_ID;
+  bool inserted = !full && bucket->Insert(key, value, comparator_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return full ? SplitInsert(key, value) : inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitInsert(const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  auto *directory = AsDirectory(FetchPage(directory_page_id_));
+  bool directory_dirty = false;
+  bool inserted = false;
+  uint32_t hash = Hash(key);
+  while (true) {
+    // a split may leave every pair on one side, the bucket of key as full as it was
+    uint32_t bucket_idx = directory->IndexOf(hash);
+    page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+    auto *bucket = reinterpret_cast<BucketPage *>(FetchPage(bucket_page_id)->GetData());
+    bool chained = bucket->GetNextPageId() != INVALID_PAGE_ID;
+    if (!bucket->IsFull() && !chained) {
+      inserted = bucket->Insert(key, value, comparator_);
+      buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+      break;
+    }
+    uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+    if (chained || local_depth == HashTableDirectoryPage::MAX_DEPTH) {
+      // past the largest directory, or once it overflowed, the bucket grows a page at a time
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      inserted = OverflowInsert(bucket_page_id, key, value);
+      break;
+    }
+    std::vector<ValueType> values;
+    bucket->GetValue(key, comparator_, &values);
+    if (std::find(values.begin(), values.end(), value) != values.end()) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+
+    if (local_depth == directory->GetGlobalDepth()) {
+      directory->IncrGlobalDepth();
+    }
+    page_id_t image_page_id;
+    Page *image_page = buffer_pool_manager_->NewPage(&image_page_id);
+    if (image_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+      table_latch_.WUnlock();
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory.");
+    }
+    auto *image = reinterpret_cast<BucketPage *>(image_page->GetData());
+    image->SetNextPageId(INVALID_PAGE_ID);
+
+    // of the slots sharing the bucket, those with bit local_depth set now point at its split image
+    uint32_t local_mask = (1U << local_depth) - 1;
+    uint32_t low_bits = bucket_idx & local_mask;
+    for (uint32_t i = 0; i < directory->Size(); i++) {
+      if ((i & local_mask) == low_bits) {
+        directory->SetLocalDepth(i, local_depth + 1);
+        if (((i >> local_depth) & 1) != 0) {
+          directory->SetBucketPageId(i, image_page_id);
+        }
+      }
+    }
+    for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && bucket->IsOccupied(i); i++) {
+      if (bucket->IsReadable(i) && ((Hash(bucket->KeyAt(i)) >> local_depth) & 1) != 0) {
+        image->Insert(bucket->KeyAt(i), bucket->ValueAt(i), comparator_);
+        bucket->RemoveAt(i);
+      }
+    }
+    directory_dirty = true;
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, directory_dirty);
+  table_latch_.WUnlock();
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::OverflowInsert(page_id_t bucket_page_id, const KeyType &key, const ValueType &value) {
+  page_id_t free_page_id = INVALID_PAGE_ID;
+  page_id_t last_page_id = INVALID_PAGE_ID;
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID;) {
+    auto *bucket = reinterpret_cast<BucketPage *>(FetchPage(page_id)->GetData());
+    std::vector<ValueType> values;
+    bucket->GetValue(key, comparator_, &values);
+    if (std::find(values.begin(), values.end(), value) != values.end()) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return false;
+    }
+    if (free_page_id == INVALID_PAGE_ID && !bucket->IsFull()) {
+      free_page_id = page_id;
+    }
+    last_page_id = page_id;
+    page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(last_page_id, false);
+  }
+
+  if (free_page_id != INVALID_PAGE_ID) {
+    auto *bucket = reinterpret_cast<BucketPage *>(FetchPage(free_page_id)->GetData());
+    bool inserted = bucket->Insert(key, value, comparator_);
+    buffer_pool_manager_->UnpinPage(free_page_id, inserted);
+    return inserted;
+  }
+  page_id_t overflow_page_id;
+  Page *overflow_page = buffer_pool_manager_->NewPage(&overflow_page_id);
+  if (overflow_page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory.");
+  }
+  auto *overflow = reinterpret_cast<BucketPage *>(overflow_page->GetData());
+  overflow->SetNextPageId(INVALID_PAGE_ID);
+  bool inserted = overflow->Insert(key, value, comparator_);
+  buffer_pool_manager_->UnpinPage(overflow_page_id, true);
+  reinterpret_cast<BucketPage *>(FetchPage(last_page_id)->GetData())->SetNextPageId(overflow_page_id);
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  return inserted;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  auto *directory = AsDirectory(FetchPage(directory_page_id_));
+  page_id_t page_id = directory->GetBucketPageId(directory->IndexOf(Hash(key)));
+  bool removed = false;
+  bool empty = false;
+  while (!removed && page_id != INVALID_PAGE_ID) {
+    Page *page = FetchPage(page_id);
+    page->WLatch();
+    auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+    removed = bucket->Remove(key, value, comparator_);
+    empty = removed && bucket->IsEmpty();
+    page_id_t next_page_id = bucket->GetNextPageId();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, removed);
+    page_id = next_page_id;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (empty) {
+    Merge(key);
+  }
+  return removed;
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::Merge(const KeyType &key) {
+  table_latch_.WLock();
+  auto *directory = AsDirectory(FetchPage(directory_page_id_));
+  bool directory_dirty = false;
+  uint32_t bucket_idx = directory->IndexOf(Hash(key));
+  DropEmptyOverflowPages(directory->GetBucketPageId(bucket_idx));
+  while (directory->GetLocalDepth(bucket_idx) > 0) {
+    uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+    uint32_t image_idx = bucket_idx ^ (1U << (local_depth - 1));
+    if (directory->GetLocalDepth(image_idx) != local_depth) {
+      // the image has split further, its halves have to merge first
+      break;
+    }
+    // inserts may have come in since the bucket emptied
+    page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = directory->GetBucketPageId(image_idx);
+    auto *bucket = reinterpret_cast<BucketPage *>(FetchPage(bucket_page_id)->GetData());
+    bool bucket_empty = bucket->IsEmpty() && bucket->GetNextPageId() == INVALID_PAGE_ID;
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    auto *image = reinterpret_cast<BucketPage *>(FetchPage(image_page_id)->GetData());
+    bool image_empty = image->IsEmpty() && image->GetNextPageId() == INVALID_PAGE_ID;
+    buffer_pool_manager_->UnpinPage(image_page_id, false);
+    if (!bucket_empty && !image_empty) {
+      break;
+    }
+
+    page_id_t keep_page_id = bucket_empty ? image_page_id : bucket_page_id;
+    page_id_t drop_page_id = bucket_empty ? bucket_page_id : image_page_id;
+    for (uint32_t i = 0; i < directory->Size(); i++) {
+      page_id_t page_id = directory->GetBucketPageId(i);
+      if (page_id == keep_page_id || page_id == drop_page_id) {
+        directory->SetBucketPageId(i, keep_page_id);
+        directory->SetLocalDepth(i, local_depth - 1);
+      }
+    }
+    buffer_pool_manager_->DeletePage(drop_page_id);
+    directory_dirty = true;
+  }
+  while (directory->CanShrink()) {
+    directory->DecrGlobalDepth();
+    directory_dirty = true;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, directory_dirty);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::DropEmptyOverflowPages(page_id_t bucket_page_id) {
+  Page *page = FetchPage(bucket_page_id);
+  auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+  bool dirty = false;
+  // the directory points at the first page, an empty one takes over the pairs of the next
+  while (bucket->IsEmpty() && bucket->GetNextPageId() != INVALID_PAGE_ID) {
+    page_id_t next_page_id = bucket->GetNextPageId();
+    memcpy(page->GetData(), FetchPage(next_page_id)->GetData(), PAGE_SIZE);
+    buffer_pool_manager_->UnpinPage(next_page_id, false);
+    buffer_pool_manager_->DeletePage(next_page_id);
+    dirty = true;
+  }
+  page_id_t prev_page_id = bucket_page_id;
+  auto *prev = bucket;
+  for (page_id_t page_id = bucket->GetNextPageId(); page_id != INVALID_PAGE_ID;) {
+    auto *overflow = reinterpret_cast<BucketPage *>(FetchPage(page_id)->GetData());
+    page_id_t next_page_id = overflow->GetNextPageId();
+    if (overflow->IsEmpty()) {
+      prev->SetNextPageId(next_page_id);
+      dirty = true;
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+    } else {
+      buffer_pool_manager_->UnpinPage(prev_page_id, dirty);
+      prev_page_id = page_id;
+      prev = overflow;
+      dirty = false;
+    }
+    page_id = next_page_id;
+  }
+  buffer_pool_manager_->UnpinPage(prev_page_id, dirty);
+}
+
+/*****************************************************************************
+ * GETGLOBALDEPTH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::GetGlobalDepth() {
+  table_latch_.RLock();
+  uint32_t global_depth = AsDirectory(FetchPage(directory_page_id_))->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return global_depth;
+}
+
+/*****************************************************************************
+ * VERIFY INTEGRITY
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::VerifyIntegrity() {
+  table_latch_.RLock();
+  AsDirectory(FetchPage(directory_page_id_))->VerifyIntegrity();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+}
+
+template class ExtendibleHashTable<int, int, IntComparator>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
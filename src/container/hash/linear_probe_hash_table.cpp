@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -22,25 +23,188 @@
 
 namespace bustub {
 
+namespace {
+HashTableHeaderPage *AsHeader(Page *page) { return reinterpret_cast<HashTableHeaderPage *>(page->GetData()); }
+}  // namespace
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  header_page_id_ = NewTable(num_buckets);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *HASH_TABLE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_TYPE::NewTable(size_t num_buckets) {
+  size_t num_blocks = std::clamp<size_t>((num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE, 1,
+                                         HashTableHeaderPage::MaxNumBlocks());
+  page_id_t header_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory.");
+  }
+  auto *header = AsHeader(page);
+  header->SetPageId(header_page_id);
+  header->SetSize(num_blocks * BLOCK_ARRAY_SIZE);
+  for (size_t i = 0; i < num_blocks; i++) {
+    // new pages come zeroed, every bucket of a block starts out never occupied
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      // give back the pages of the half made table
+      for (size_t j = 0; j < i; j++) {
+        buffer_pool_manager_->DeletePage(header->GetBlockPageId(j));
+      }
+      buffer_pool_manager_->UnpinPage(header_page_id, false);
+      buffer_pool_manager_->DeletePage(header_page_id);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory.");
+    }
+    header->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+bool HASH_TABLE_TYPE::Probe(HashTableHeaderPage *header, const KeyType &key, bool exclusive, Visitor &&visit) {
+  size_t size = header->GetSize();
+  size_t bucket = hash_fn_.GetHash(key) % size;
+  for (size_t probed = 0; probed < size;) {
+    page_id_t block_page_id = header->GetBlockPageId(bucket / BLOCK_ARRAY_SIZE);
+    Page *page = FetchPage(block_page_id);
+    exclusive ? page->WLatch() : page->RLatch();
+    auto *block = reinterpret_cast<BlockPage *>(page->GetData());
+    bool stop = false;
+    bool found = false;
+    do {
+      auto slot = static_cast<slot_offset_t>(bucket % BLOCK_ARRAY_SIZE);
+      bool occupied = block->IsOccupied(slot);
+      found = visit(block, slot, bucket);
+      stop = found || !occupied;
+      bucket = (bucket + 1) % size;
+      probed++;
+    } while (!stop && probed < size && bucket % BLOCK_ARRAY_SIZE != 0);
+    exclusive ? page->WUnlatch() : page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, exclusive);
+    if (stop) {
+      return found;
+    }
+  }
+  return false;
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+  header_latch_.RLock();
+  page_id_t header_page_id = header_page_id_;
+  Page *page = FetchPage(header_page_id);
+  size_t found = result->size();
+  Probe(AsHeader(page), key, false, [&](BlockPage *block, slot_offset_t slot, size_t bucket) {
+    if (block->IsReadable(slot) && comparator_(block->KeyAt(slot), key) == 0) {
+      result->push_back(block->ValueAt(slot));
+    }
+    return false;
+  });
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  header_latch_.RUnlock();
+  return result->size() > found;
 }
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  const size_t max_size = HashTableHeaderPage::MaxNumBlocks() * BLOCK_ARRAY_SIZE;
+  while (true) {
+    table_latch_.RLock();
+    size_t size;
+    InsertResult result = TryInsert(key, value, &size);
+    table_latch_.RUnlock();
+
+    switch (result) {
+      case InsertResult::INSERTED:
+        if (num_occupied_ * 4 > size * 3 && size < max_size) {
+          Resize(size);
+        }
+        return true;
+      case InsertResult::DUPLICATE:
+        return false;
+      case InsertResult::FULL:
+        if (size >= max_size) {
+          return false;
+        }
+        Resize(size);
+        break;
+      case InsertResult::RETRY:
+        break;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+typename HASH_TABLE_TYPE::InsertResult HASH_TABLE_TYPE::TryInsert(const KeyType &key, const ValueType &value,
+                                                                    size_t *size) {
+  Page *page = FetchPage(header_page_id_);
+  auto *header = AsHeader(page);
+  *size = header->GetSize();
+  // the first tombstone on the way, taken unless the pair turns up further on
+  size_t tombstone = *size;
+  bool duplicate = false;
+  bool inserted = false;
+  Probe(header, key, true, [&](BlockPage *block, slot_offset_t slot, size_t bucket) {
+    if (!block->IsOccupied(slot)) {
+      if (tombstone == *size) {
+        inserted = block->Insert(slot, key, value);
+        num_occupied_++;
+      } else if (tombstone / BLOCK_ARRAY_SIZE == bucket / BLOCK_ARRAY_SIZE) {
+        inserted = block->Insert(tombstone % BLOCK_ARRAY_SIZE, key, value);
+      }
+      return true;
+    }
+    if (!block->IsReadable(slot)) {
+      tombstone = std::min(tombstone, bucket);
+    } else if (comparator_(block->KeyAt(slot), key) == 0 && block->ValueAt(slot) == value) {
+      duplicate = true;
+      return true;
+    }
+    return false;
+  });
+
+  InsertResult result = InsertResult::INSERTED;
+  if (duplicate) {
+    result = InsertResult::DUPLICATE;
+  } else if (!inserted) {
+    if (tombstone == *size) {
+      result = InsertResult::FULL;
+    } else {
+      // the tombstone is in a block left behind, whose latch the probe let go of
+      page_id_t block_page_id = header->GetBlockPageId(tombstone / BLOCK_ARRAY_SIZE);
+      Page *block_page = FetchPage(block_page_id);
+      block_page->WLatch();
+      auto *block = reinterpret_cast<BlockPage *>(block_page->GetData());
+      if (!block->Insert(tombstone % BLOCK_ARRAY_SIZE, key, value)) {
+        result = InsertResult::RETRY;
+      }
+      block_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(block_page_id, true);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  return result;
 }
 
 /*****************************************************************************
@@ -48,21 +212,94 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  table_latch_.RLock();
+  Page *page = FetchPage(header_page_id_);
+  bool removed = Probe(AsHeader(page), key, true, [&](BlockPage *block, slot_offset_t slot, size_t bucket) {
+    if (block->IsReadable(slot) && comparator_(block->KeyAt(slot), key) == 0 && block->ValueAt(slot) == value) {
+      block->Remove(slot);
+      return true;
+    }
+    return false;
+  });
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  page_id_t old_header_page_id = header_page_id_;
+  Page *old_page = FetchPage(old_header_page_id);
+  auto *old_header = AsHeader(old_page);
+  if (old_header->GetSize() >= 2 * initial_size ||
+      old_header->NumBlocks() == HashTableHeaderPage::MaxNumBlocks()) {
+    // another insert got here first
+    buffer_pool_manager_->UnpinPage(old_header_page_id, false);
+    table_latch_.WUnlock();
+    return;
+  }
+
+  // lookups go on reading the old blocks: there are no writers to latch them against
+  page_id_t new_header_page_id;
+  try {
+    new_header_page_id = NewTable(2 * initial_size);
+  } catch (const Exception &e) {
+    // the table stays as it is, for the operations after this one
+    buffer_pool_manager_->UnpinPage(old_header_page_id, false);
+    table_latch_.WUnlock();
+    throw;
+  }
+  Page *new_page = FetchPage(new_header_page_id);
+  auto *new_header = AsHeader(new_page);
+  size_t num_pairs = 0;
+  for (size_t i = 0; i < old_header->NumBlocks(); i++) {
+    page_id_t block_page_id = old_header->GetBlockPageId(i);
+    auto *block = reinterpret_cast<BlockPage *>(FetchPage(block_page_id)->GetData());
+    for (slot_offset_t slot = 0; slot < BLOCK_ARRAY_SIZE; slot++) {
+      if (!block->IsReadable(slot)) {
+        continue;
+      }
+      KeyType key = block->KeyAt(slot);
+      ValueType value = block->ValueAt(slot);
+      Probe(new_header, key, true, [&](BlockPage *new_block, slot_offset_t new_slot, size_t bucket) {
+        return new_block->Insert(new_slot, key, value);
+      });
+      num_pairs++;
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(new_header_page_id, false);
+  num_occupied_ = num_pairs;
+
+  // wait for the lookups still in the old blocks, send the ones to come to the new ones
+  header_latch_.WLock();
+  header_page_id_ = new_header_page_id;
+  header_latch_.WUnlock();
+
+  for (size_t i = 0; i < old_header->NumBlocks(); i++) {
+    buffer_pool_manager_->DeletePage(old_header->GetBlockPageId(i));
+  }
+  buffer_pool_manager_->UnpinPage(old_header_page_id, false);
+  buffer_pool_manager_->DeletePage(old_header_page_id);
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 size_t HASH_TABLE_TYPE::GetSize() {
-  return 0;
+  header_latch_.RLock();
+  page_id_t header_page_id = header_page_id_;
+  Page *page = FetchPage(header_page_id);
+  size_t size = AsHeader(page)->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  header_latch_.RUnlock();
+  return size;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -29,11 +29,19 @@ AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const Aggreg
 const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
 
 void AggregationExecutor::Init() {
-  Tuple tuple;
-  RID rid;
+  // the child hands over batches, whether it produces them itself or from its tuples
+  TupleBatch batch;
+  std::vector<std::vector<Value>> group_bys(plan_->GetGroupBys().size());
+  std::vector<std::vector<Value>> aggregates(plan_->GetAggregates().size());
   try {
-    while (child_->Next(&tuple, &rid)) {
-      aht_.InsertCombine(MakeKey(&tuple), MakeVal(&tuple));
+    while (child_->NextBatch(&batch)) {
+      for (size_t i = 0; i < group_bys.size(); i++) {
+        plan_->GetGroupBys()[i]->EvaluateBatch(batch, &group_bys[i]);
+      }
+      for (size_t i = 0; i < aggregates.size(); i++) {
+        plan_->GetAggregates()[i]->EvaluateBatch(batch, &aggregates[i]);
+      }
+      aht_.InsertCombineBatch(group_bys, aggregates, batch.NumRows());
     }
   } catch (Exception &e) {
     throw Exception(ExceptionType::CHILD_EXE_FAIL, "InsertExecutor:child execute error.");
@@ -62,4 +70,23 @@ bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
   return Next(tuple, rid);
 }
 
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *output_schema = plan_->OutputSchema();
+  batch->Reset(output_schema);
+  for (; !batch->IsFull() && aht_iterator_ != aht_.End(); ++aht_iterator_) {
+    const AggregateKey &agg_key = aht_iterator_.Key();
+    const AggregateValue &agg_val = aht_iterator_.Val();
+    if (plan_->GetHaving() != nullptr &&
+        !plan_->GetHaving()->EvaluateAggregate(agg_key.group_bys_, agg_val.aggregates_).GetAs<bool>()) {
+      continue;
+    }
+    for (uint32_t i = 0; i < output_schema->GetColumnCount(); i++) {
+      batch->Append(i, output_schema->GetColumn(i).GetExpr()->EvaluateAggregate(agg_key.group_bys_,
+                                                                                  agg_val.aggregates_));
+    }
+    batch->FinishRow(RID());
+  }
+  return !batch->IsEmpty();
+}
+
 }  // namespace bustub
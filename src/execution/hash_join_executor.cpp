@@ -0,0 +1,264 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.cpp
+//
+// Identification: src/execution/hash_join_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/hash_join_executor.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace bustub {
+
+HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                                   std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)),
+      memory_bytes_(static_cast<size_t>(std::max(1, plan->GetMemoryPages())) * PAGE_SIZE),
+      // every partition being written keeps a page pinned, so a level fans out to at most a quarter of the pool
+      num_partitions_(std::max<size_t>(
+          2, std::min<size_t>(plan->GetMemoryPages(), exec_ctx->GetBufferPoolManager()->GetPoolSize() / 4))) {}
+
+void HashJoinExecutor::Init() {
+  left_executor_->Init();
+  right_executor_->Init();
+  table_.clear();
+  match_ = match_end_ = table_.end();
+  build_left_ = true;
+  spilled_ = false;
+  pairs_.clear();
+  probe_partition_.reset();
+  probe_tuples_.clear();
+  probe_pos_ = 0;
+  left_batch_.Reset(nullptr);
+  left_row_ = 0;
+  right_batch_.Reset(nullptr);
+  right_row_ = 0;
+
+  // read both sides in turn until one of them runs out within the budget: that one is the smaller and builds the hash
+  // table, and the tuples read of the other are the first to probe it
+  std::vector<Tuple> left_tuples;
+  std::vector<Tuple> right_tuples;
+  size_t left_bytes = 0;
+  size_t right_bytes = 0;
+  bool left_done = false;
+  bool right_done = false;
+  while (!left_done && !right_done && (left_bytes <= memory_bytes_ || right_bytes <= memory_bytes_)) {
+    if (left_bytes <= memory_bytes_) {
+      left_done = !BufferTuple(true, &left_tuples, &left_bytes);
+    }
+    if (right_bytes <= memory_bytes_) {
+      right_done = !BufferTuple(false, &right_tuples, &right_bytes);
+    }
+  }
+  if (left_done || right_done) {
+    build_left_ = left_done && (!right_done || left_bytes <= right_bytes);
+    for (auto &tuple : build_left_ ? left_tuples : right_tuples) {
+      table_.emplace(MakeKey(tuple, build_left_), std::move(tuple));
+    }
+    probe_tuples_ = std::move(build_left_ ? right_tuples : left_tuples);
+    return;
+  }
+
+  // neither side fits, partition all of both
+  spilled_ = true;
+  Partitions left_partitions = NewPartitions();
+  PartitionSide(true, &left_tuples, &left_partitions);
+  Partitions right_partitions = NewPartitions();
+  PartitionSide(false, &right_tuples, &right_partitions);
+  AddPairs(&left_partitions, &right_partitions, 0);
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  const Tuple *left;
+  const Tuple *right;
+  if (!NextMatch(&left, &right)) {
+    return false;
+  }
+  std::vector<Value> output_row;
+  for (const auto &col : GetOutputSchema()->GetColumns()) {
+    output_row.push_back(col.GetExpr()->EvaluateJoin(left, left_executor_->GetOutputSchema(), right,
+                                                     right_executor_->GetOutputSchema()));
+  }
+  *tuple = Tuple(output_row, GetOutputSchema());
+  return true;
+}
+
+bool HashJoinExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *output_schema = GetOutputSchema();
+  batch->Reset(output_schema);
+  const Tuple *left;
+  const Tuple *right;
+  while (!batch->IsFull() && NextMatch(&left, &right)) {
+    for (uint32_t i = 0; i < output_schema->GetColumnCount(); i++) {
+      batch->Append(i, output_schema->GetColumn(i).GetExpr()->EvaluateJoin(left, left_executor_->GetOutputSchema(),
+                                                                           right, right_executor_->GetOutputSchema()));
+    }
+    batch->FinishRow(RID());
+  }
+  return !batch->IsEmpty();
+}
+
+HashJoinKey HashJoinExecutor::MakeKey(const Tuple &tuple, bool left) const {
+  const auto &exprs = left ? plan_->GetLeftKeys() : plan_->GetRightKeys();
+  const Schema *schema = left ? left_executor_->GetOutputSchema() : right_executor_->GetOutputSchema();
+  HashJoinKey key;
+  key.keys_.reserve(exprs.size());
+  for (const auto *expr : exprs) {
+    key.keys_.push_back(expr->Evaluate(&tuple, schema));
+  }
+  return key;
+}
+
+bool HashJoinExecutor::NextSideTuple(bool left, Tuple *tuple) {
+  return left ? NextChildTuple(left_executor_.get(), &left_batch_, &left_row_, tuple)
+              : NextChildTuple(right_executor_.get(), &right_batch_, &right_row_, tuple);
+}
+
+bool HashJoinExecutor::BufferTuple(bool left, std::vector<Tuple> *tuples, size_t *bytes) {
+  Tuple tuple;
+  // a null key equals no key, its tuple joins with nothing
+  do {
+    if (!NextSideTuple(left, &tuple)) {
+      return false;
+    }
+  } while (MakeKey(tuple, left).HasNull());
+  *bytes += tuple.GetLength();
+  tuples->push_back(std::move(tuple));
+  return true;
+}
+
+size_t HashJoinExecutor::PartitionOf(const HashJoinKey &key, int level) const {
+  // every level mixes its own number into the hash, so that it splits up what the level before kept together
+  return HashUtil::CombineHashes(std::hash<HashJoinKey>()(key), level) % num_partitions_;
+}
+
+HashJoinExecutor::Partitions HashJoinExecutor::NewPartitions() {
+  Partitions partitions;
+  for (size_t i = 0; i < num_partitions_; i++) {
+    partitions.push_back(std::make_unique<TmpTupleRun>(GetExecutorContext()->GetBufferPoolManager()));
+  }
+  return partitions;
+}
+
+void HashJoinExecutor::PartitionSide(bool left, std::vector<Tuple> *tuples, Partitions *partitions) {
+  for (const auto &tuple : *tuples) {
+    (*partitions)[PartitionOf(MakeKey(tuple, left), 0)]->Append(tuple);
+  }
+  tuples->clear();
+  Tuple tuple;
+  while (NextSideTuple(left, &tuple)) {
+    HashJoinKey key = MakeKey(tuple, left);
+    if (!key.HasNull()) {
+      (*partitions)[PartitionOf(key, 0)]->Append(tuple);
+    }
+  }
+}
+
+void HashJoinExecutor::Repartition(TmpTupleRun *partition, bool left, int level, Partitions *partitions) const {
+  std::vector<Tuple> tuples;
+  while (partition->ReadPage(&tuples)) {
+    for (const auto &tuple : tuples) {
+      (*partitions)[PartitionOf(MakeKey(tuple, left), level)]->Append(tuple);
+    }
+  }
+  for (auto &new_partition : *partitions) {
+    new_partition->Finish();
+  }
+}
+
+void HashJoinExecutor::AddPairs(Partitions *left, Partitions *right, int level) {
+  for (size_t i = 0; i < num_partitions_; i++) {
+    (*left)[i]->Finish();
+    (*right)[i]->Finish();
+    // an inner join of a pair with an empty side has no result
+    if ((*left)[i]->GetSize() > 0 && (*right)[i]->GetSize() > 0) {
+      pairs_.push_back({std::move((*left)[i]), std::move((*right)[i]), level});
+    }
+  }
+}
+
+bool HashJoinExecutor::NextProbeTuple(Tuple *tuple) {
+  while (probe_pos_ == probe_tuples_.size()) {
+    if (!spilled_) {
+      // past the tuples read while picking the build side, the probe side streams from its child
+      return NextSideTuple(!build_left_, tuple);
+    }
+    if (probe_partition_ == nullptr || !probe_partition_->ReadPage(&probe_tuples_)) {
+      return false;
+    }
+    probe_pos_ = 0;
+  }
+  *tuple = probe_tuples_[probe_pos_++];
+  return true;
+}
+
+bool HashJoinExecutor::LoadNextPair() {
+  table_.clear();
+  match_ = match_end_ = table_.end();
+  probe_partition_.reset();
+  probe_tuples_.clear();
+  probe_pos_ = 0;
+  while (!pairs_.empty()) {
+    PartitionPair pair = std::move(pairs_.back());
+    pairs_.pop_back();
+    // build on the smaller side of the pair
+    build_left_ = pair.left_->GetBytes() <= pair.right_->GetBytes();
+    TmpTupleRun *build = build_left_ ? pair.left_.get() : pair.right_.get();
+    if (build->GetBytes() > memory_bytes_ && pair.level_ < MAX_PARTITION_LEVEL) {
+      Partitions left = NewPartitions();
+      Repartition(pair.left_.get(), true, pair.level_ + 1, &left);
+      Partitions right = NewPartitions();
+      Repartition(pair.right_.get(), false, pair.level_ + 1, &right);
+      AddPairs(&left, &right, pair.level_ + 1);
+      continue;
+    }
+    std::vector<Tuple> tuples;
+    while (build->ReadPage(&tuples)) {
+      for (const auto &tuple : tuples) {
+        table_.emplace(MakeKey(tuple, build_left_), tuple);
+      }
+    }
+    probe_partition_ = std::move(build_left_ ? pair.right_ : pair.left_);
+    return true;
+  }
+  return false;
+}
+
+bool HashJoinExecutor::NextMatch(const Tuple **left, const Tuple **right) {
+  const AbstractExpression *predicate = plan_->Predicate();
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  while (true) {
+    while (match_ != match_end_) {
+      const Tuple &build_tuple = (match_++)->second;
+      *left = build_left_ ? &build_tuple : &probe_tuple_;
+      *right = build_left_ ? &probe_tuple_ : &build_tuple;
+      if (predicate == nullptr || predicate->EvaluateJoin(*left, left_schema, *right, right_schema).GetAs<bool>()) {
+        return true;
+      }
+    }
+    if (!NextProbeTuple(&probe_tuple_)) {
+      if (!spilled_ || !LoadNextPair()) {
+        return false;
+      }
+      continue;
+    }
+    HashJoinKey key = MakeKey(probe_tuple_, !build_left_);
+    if (!key.HasNull()) {
+      std::tie(match_, match_end_) = table_.equal_range(key);
+    }
+  }
+}
+
+}  // namespace bustub
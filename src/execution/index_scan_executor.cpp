@@ -20,36 +20,105 @@ void IndexScanExecutor::Init() {
   index_info = catalog->GetIndex(plan_->GetIndexOid());
   table_info = catalog->GetTable(index_info->table_name_);
   table_heap = table_info->table_.get();
-  itor = dynamic_cast<BPlusTree_IndexIterator_TYPE *>(index_info->index_.get())->GetBeginIterator();
+  auto *index = dynamic_cast<BPlusTree_IndexIterator_TYPE *>(index_info->index_.get());
+
+  batch_.clear();
+  batch_offset_ = 0;
+  lower_bound_ = plan_->GetLowerBound();
+  upper_bound_ = plan_->GetUpperBound();
+  if (!lower_bound_.has_value() && !upper_bound_.has_value() && plan_->GetPredicate() != nullptr) {
+    // the predicate reads the output tuple, find the output column that is the first key column
+    const auto &columns = plan_->OutputSchema()->GetColumns();
+    uint32_t key_column = index_info->index_->GetKeyAttrs()[0];
+    for (uint32_t i = 0; i < columns.size(); i++) {
+      const auto *expr = dynamic_cast<const ColumnValueExpression *>(columns[i].GetExpr());
+      if (expr != nullptr && expr->GetColIdx() == key_column) {
+        IndexScanPlanNode::ExtractBounds(plan_->GetPredicate(), i, &lower_bound_, &upper_bound_);
+        break;
+      }
+    }
+  }
+
+  if (!lower_bound_.has_value()) {
+    itor = index->GetBeginIterator();
+    return;
+  }
+  // seek to the least key whose first column is the lower bound
+  Schema *key_schema = index_info->index_->GetKeySchema();
+  std::vector<Value> key_values;
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    TypeId type = key_schema->GetColumn(i).GetType();
+    key_values.push_back(Type::GetMinValue(type));
+  }
+  const Value &bound = lower_bound_->value_;
+  TypeId key_type = key_schema->GetColumn(0).GetType();
+  try {
+    key_values[0] = bound.GetTypeId() == key_type ? bound : bound.CastAs(key_type);
+  } catch (const Exception &e) {
+    // the bound does not fit the key column, scan from the start and let Next() skip what is below it
+    itor = index->GetBeginIterator();
+    return;
+  }
+  GenericKey<8> key;
+  key.SetFromKey(Tuple(key_values, key_schema));
+  itor = index->GetBeginIterator(key);
 }
 
-bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
-  if (itor == dynamic_cast<BPlusTree_IndexIterator_TYPE *>(index_info->index_.get())->GetEndIterator()) {
-    return false;
+Value IndexScanExecutor::LeadingKeyValue() { return (*itor).first.ToValue(index_info->index_->GetKeySchema(), 0); }
+
+bool IndexScanExecutor::PastBound(const Value &value, const IndexScanBound &bound, bool upper) {
+  if (value.CompareEquals(bound.value_) == CmpBool::CmpTrue) {
+    return !bound.inclusive_;
   }
-  RID cur_rid = (*itor).second;
-  Tuple tuple_all;
-  bool get_tuple = table_heap->GetTuple(cur_rid, &tuple_all, GetExecutorContext()->GetTransaction());
-  if (!get_tuple) {
+  return (upper ? value.CompareGreaterThan(bound.value_) : value.CompareLessThan(bound.value_)) == CmpBool::CmpTrue;
+}
+
+bool IndexScanExecutor::FetchBatch() {
+  auto *index = dynamic_cast<BPlusTree_IndexIterator_TYPE *>(index_info->index_.get());
+  batch_rids_.clear();
+  for (; itor != index->GetEndIterator() && batch_rids_.size() < static_cast<size_t>(INDEX_FETCH_BATCH_SIZE);
+       ++itor) {
+    if (lower_bound_.has_value() || upper_bound_.has_value()) {
+      Value key_value = LeadingKeyValue();
+      if (upper_bound_.has_value() && PastBound(key_value, *upper_bound_, true)) {
+        // nothing further along the index is in range
+        itor = index->GetEndIterator();
+        break;
+      }
+      if (lower_bound_.has_value() && PastBound(key_value, *lower_bound_, false)) {
+        continue;
+      }
+    }
+    batch_rids_.push_back((*itor).second);
+  }
+  batch_offset_ = 0;
+  if (!table_heap->GetTuples(batch_rids_, &batch_, GetExecutorContext()->GetTransaction(), plan_->KeepOrder()) ||
+      batch_.size() != batch_rids_.size()) {
     throw Exception(ExceptionType::TUPLE_ERROR, "IndexScanExecutor:can not get this tuple by RID.");
   }
+  return !batch_.empty();
+}
+
+bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
   const Schema *output_schema = plan_->OutputSchema();
-  std::vector<Value> vals;
-  for (const auto &col : output_schema->GetColumns()) {
-    Value col_val = col.GetExpr()->Evaluate(&tuple_all, &(table_info->schema_));
-    vals.push_back(col_val);
-  }
-  ++itor;
-  Tuple out_tuple(vals, output_schema);
-  bool ismatch = plan_->GetPredicate() == nullptr
-                     ? true
-                     : plan_->GetPredicate()->Evaluate(&out_tuple, output_schema).GetAs<bool>();
-  if (ismatch) {
-    *tuple = out_tuple;
-    *rid = cur_rid;
-    return true;
-  }
-  return Next(tuple, rid);
+  while (batch_offset_ < batch_.size() || FetchBatch()) {
+    const Tuple &tuple_all = batch_[batch_offset_++].second;
+    std::vector<Value> vals;
+    for (const auto &col : output_schema->GetColumns()) {
+      Value col_val = col.GetExpr()->Evaluate(&tuple_all, &(table_info->schema_));
+      vals.push_back(col_val);
+    }
+    Tuple out_tuple(vals, output_schema);
+    bool ismatch = plan_->GetPredicate() == nullptr
+                       ? true
+                       : plan_->GetPredicate()->Evaluate(&out_tuple, output_schema).GetAs<bool>();
+    if (ismatch) {
+      *tuple = out_tuple;
+      *rid = tuple_all.GetRid();
+      return true;
+    }
+  }
+  return false;
 }
 
 }  // namespace bustub
@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.cpp
+//
+// Identification: src/execution/merge_join_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/merge_join_executor.h"
+
+namespace bustub {
+
+MergeJoinExecutor::MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                                     std::unique_ptr<AbstractExecutor> &&left_executor,
+                                     std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)),
+      key_types_(plan->GetLeftKeys().size(), OrderByType::Asc) {}
+
+void MergeJoinExecutor::Init() {
+  left_executor_->Init();
+  right_executor_->Init();
+  left_batch_.Reset(nullptr);
+  left_row_ = 0;
+  right_batch_.Reset(nullptr);
+  right_row_ = 0;
+  run_.clear();
+  run_pos_ = 0;
+  AdvanceLeft();
+  AdvanceRight();
+}
+
+bool MergeJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  const Tuple *left;
+  const Tuple *right;
+  if (!NextMatch(&left, &right)) {
+    return false;
+  }
+  std::vector<Value> output_row;
+  for (const auto &col : GetOutputSchema()->GetColumns()) {
+    output_row.push_back(col.GetExpr()->EvaluateJoin(left, left_executor_->GetOutputSchema(), right,
+                                                     right_executor_->GetOutputSchema()));
+  }
+  *tuple = Tuple(output_row, GetOutputSchema());
+  return true;
+}
+
+bool MergeJoinExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *output_schema = GetOutputSchema();
+  batch->Reset(output_schema);
+  const Tuple *left;
+  const Tuple *right;
+  while (!batch->IsFull() && NextMatch(&left, &right)) {
+    for (uint32_t i = 0; i < output_schema->GetColumnCount(); i++) {
+      batch->Append(i, output_schema->GetColumn(i).GetExpr()->EvaluateJoin(left, left_executor_->GetOutputSchema(),
+                                                                           right, right_executor_->GetOutputSchema()));
+    }
+    batch->FinishRow(RID());
+  }
+  return !batch->IsEmpty();
+}
+
+SortKey MergeJoinExecutor::MakeKey(const Tuple &tuple, bool left) const {
+  const auto &exprs = left ? plan_->GetLeftKeys() : plan_->GetRightKeys();
+  const Schema *schema = left ? left_executor_->GetOutputSchema() : right_executor_->GetOutputSchema();
+  SortKey key;
+  key.keys_.reserve(exprs.size());
+  for (const auto *expr : exprs) {
+    key.keys_.push_back(expr->Evaluate(&tuple, schema));
+  }
+  return key;
+}
+
+void MergeJoinExecutor::AdvanceLeft() {
+  has_left_ = NextChildTuple(left_executor_.get(), &left_batch_, &left_row_, &left_tuple_);
+  if (has_left_) {
+    left_key_ = MakeKey(left_tuple_, true);
+  }
+}
+
+void MergeJoinExecutor::AdvanceRight() {
+  has_right_ = NextChildTuple(right_executor_.get(), &right_batch_, &right_row_, &right_tuple_);
+  if (has_right_) {
+    right_key_ = MakeKey(right_tuple_, false);
+  }
+}
+
+bool MergeJoinExecutor::NextMatch(const Tuple **left, const Tuple **right) {
+  const AbstractExpression *predicate = plan_->Predicate();
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  while (true) {
+    if (!run_.empty()) {
+      while (run_pos_ < run_.size()) {
+        *left = &left_tuple_;
+        *right = &run_[run_pos_++];
+        if (predicate == nullptr || predicate->EvaluateJoin(*left, left_schema, *right, right_schema).GetAs<bool>()) {
+          return true;
+        }
+      }
+      // the next left tuple joins with the same run if it has the same key
+      AdvanceLeft();
+      if (has_left_ && left_key_.Compare(run_key_, key_types_) == 0) {
+        run_pos_ = 0;
+        continue;
+      }
+      run_.clear();
+    }
+    if (!has_left_ || !has_right_) {
+      return false;
+    }
+    // a null key equals no key, its tuple joins with nothing
+    if (left_key_.HasNull()) {
+      AdvanceLeft();
+      continue;
+    }
+    if (right_key_.HasNull()) {
+      AdvanceRight();
+      continue;
+    }
+    int cmp = left_key_.Compare(right_key_, key_types_);
+    if (cmp < 0) {
+      AdvanceLeft();
+    } else if (cmp > 0) {
+      AdvanceRight();
+    } else {
+      run_key_ = right_key_;
+      run_pos_ = 0;
+      do {
+        run_.push_back(right_tuple_);
+        AdvanceRight();
+      } while (has_right_ && right_key_.Compare(run_key_, key_types_) == 0);
+    }
+  }
+}
+
+}  // namespace bustub
@@ -23,40 +23,65 @@ void NestIndexJoinExecutor::Init() {
   innerTable_info = catalog->GetTable(plan_->GetInnerTableOid());
   innerIndex_info = catalog->GetIndex(plan_->GetIndexName(), innerTable_info->name_);
   child_executor_->Init();
+  inner_batch_.clear();
+  batch_offset_ = 0;
 }
 
-bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) {
+bool NestIndexJoinExecutor::FetchBatch() {
+  outer_batch_.clear();
+  inner_rids_.clear();
+  inner_outer_.clear();
   Tuple outer_tuple;
-  Tuple inner_tuple;
   RID outer_rid;
-  if (child_executor_->Next(&outer_tuple, &outer_rid)) {
+  // probe until the batch has enough matches to fetch, or the outer side runs out
+  while (inner_rids_.size() < static_cast<size_t>(INDEX_FETCH_BATCH_SIZE) &&
+         child_executor_->Next(&outer_tuple, &outer_rid)) {
     std::vector<Value> vals{
         plan_->Predicate()->GetChildAt(0)->Evaluate(&outer_tuple, child_executor_->GetOutputSchema())};
     Tuple key_tuple(vals, &innerIndex_info->key_schema_);
-    // get RID
     std::vector<RID> value_rid;
     innerIndex_info->index_->ScanKey(key_tuple, &value_rid, GetExecutorContext()->GetTransaction());
     if (value_rid.empty()) {
-      return Next(tuple, rid);
+      continue;
+    }
+    for (const RID &inner_rid : value_rid) {
+      inner_rids_.push_back(inner_rid);
+      inner_outer_.push_back(outer_batch_.size());
     }
-    innerTable_info->table_->GetTuple(value_rid[0], &inner_tuple, GetExecutorContext()->GetTransaction());
-    // check if match,no need to do this
-    /* bool ismatch = plan_->Predicate()
-                       ->EvaluateJoin(&outer_tuple, plan_->OuterTableSchema(), &inner_tuple, &innerTable_info->schema_)
-                       .GetAs<bool>();
-    if (!ismatch) {
-      return Next(tuple, rid);
-    } */
-    // get output tuple
-    std::vector<Value> output_row;
-    for (const auto &col : GetOutputSchema()->GetColumns()) {
-      output_row.push_back(col.GetExpr()->EvaluateJoin(&outer_tuple, plan_->OuterTableSchema(), &inner_tuple,
-                                                       &innerTable_info->schema_));
+    outer_batch_.push_back(outer_tuple);
+  }
+  batch_offset_ = 0;
+  if (!innerTable_info->table_->GetTuples(inner_rids_, &inner_batch_, GetExecutorContext()->GetTransaction(),
+                                          plan_->KeepOrder()) ||
+      inner_batch_.size() != inner_rids_.size()) {
+    throw Exception(ExceptionType::TUPLE_ERROR, "NestIndexJoinExecutor:can not get this tuple by RID.");
+  }
+  return !inner_batch_.empty() || !outer_batch_.empty();
+}
+
+bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  while (batch_offset_ == inner_batch_.size()) {
+    if (!FetchBatch()) {
+      return false;
     }
-    *tuple = Tuple(output_row, GetOutputSchema());
-    return true;
   }
-  return false;
+  const auto &[position, inner_tuple] = inner_batch_[batch_offset_++];
+  const Tuple &outer_tuple = outer_batch_[inner_outer_[position]];
+  // check if match,no need to do this
+  /* bool ismatch = plan_->Predicate()
+                     ->EvaluateJoin(&outer_tuple, plan_->OuterTableSchema(), &inner_tuple, &innerTable_info->schema_)
+                     .GetAs<bool>();
+  if (!ismatch) {
+    return Next(tuple, rid);
+  } */
+  // get output tuple
+  std::vector<Value> output_row;
+  for (const auto &col : GetOutputSchema()->GetColumns()) {
+    output_row.push_back(col.GetExpr()->EvaluateJoin(&outer_tuple, plan_->OuterTableSchema(), &inner_tuple,
+                                                     &innerTable_info->schema_));
+  }
+  *tuple = Tuple(output_row, GetOutputSchema());
+  return true;
 }
 
 }  // namespace bustub
@@ -12,6 +12,8 @@
 
 #include "execution/executors/nested_loop_join_executor.h"
 
+#include <algorithm>
+
 namespace bustub {
 
 NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
@@ -20,52 +22,101 @@ NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const
     : AbstractExecutor(exec_ctx),
       plan_(plan),
       left_executor_(std::move(left_executor)),
-      right_executor_(std::move(right_executor)) {}
+      right_executor_(std::move(right_executor)),
+      block_bytes_(static_cast<size_t>(std::max(1, plan->GetBlockPages())) * PAGE_SIZE) {}
 
 void NestedLoopJoinExecutor::Init() {
-  std::vector<Tuple> left_tuple;
-  std::vector<Tuple> right_tuple;
-  do_child_executor(&left_tuple, left_executor_.get());
-  do_child_executor(&right_tuple, right_executor_.get());
-  for (auto &l1 : left_tuple) {
-    for (auto &r1 : right_tuple) {
-      // predicate null or evaluate true
-      if (plan_->Predicate() == nullptr ||
-          plan_->Predicate()
-              ->EvaluateJoin(&l1, left_executor_->GetOutputSchema(), &r1, right_executor_->GetOutputSchema())
-              .GetAs<bool>()) {
-        std::vector<Value> output_row;
-        for (const auto &col : GetOutputSchema()->GetColumns()) {
-          output_row.push_back(col.GetExpr()->EvaluateJoin(&l1, left_executor_->GetOutputSchema(), &r1,
-                                                           right_executor_->GetOutputSchema()));
-        }
-        res.emplace_back(Tuple(output_row, GetOutputSchema()));
-      }
-    }
-  }
+  // the right child is initialized for every block
+  left_executor_->Init();
+  block_.clear();
+  left_batch_.Reset(nullptr);
+  left_row_ = 0;
+  right_batch_.Reset(nullptr);
+  right_row_ = 0;
+  right_empty_ = false;
+  block_pos_ = 0;
 }
 
 bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
-  if (idx < res.size()) {
-    *tuple = res[idx++];
-    return true;
+  const Tuple *left;
+  const Tuple *right;
+  if (!NextMatch(&left, &right)) {
+    return false;
   }
-  return false;
+  std::vector<Value> output_row;
+  for (const auto &col : GetOutputSchema()->GetColumns()) {
+    output_row.push_back(col.GetExpr()->EvaluateJoin(left, left_executor_->GetOutputSchema(), right,
+                                                     right_executor_->GetOutputSchema()));
+  }
+  *tuple = Tuple(output_row, GetOutputSchema());
+  return true;
 }
 
-bool NestedLoopJoinExecutor::do_child_executor(std::vector<Tuple> *child_tuple, AbstractExecutor *child_executor) {
-  child_executor->Init();
-  try {
-    Tuple tuple;
-    RID rid;
-    while (child_executor->Next(&tuple, &rid)) {
-      (*child_tuple).push_back(tuple);
+bool NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *output_schema = GetOutputSchema();
+  batch->Reset(output_schema);
+  const Tuple *left;
+  const Tuple *right;
+  while (!batch->IsFull() && NextMatch(&left, &right)) {
+    for (uint32_t i = 0; i < output_schema->GetColumnCount(); i++) {
+      batch->Append(i, output_schema->GetColumn(i).GetExpr()->EvaluateJoin(left, left_executor_->GetOutputSchema(),
+                                                                           right, right_executor_->GetOutputSchema()));
     }
-  } catch (Exception &e) {
-    throw Exception(ExceptionType::CHILD_EXE_FAIL, "InsertExecutor:child execute error.");
+    batch->FinishRow(RID());
+  }
+  return !batch->IsEmpty();
+}
+
+bool NestedLoopJoinExecutor::LoadNextBlock() {
+  block_.clear();
+  if (right_empty_) {
     return false;
   }
+  // a block holds at least one tuple, however large
+  size_t bytes = 0;
+  Tuple tuple;
+  while (bytes < block_bytes_ && NextChildTuple(left_executor_.get(), &left_batch_, &left_row_, &tuple)) {
+    bytes += tuple.GetLength();
+    block_.push_back(tuple);
+  }
+  if (block_.empty()) {
+    return false;
+  }
+  right_executor_->Init();
+  right_batch_.Reset(nullptr);
+  right_row_ = 0;
   return true;
 }
 
+bool NestedLoopJoinExecutor::NextMatch(const Tuple **left, const Tuple **right) {
+  const AbstractExpression *predicate = plan_->Predicate();
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  while (true) {
+    while (block_pos_ < block_.size()) {
+      *left = &block_[block_pos_++];
+      *right = &right_tuple_;
+      // predicate null or evaluate true
+      if (predicate == nullptr || predicate->EvaluateJoin(*left, left_schema, *right, right_schema).GetAs<bool>()) {
+        return true;
+      }
+    }
+    if (!block_.empty() && NextChildTuple(right_executor_.get(), &right_batch_, &right_row_, &right_tuple_)) {
+      block_pos_ = 0;
+      continue;
+    }
+    // the right child is done with this block, or there is no block yet
+    if (!LoadNextBlock()) {
+      return false;
+    }
+    if (!NextChildTuple(right_executor_.get(), &right_batch_, &right_row_, &right_tuple_)) {
+      // every scan of the right child finds the same tuples, so no later block joins either
+      right_empty_ = true;
+      block_.clear();
+      return false;
+    }
+    block_pos_ = 0;
+  }
+}
+
 }  // namespace bustub
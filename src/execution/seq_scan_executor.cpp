@@ -21,33 +21,25 @@ void SeqScanExecutor::Init() {
   table_info = catalog->GetTable(plan_->GetTableOid());
   table_heap = table_info->table_.get();
   itor = table_heap->Begin(GetExecutorContext()->GetTransaction());
+  page_tuples_.clear();
+  page_pos_ = 0;
+  next_page_id_ = table_heap->GetFirstPageId();
 }
 
 bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
   if (itor == table_heap->End()) {
     return false;
   }
-  LockManager *lock_mgr = GetExecutorContext()->GetLockManager();
-  Transaction *txn = GetExecutorContext()->GetTransaction();
   RID original_rid = itor->GetRid();
-  if (lock_mgr != nullptr) {
-    if (txn->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED) {
-      if (!txn->IsSharedLocked(original_rid) && !txn->IsExclusiveLocked(original_rid)) {
-        lock_mgr->LockShared(txn, original_rid);
-      }
-    }
-  }
+  LockRow(original_rid);
   const Schema *output_schema = plan_->OutputSchema();
   std::vector<Value> vals;
   for (const auto &col : output_schema->GetColumns()) {
     Value col_val = col.GetExpr()->Evaluate(&(*itor), &(table_info->schema_));
     vals.push_back(col_val);
   }
-  if (txn->GetIsolationLevel() == IsolationLevel::READ_COMMITTED && lock_mgr != nullptr) {
-    lock_mgr->Unlock(txn, original_rid);
-  }
+  UnlockRow(original_rid);
   ++itor;
-  // unlock if read_commited, in read_commited,unlock will not cause shrinking
 
   Tuple out_tuple(vals, output_schema);
   const AbstractExpression *predict = plan_->GetPredicate();
@@ -59,4 +51,62 @@ bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
   return Next(tuple, rid);
 }
 
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *output_schema = plan_->OutputSchema();
+  const AbstractExpression *predicate = plan_->GetPredicate();
+  Transaction *txn = GetExecutorContext()->GetTransaction();
+  std::vector<Value> mask;
+  // a batch the predicate empties is no batch, on to the next tuples
+  do {
+    batch->Reset(output_schema);
+    while (!batch->IsFull()) {
+      // read the table a page at a time, rather than fetching the page again for every tuple
+      if (page_pos_ == page_tuples_.size()) {
+        if (next_page_id_ == INVALID_PAGE_ID ||
+            !table_heap->GetPageTuples(next_page_id_, &page_tuples_, &next_page_id_, txn)) {
+          next_page_id_ = INVALID_PAGE_ID;
+          page_tuples_.clear();
+          page_pos_ = 0;
+          break;
+        }
+        page_pos_ = 0;
+        continue;
+      }
+      const auto &[original_rid, table_tuple] = page_tuples_[page_pos_++];
+      LockRow(original_rid);
+      for (uint32_t i = 0; i < output_schema->GetColumnCount(); i++) {
+        batch->Append(i, output_schema->GetColumn(i).GetExpr()->Evaluate(&table_tuple, &(table_info->schema_)));
+      }
+      UnlockRow(original_rid);
+      batch->FinishRow(original_rid);
+    }
+    if (predicate != nullptr && !batch->IsEmpty()) {
+      predicate->EvaluateBatch(*batch, &mask);
+      batch->Select(mask);
+    }
+  } while (batch->IsEmpty() && (next_page_id_ != INVALID_PAGE_ID || page_pos_ < page_tuples_.size()));
+  return !batch->IsEmpty();
+}
+
+void SeqScanExecutor::LockRow(const RID &rid) {
+  LockManager *lock_mgr = GetExecutorContext()->GetLockManager();
+  Transaction *txn = GetExecutorContext()->GetTransaction();
+  if (lock_mgr != nullptr) {
+    if (txn->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED) {
+      if (!txn->IsSharedLocked(rid) && !txn->IsExclusiveLocked(rid)) {
+        lock_mgr->LockShared(txn, rid);
+      }
+    }
+  }
+}
+
+void SeqScanExecutor::UnlockRow(const RID &rid) {
+  // unlock if read_commited, in read_commited,unlock will not cause shrinking
+  LockManager *lock_mgr = GetExecutorContext()->GetLockManager();
+  Transaction *txn = GetExecutorContext()->GetTransaction();
+  if (txn->GetIsolationLevel() == IsolationLevel::READ_COMMITTED && lock_mgr != nullptr) {
+    lock_mgr->Unlock(txn, rid);
+  }
+}
+
 }  // namespace bustub
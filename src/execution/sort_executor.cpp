@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.cpp
+//
+// Identification: src/execution/sort_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/sort_executor.h"
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      memory_bytes_(static_cast<size_t>(std::max(1, plan->GetMemoryPages())) * PAGE_SIZE),
+      // a merge holds a page of every run it reads from
+      fan_in_(std::max(2, plan->GetMemoryPages())) {}
+
+void SortExecutor::Init() {
+  child_executor_->Init();
+  BufferPoolManager *buffer_pool_manager = GetExecutorContext()->GetBufferPoolManager();
+  sorter_ = std::make_unique<ExternalSorter<Entry, SortRun, EntryLess>>(
+      [this, buffer_pool_manager] { return std::make_unique<SortRun>(buffer_pool_manager, this); },
+      EntryLess{&plan_->GetOrderByTypes()}, memory_bytes_, fan_in_);
+
+  TupleBatch batch;
+  size_t row = 0;
+  Tuple tuple;
+  size_t bytes = 0;
+  bool top_n = has_limit_;
+  auto top_n_less = [this](const TopNEntry &lhs, const TopNEntry &rhs) { return TopNLess(lhs, rhs); };
+  // the tuple that sorts last among those kept is on top, the first one to be dropped
+  std::priority_queue<TopNEntry, std::vector<TopNEntry>, decltype(top_n_less)> top(top_n_less);
+  for (size_t seq = 0; NextChildTuple(child_executor_.get(), &batch, &row, &tuple); seq++) {
+    if (top_n) {
+      if (limit_ == 0) {
+        break;
+      }
+      TopNEntry entry{MakeKey(tuple), seq, tuple, batch.GetRid(row - 1)};
+      if (top.size() == limit_) {
+        if (!TopNLess(entry, top.top())) {
+          continue;
+        }
+        bytes -= top.top().tuple_.GetLength();
+        top.pop();
+      }
+      bytes += tuple.GetLength();
+      top.push(std::move(entry));
+      if (bytes > memory_bytes_) {
+        // the limit does not fit in memory, sort everything instead and let the limit drop the rest
+        std::vector<TopNEntry> kept;
+        for (; !top.empty(); top.pop()) {
+          kept.push_back(top.top());
+        }
+        std::sort(kept.begin(), kept.end(),
+                  [](const TopNEntry &lhs, const TopNEntry &rhs) { return lhs.seq_ < rhs.seq_; });
+        for (auto &kept_entry : kept) {
+          size_t kept_bytes = kept_entry.tuple_.GetLength();
+          sorter_->Add({std::move(kept_entry.key_), std::move(kept_entry.tuple_), kept_entry.rid_}, kept_bytes);
+        }
+        top_n = false;
+      }
+      continue;
+    }
+    sorter_->Add({MakeKey(tuple), tuple, batch.GetRid(row - 1)}, tuple.GetLength());
+  }
+  if (top_n) {
+    // the heap gives the tuples back last first, and sorted they go through the sorter in memory
+    std::vector<TopNEntry> kept;
+    for (; !top.empty(); top.pop()) {
+      kept.push_back(top.top());
+    }
+    for (auto it = kept.rbegin(); it != kept.rend(); ++it) {
+      size_t kept_bytes = it->tuple_.GetLength();
+      sorter_->Add({std::move(it->key_), std::move(it->tuple_), it->rid_}, kept_bytes);
+    }
+  }
+  sorter_->Finish();
+}
+
+bool SortExecutor::Next(Tuple *tuple, RID *rid) {
+  Entry entry;
+  if (!sorter_->Next(&entry)) {
+    return false;
+  }
+  *tuple = std::move(entry.tuple_);
+  *rid = entry.rid_;
+  return true;
+}
+
+SortKey SortExecutor::MakeKey(const Tuple &tuple) const {
+  SortKey key;
+  key.keys_.reserve(plan_->GetOrderBys().size());
+  for (const auto *expr : plan_->GetOrderBys()) {
+    key.keys_.push_back(expr->Evaluate(&tuple, child_executor_->GetOutputSchema()));
+  }
+  return key;
+}
+
+bool SortExecutor::TopNLess(const TopNEntry &lhs, const TopNEntry &rhs) const {
+  int cmp = lhs.key_.Compare(rhs.key_, plan_->GetOrderByTypes());
+  return cmp < 0 || (cmp == 0 && lhs.seq_ < rhs.seq_);
+}
+
+bool SortExecutor::SortRun::ReadPage(std::vector<Entry> *entries) {
+  std::vector<Tuple> tuples;
+  entries->clear();
+  if (!run_.ReadPage(&tuples)) {
+    return false;
+  }
+  // the RIDs of a page of tuples need not lie on a single page of RIDs
+  for (auto &tuple : tuples) {
+    if (next_rid_ == rids_.size()) {
+      rid_run_.ReadPage(&rids_);
+      next_rid_ = 0;
+    }
+    SortKey key = sort_->MakeKey(tuple);
+    entries->push_back({std::move(key), std::move(tuple), rids_[next_rid_++]});
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+#include <cassert>
+
+namespace bustub {
+
+void TupleBatch::Reset(const Schema *schema) {
+  columns_.resize(schema == nullptr ? 0 : schema->GetColumnCount());
+  for (auto &column : columns_) {
+    column.clear();
+    column.reserve(capacity_);
+  }
+  rids_.clear();
+  num_rows_ = 0;
+}
+
+void TupleBatch::FinishRow(const RID &rid) {
+  rids_.push_back(rid);
+  num_rows_++;
+  for (const auto &column : columns_) {
+    assert(column.size() == num_rows_);
+    (void)column;
+  }
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple, const Schema *schema, const RID &rid) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].push_back(tuple.GetValue(schema, i));
+  }
+  FinishRow(rid);
+}
+
+Tuple TupleBatch::GetTuple(size_t row, const Schema *schema) const {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column[row]);
+  }
+  return Tuple(values, schema);
+}
+
+void TupleBatch::Select(const std::vector<Value> &mask) {
+  assert(mask.size() == num_rows_);
+  size_t kept = 0;
+  for (size_t row = 0; row < num_rows_; row++) {
+    if (!mask[row].GetAs<bool>()) {
+      continue;
+    }
+    if (kept != row) {
+      for (auto &column : columns_) {
+        column[kept] = column[row];
+      }
+      rids_[kept] = rids_[row];
+    }
+    kept++;
+  }
+  for (auto &column : columns_) {
+    column.resize(kept);
+  }
+  rids_.resize(kept);
+  num_rows_ = kept;
+}
+
+}  // namespace bustub
@@ -12,10 +12,19 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
-#include <mutex>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
@@ -23,10 +32,18 @@
 
 namespace bustub {
 
+class ParallelBufferPoolManager;
+
+/** Replacement policy used by a BufferPoolManager to pick victim frames. */
+enum class ReplacerType { LRU, CLOCK, LRUK };
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
 class BufferPoolManager {
+  // The parallel pool routes requests to the *Impl methods of its instances.
+  friend class ParallelBufferPoolManager;
+
  public:
   enum class CallbackType { BEFORE, AFTER };
   using bufferpool_callback_fn = void (*)(enum CallbackType, const page_id_t page_id);
@@ -36,13 +53,17 @@ class BufferPoolManager {
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
+   * @param use_huge_pages back the frames with huge pages (explicit if reserved, transparent otherwise) to spare TLB
+   * misses on large pools
    */
-  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                    ReplacerType replacer_type = ReplacerType::LRU, bool use_huge_pages = false);
 
   /**
    * Destroys an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager();
 
   /** Grading function. Do not modify! */
   Page *FetchPage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) {
@@ -76,6 +97,15 @@ class BufferPoolManager {
     return result;
   }
 
+  /**
+   * Creates a new page like NewPage(). If the disk manager has deallocated pages to reuse, the one closest to the hint
+   * is taken, so pages that are read together stay together in the file.
+   * @param[out] page_id id of created page
+   * @param hint a page the new one will mostly be used together with
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPageNear(page_id_t *page_id, page_id_t hint) { return NewPageImpl(page_id, hint); }
+
   /** Grading function. Do not modify! */
   bool DeletePage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
@@ -91,13 +121,71 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
-  /** @return pointer to all the pages in the buffer pool */
+  /** @return pointer to all the pages in the buffer pool, nullptr if the pool does not own its frames */
   Page *GetPages() { return pages_; }
 
   /** @return size of the buffer pool */
   size_t GetPoolSize() { return pool_size_; }
 
+  /**
+   * Starts a background thread that writes dirty, unpinned pages back to disk so that evictions rarely have to.
+   * It runs every interval, or sooner when an eviction had to write, and does nothing while enough frames are clean.
+   * @param target_clean_ratio fraction of frames the flusher tries to keep clean
+   * @param interval how long the flusher sleeps between rounds
+   */
+  virtual void RunFlusherThread(double target_clean_ratio, std::chrono::milliseconds interval);
+
+  /** Stops and joins the background flusher thread, if it is running. */
+  virtual void StopFlusherThread();
+
+  /**
+   * Runs one round of the background flusher: if fewer than target_clean_ratio of the frames are clean, writes enough
+   * dirty, unpinned pages to get there, in page id order. The pool latch is not held during the writes.
+   * @param target_clean_ratio fraction of frames to keep clean
+   * @return the number of pages written
+   */
+  virtual size_t WriteBackDirtyPages(double target_clean_ratio);
+
+  /** @return the number of pages evicted to make room for another page */
+  virtual size_t GetNumEvictions() { return num_evictions_; }
+
+  /** @return the number of evictions that had to write a dirty page on the caller's thread */
+  virtual size_t GetNumDirtyEvictions() { return num_dirty_evictions_; }
+
+  /** @return the number of pages written by the background flusher */
+  virtual size_t GetNumBackgroundWrites() { return num_background_writes_; }
+
+  /**
+   * Asks for pages to be read into the pool ahead of use. A background thread loads them into free or victim frames
+   * without pinning them, so they are evicted like any other unpinned page. Pages that are already in the pool, or
+   * that cannot get a frame without waiting, are skipped.
+   * @param first_page_id id of the first page to read
+   * @param num_pages number of consecutive page ids to read
+   * @param owner who asks for the pages, so that CancelPrefetches() can tell its requests apart, nullptr for nobody
+   */
+  virtual void Prefetch(page_id_t first_page_id, size_t num_pages, const void *owner = nullptr);
+
+  /** @return the number of pages loaded by Prefetch() */
+  virtual size_t GetNumPrefetches() { return num_prefetches_; }
+
+  /** Blocks until every page handed to Prefetch() so far has been loaded or skipped. */
+  virtual void WaitForPrefetches();
+
+  /**
+   * Drops the pages an owner handed to Prefetch() that the prefetch thread has not started on, and blocks while it is
+   * still loading a batch with pages of that owner. Requests of other owners are left alone.
+   * @param owner the owner passed to Prefetch()
+   */
+  virtual void CancelPrefetches(const void *owner);
+
  protected:
+  /**
+   * Creates a BufferPoolManager that owns no frames itself, for pools that delegate to other instances.
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager
+   */
+  BufferPoolManager(DiskManager *disk_manager, LogManager *log_manager);
+
   /**
    * Grading function. Do not modify!
    * Invokes the callback function if it is not null.
@@ -113,10 +201,14 @@ class BufferPoolManager {
 
   /**
    * Fetch the requested page from the buffer pool.
+   *
+   * On a miss the frame is reserved and marked as having I/O in progress, and latch_ is released while the victim is
+   * written back and the requested page is read, so hits on other pages are not blocked by the disk. Other fetchers of
+   * the same page pin the reserved frame and wait on its condition variable instead of reading the page again.
    * @param page_id id of page to be fetched
    * @return the requested page
    */
-  Page *FetchPageImpl(page_id_t page_id);
+  virtual Page *FetchPageImpl(page_id_t page_id);
 
   /**
    * Unpin the target page from the buffer pool.
@@ -124,38 +216,90 @@ class BufferPoolManager {
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @return false if the page pin count is <= 0 before this call, true otherwise
    */
-  bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
+  virtual bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
 
   /**
    * Flushes the target page to disk.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  bool FlushPageImpl(page_id_t page_id);
+  virtual bool FlushPageImpl(page_id_t page_id);
 
   /**
    * Creates a new page in the buffer pool.
    * @param[out] page_id id of created page
+   * @param hint page to allocate the new one close to, see NewPageNear()
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  Page *NewPageImpl(page_id_t *page_id);
+  virtual Page *NewPageImpl(page_id_t *page_id, page_id_t hint = INVALID_PAGE_ID);
 
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  bool DeletePageImpl(page_id_t page_id);
+  virtual bool DeletePageImpl(page_id_t page_id);
 
   /**
    * Flushes all the pages in the buffer pool to disk.
    */
-  void FlushAllPagesImpl();
+  virtual void FlushAllPagesImpl();
+
+  /**
+   * Creates a page with an id that was already allocated on disk by the caller.
+   * @param page_id id of the page to create
+   * @return nullptr if all frames are pinned, otherwise pointer to the new page
+   */
+  Page *NewPageWithId(page_id_t page_id);
+
+  /** @return whether a frame is free or can be evicted, so that a new page would fit right now */
+  bool HasFreeFrame();
+
+  /**
+   * Places a fresh, zeroed page in a free or victim frame.
+   * @param newid id of the page to place
+   * @param lock the caller's lock on latch_
+   * @return pointer to the pinned page, nullptr if every frame is pinned
+   */
+  Page *InstallNewPage(page_id_t newid, std::unique_lock<std::mutex> *lock);
+
+  /**
+   * Takes a frame from the free list, or else a victim from the replacer and removes its page from the page table.
+   * Victims the flusher is still writing are skipped and stay in the replacer.
+   * @param[out] frame_num the acquired frame
+   * @param[out] dirty_page_id id of the victim page if it still has to be written back, INVALID_PAGE_ID otherwise
+   * @param[out] busy_frame if no frame was acquired only because the flusher is writing them or a read-ahead is still
+   * reading into them, one of those frames
+   * @return false if no frame could be acquired
+   */
+  bool AcquireFrame(frame_id_t *frame_num, page_id_t *dirty_page_id, frame_id_t *busy_frame);
+
+  /**
+   * Reads a page into a frame that was reserved for it with io_in_progress_ set, writing back the dirty victim first.
+   * latch_ is released for the I/O and held again on return, with io_in_progress_ cleared; the caller notifies waiters.
+   * @param lock the caller's lock on latch_
+   * @param frame_num the reserved frame, its page_id_ is the page to read
+   * @param dirty_page_id id of the victim page to write back, INVALID_PAGE_ID if none
+   */
+  void LoadFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_num, page_id_t dirty_page_id);
+
+  /**
+   * Loads pages for Prefetch() with their reads in flight together. Pages already in the pool are skipped, and the
+   * batch is cut short once no frame is available.
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids);
+
+  /** Stops and joins the prefetch thread, if it was started. */
+  void StopPrefetchThread();
 
   /** Number of pages in the buffer pool. */
   size_t pool_size_;
   /** Array of buffer pool pages. */
   Page *pages_;
+  /** Page-aligned memory holding the data of every frame, mapped by the constructor. */
+  char *frames_{nullptr};
+  /** Size of the mapping at frames_. */
+  size_t frames_size_{0};
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. */
@@ -166,7 +310,43 @@ class BufferPoolManager {
   Replacer *replacer_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** Pages whose dirty contents are being written back by an eviction, mapped to the frame doing the write. */
+  std::unordered_map<page_id_t, frame_id_t> evicting_;
+  /** One condition variable per frame, signalled when I/O on that frame finishes. Waited on with latch_ held. */
+  std::condition_variable *io_cv_;
+  /** This latch protects page_table_, free_list_, evicting_ and the metadata of every frame in pages_. */
   std::mutex latch_;
+  /** Number of pages evicted, see GetNumEvictions(). */
+  std::atomic<size_t> num_evictions_{0};
+  /** Number of evictions that wrote a dirty page, see GetNumDirtyEvictions(). */
+  std::atomic<size_t> num_dirty_evictions_{0};
+  /** Number of pages written by the flusher, see GetNumBackgroundWrites(). */
+  std::atomic<size_t> num_background_writes_{0};
+  /** Background flusher thread, nullptr if it is not running. */
+  std::thread *flusher_thread_{nullptr};
+  /** Tells the flusher thread to keep going. */
+  bool flusher_running_{false};
+  /** Protects flusher_thread_ and flusher_running_. */
+  std::mutex flusher_latch_;
+  /** Wakes the flusher thread early. */
+  std::condition_variable flusher_cv_;
+  /** Number of pages loaded by the prefetch thread, see GetNumPrefetches(). */
+  std::atomic<size_t> num_prefetches_{0};
+  /** Prefetch thread, started by the first Prefetch() call. */
+  std::thread *prefetch_thread_{nullptr};
+  /** Tells the prefetch thread to keep going. */
+  bool prefetch_running_{false};
+  /** Page ids waiting to be prefetched, with the owner that asked for each. */
+  std::deque<std::pair<page_id_t, const void *>> prefetch_queue_;
+  /** True while the prefetch thread is loading a batch taken off prefetch_queue_. */
+  bool prefetch_busy_{false};
+  /** The owners of the pages in the batch the prefetch thread is loading. */
+  std::vector<const void *> prefetch_busy_owners_;
+  /** Protects prefetch_thread_, prefetch_running_, prefetch_queue_, prefetch_busy_ and prefetch_busy_owners_. */
+  std::mutex prefetch_latch_;
+  /** Wakes the prefetch thread when work arrives. */
+  std::condition_variable prefetch_cv_;
+  /** Wakes WaitForPrefetches() and CancelPrefetches() once the prefetch thread is done with a batch. */
+  std::condition_variable prefetch_idle_cv_;
 };
 }  // namespace bustub
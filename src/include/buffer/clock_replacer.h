@@ -12,8 +12,7 @@
 
 #pragma once
 
-#include <list>
-#include <mutex>  // NOLINT
+#include <atomic>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -23,6 +22,9 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Every frame has one atomic state word, so Pin and Unpin are a single atomic operation on that frame and Victim
+ * sweeps the clock hand without taking a lock. No allocation happens after construction.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -46,7 +48,21 @@ class ClockReplacer : public Replacer {
   size_t Size() override;
 
  private:
-  // TODO(student): implement me!
+  /** Frame is not in the replacer, i.e. it is pinned or was never unpinned. */
+  static constexpr uint8_t NOT_IN_REPLACER = 0;
+  /** Frame is in the replacer and its reference bit is clear, it is the next victim the hand reaches. */
+  static constexpr uint8_t UNREFERENCED = 1;
+  /** Frame is in the replacer and its reference bit is set, the hand clears it once before evicting. */
+  static constexpr uint8_t REFERENCED = 2;
+
+  /** Number of frames the replacer can hold. */
+  size_t num_pages_;
+  /** State of every frame, indexed by frame id. */
+  std::vector<std::atomic<uint8_t>> states_;
+  /** Ever-increasing clock hand, the frame it points to is hand_ % num_pages_. */
+  std::atomic<uint64_t> hand_{0};
+  /** Number of frames in the replacer. */
+  std::atomic<size_t> size_{0};
 };
 
 }  // namespace bustub
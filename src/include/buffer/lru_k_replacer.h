@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <list>
+#include <mutex>  // NOLINT
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The victim is the evictable frame with the largest backward K-distance, i.e. the time since its page's K-th most
+ * recent access. A page with fewer than K recorded accesses has an infinite distance, and ties among those are broken
+ * by their oldest access, so pages touched once by a scan are evicted before pages that are used repeatedly.
+ *
+ * Evictable frames are kept ordered by their distance, so picking a victim takes logarithmic time.
+ *
+ * The access history of an evicted page is kept, up to history_cap pages, so a page that is read again soon after its
+ * eviction is recognized as hot.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of accesses remembered per page
+   * @param history_cap the maximum number of evicted pages whose history is kept
+   */
+  LRUKReplacer(size_t num_pages, size_t k, size_t history_cap);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  size_t Size() override;
+
+ private:
+  /** History of an evicted page and its position in retained_order_. */
+  struct RetainedHistory {
+    std::deque<uint64_t> accesses_;
+    std::list<page_id_t>::iterator pos_;
+  };
+
+  /** An evictable frame ordered by the access its distance is measured from, the oldest first. */
+  using FrameOrder = std::pair<uint64_t, frame_id_t>;
+
+  /** @return the set of evictable frames that frame_id belongs in for its current history */
+  std::set<FrameOrder> *OrderedFrames(frame_id_t frame_id);
+
+  /** @return the position of frame_id in its set of evictable frames */
+  FrameOrder Order(frame_id_t frame_id) const;
+
+  /** Moves the history of the page held by frame_id into retained_, dropping the oldest one if over the cap. */
+  void RetainHistory(frame_id_t frame_id);
+
+  size_t k_;
+  size_t history_cap_;
+  /** Logical clock, advanced on every recorded access. */
+  uint64_t current_timestamp_{0};
+  /** Page held by each frame, INVALID_PAGE_ID if no access was recorded since it was last victimized. */
+  std::vector<page_id_t> frame_pages_;
+  /** Last (up to) K access timestamps of the page held by each frame, oldest first. */
+  std::vector<std::deque<uint64_t>> frame_accesses_;
+  /** Whether each frame can be victimized. */
+  std::vector<bool> evictable_;
+  size_t evictable_count_{0};
+  /** Evictable frames with fewer than K accesses, ordered by their oldest access; they are victimized first. */
+  std::set<FrameOrder> infinite_frames_;
+  /** Evictable frames with K accesses, ordered by their K-th most recent access. */
+  std::set<FrameOrder> finite_frames_;
+  /** Access histories of evicted pages. */
+  std::unordered_map<page_id_t, RetainedHistory> retained_;
+  /** Evicted pages in the order they were evicted, the oldest history is dropped first. */
+  std::list<page_id_t> retained_order_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool into several independent BufferPoolManager instances. A page
+ * always lives in the instance chosen by page_id % num_instances, so each instance has its own page table, free list,
+ * replacer and latch, and requests for pages in different instances never contend with each other.
+ *
+ * Since it is a BufferPoolManager itself, it can be handed to anything that takes a BufferPoolManager *.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManager instances
+   * @param pool_size the pool size of each instance
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of every instance
+   * @param use_huge_pages back the frames of every instance with huge pages
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU,
+                            bool use_huge_pages = false);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @return the number of instances the pool is sharded into */
+  size_t GetNumInstances() const { return instances_.size(); }
+
+  /**
+   * @param page_id id of a page
+   * @return the instance responsible for page_id
+   */
+  BufferPoolManager *GetBufferPoolManager(page_id_t page_id);
+
+  /** Starts one background flusher per instance. */
+  void RunFlusherThread(double target_clean_ratio, std::chrono::milliseconds interval) override;
+
+  void StopFlusherThread() override;
+
+  size_t WriteBackDirtyPages(double target_clean_ratio) override;
+
+  /** @return the number of evictions summed over all instances */
+  size_t GetNumEvictions() override;
+
+  /** @return the number of dirty evictions summed over all instances */
+  size_t GetNumDirtyEvictions() override;
+
+  /** @return the number of background writes summed over all instances */
+  size_t GetNumBackgroundWrites() override;
+
+  /** Hands every page of the range to the instance it maps to. */
+  void Prefetch(page_id_t first_page_id, size_t num_pages, const void *owner = nullptr) override;
+
+  /** @return the number of prefetched pages summed over all instances */
+  size_t GetNumPrefetches() override;
+
+  /** Waits for the prefetches of every instance. */
+  void WaitForPrefetches() override;
+
+  /** Cancels the prefetches of the owner in every instance. */
+  void CancelPrefetches(const void *owner) override;
+
+ protected:
+  Page *FetchPageImpl(page_id_t page_id) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  /**
+   * Creates a new page. The page id is taken from the disk manager and the page is placed in the instance it maps to;
+   * if that instance is full, the id is given back and the disk manager is asked for an id of the next instance that
+   * has a free frame.
+   * @param[out] page_id id of created page
+   * @param hint page to allocate the new one close to
+   * @return nullptr if no instance could create a page, otherwise pointer to new page
+   */
+  Page *NewPageImpl(page_id_t *page_id, page_id_t hint = INVALID_PAGE_ID) override;
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  void FlushAllPagesImpl() override;
+
+ private:
+  /** The individual buffer pool instances. */
+  std::vector<std::unique_ptr<BufferPoolManager>> instances_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.h
+//
+// Identification: src/include/buffer/read_ahead.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * ReadAhead issues BufferPoolManager::Prefetch() requests for a scan that walks a chain of pages, such as a table heap
+ * or the leaf level of a B+ tree.
+ *
+ * The known successor of the current page is always requested. While the chain keeps running through consecutive
+ * page ids the window doubles, up to READ_AHEAD_MAX_PAGES or a quarter of the pool, and the pages after the successor
+ * are requested as well. A jump to a non-consecutive page shrinks the window back to one page.
+ */
+class ReadAhead {
+ public:
+  /**
+   * @param buffer_pool_manager the pool to prefetch into, nullptr disables read-ahead
+   */
+  explicit ReadAhead(BufferPoolManager *buffer_pool_manager);
+
+  /**
+   * Drops the pages this read-ahead requested that are not being read yet, and waits for those that are, so no
+   * prefetch I/O for a finished scan is still running when its caller goes on to tear down the buffer pool or disk
+   * manager. Prefetches of other scans are not waited for.
+   */
+  ~ReadAhead();
+
+  DISALLOW_COPY_AND_MOVE(ReadAhead);
+
+  /**
+   * Starts over, for a scan of its own. The pages requested so far are dropped as by the destructor, since this
+   * read-ahead is what identifies them to the buffer pool manager.
+   * @param buffer_pool_manager the pool to prefetch into, nullptr disables read-ahead
+   */
+  void Reset(BufferPoolManager *buffer_pool_manager);
+
+  /** @return the pool the read-ahead prefetches into, nullptr if it is disabled */
+  BufferPoolManager *GetBufferPoolManager() const { return buffer_pool_manager_; }
+
+  /**
+   * Tells the read-ahead that the scan moved onto a page.
+   * @param page_id the page the scan is on now
+   * @param next_page_id the page after it in the chain, INVALID_PAGE_ID at the end
+   */
+  void OnPage(page_id_t page_id, page_id_t next_page_id);
+
+  /** @return the current window in pages */
+  size_t GetWindow() const { return window_; }
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  size_t max_window_;
+  size_t window_{1};
+  /** Last page the scan was on. */
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  /** True once this read-ahead has requested any page. */
+  bool requested_{false};
+  /** Pages below this id, from the current run, have already been requested. */
+  page_id_t prefetched_end_{INVALID_PAGE_ID};
+};
+
+}  // namespace bustub
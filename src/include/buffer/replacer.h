@@ -43,6 +43,13 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Records an access to the page held by a frame. Policies that only look at pin order ignore it.
+   * @param frame_id the id of the accessed frame
+   * @param page_id the id of the page the frame holds
+   */
+  virtual void RecordAccess(frame_id_t frame_id, page_id_t page_id) {}
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
@@ -112,21 +112,31 @@ class Catalog {
    * @param key_schema the schema of the key
    * @param key_attrs key attributes
    * @param keysize size of the key
+   * @param unique whether a key indexes one tuple at most; a non-unique index keeps every tuple of a key
    * @return a pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
-                         size_t keysize) {
+                         size_t keysize, bool unique = true) {
     index_oid_t index_oid = next_index_oid_++;
-    auto indexMetadata = new IndexMetadata(index_name, table_name, &schema, key_attrs);
-    std::unique_ptr<Index> bPlusTree_index_unique(
-        new BPlusTreeIndex<KeyType, ValueType, KeyComparator>(indexMetadata, bpm_));
-    // add index for each tuple in BPlusTree
+    auto indexMetadata = new IndexMetadata(index_name, table_name, &schema, key_attrs, unique);
+    auto *bPlusTree_index = new BPlusTreeIndex<KeyType, ValueType, KeyComparator>(indexMetadata, bpm_);
+    std::unique_ptr<Index> bPlusTree_index_unique(bPlusTree_index);
+    // sort the keys of all tuples and build the BPlusTree bottom up
     TableHeap *table_heap = GetTable(table_name)->table_.get();
-    for (auto itor = table_heap->Begin(txn); itor != table_heap->End(); itor++) {
-      bPlusTree_index_unique->InsertEntry(itor->KeyFromTuple(schema, key_schema, key_attrs), itor->GetRid(), txn);
-    }
+    auto itor = table_heap->Begin(txn);
+    bPlusTree_index->BulkLoad(
+        [&](Tuple *key, RID *rid) {
+          if (itor == table_heap->End()) {
+            return false;
+          }
+          *key = itor->KeyFromTuple(schema, key_schema, key_attrs);
+          *rid = itor->GetRid();
+          ++itor;
+          return true;
+        },
+        txn);
     // insert into the hash
     IndexInfo *newIndex =
         new IndexInfo(key_schema, index_name, std::move(bPlusTree_index_unique), index_oid, table_name, keysize);
@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
 namespace bustub {
@@ -35,6 +36,19 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int LRUK_REPLACER_K = 2;          // lookback window for lru-k replacer
+static constexpr int READ_AHEAD_MAX_PAGES = 32;    // largest read-ahead window of a sequential scan
+static constexpr int ASYNC_IO_QUEUE_DEPTH = 64;    // most asynchronous page I/Os in flight per disk manager
+static constexpr int ASYNC_IO_WORKERS = 4;         // threads serving asynchronous I/O when io_uring is unavailable
+static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;  // size of an explicit huge page backing buffer pool frames
+static constexpr int OPTIMISTIC_READ_RETRIES = 8;  // restarts of a latch-free index lookup before it takes latches
+static constexpr double INDEX_FILL_FACTOR = 0.9;   // share of a page a bulk loaded index node is filled to
+static constexpr int INDEX_BUILD_SORT_PAGES = 64;  // pages of entries an index build sorts in memory before spilling
+static constexpr int INDEX_FETCH_BATCH_SIZE = 256;  // rids an index scan or join collects before fetching by page
+static constexpr int TUPLE_BATCH_SIZE = 1024;       // rows a batch passed between executors holds at most
+static constexpr int HASH_JOIN_MEMORY_PAGES = 256;  // pages of tuples a hash join builds in memory before spilling
+static constexpr int NESTED_LOOP_JOIN_BLOCK_PAGES = 64;  // outer tuple pages a nested loop join holds per inner scan
+static constexpr int SORT_MEMORY_PAGES = 256;  // pages of tuples a sort holds in memory before writing sorted runs
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
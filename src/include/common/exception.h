@@ -50,6 +50,8 @@ enum class ExceptionType {
   // can not get this tuple by rid
   TUPLE_ERROR = 12,
   CHILD_EXE_FAIL = 13,
+  /** Failed read or write of a file. */
+  IO = 14,
 };
 
 class Exception : public std::runtime_error {
@@ -88,6 +90,8 @@ class Exception : public std::runtime_error {
         return "Out of Memory";
       case ExceptionType::NOT_IMPLEMENTED:
         return "Not implemented";
+      case ExceptionType::IO:
+        return "I/O";
       default:
         return "Unknown";
     }
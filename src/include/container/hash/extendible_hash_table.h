@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of extendible hash table that is backed by a buffer pool
+ * manager. Non-unique keys are supported. Supports insert and delete. The
+ * table grows one bucket at a time: a full bucket splits in two, and only
+ * when its local depth has caught up with the global depth does the
+ * directory double, copying its own slots. An emptied bucket merges back
+ * into its split image, and the directory halves once no bucket needs its
+ * last bit. A full bucket that cannot split, its local depth at
+ * HashTableDirectoryPage::MAX_DEPTH, chains overflow pages instead, so that
+ * any number of duplicates of a key fit.
+ *
+ * Lookups, inserts and removes latch the table shared and the one bucket page
+ * they touch; splits and merges latch the table exclusively, for as long as it
+ * takes to move a single bucket.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new ExtendibleHashTable, of a single bucket
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair is in the table already
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth();
+
+  /**
+   * Asserts that the directory is consistent.
+   */
+  void VerifyIntegrity();
+
+ private:
+  using BucketPage = HashTableBucketPage<KeyType, ValueType, KeyComparator>;
+
+  /** @return the 32 bits of the hash of key the directory picks buckets by */
+  uint32_t Hash(const KeyType &key);
+
+  Page *FetchPage(page_id_t page_id);
+
+  /** Splits the bucket key goes to until the pair fits, under the exclusive table latch. */
+  bool SplitInsert(const KeyType &key, const ValueType &value);
+
+  /**
+   * Inserts a pair into the first page of the chain of a bucket with room for it, appending an overflow page if none
+   * has, under the exclusive table latch.
+   * @return false if the chain holds the pair already
+   */
+  bool OverflowInsert(page_id_t bucket_page_id, const KeyType &key, const ValueType &value);
+
+  /** Unlinks and deletes the empty pages of the chain of a bucket, under the exclusive table latch. */
+  void DropEmptyOverflowPages(page_id_t bucket_page_id);
+
+  /** Merges the bucket key goes to with its split image while one of the two is empty. */
+  void Merge(const KeyType &key);
+
+  // member variable
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers includes inserts and removes, writers are splits and merges
+  ReaderWriterLatch table_latch_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
 #include <vector>
@@ -32,6 +33,14 @@ namespace bustub {
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Buckets are spread over block pages, the header page listing them in order.
+ * Lookups latch one block at a time for reading, inserts and removes for
+ * writing; removed pairs leave tombstones behind that later inserts reuse.
+ * The table doubles once three quarters of its buckets are occupied (by
+ * pairs or tombstones), or when an insert finds no bucket left. Resize keeps
+ * inserts and removes out while it copies the pairs into new pages, but not
+ * lookups, which go on reading the old pages until the new ones replace them.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
@@ -87,6 +96,33 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   size_t GetSize();
 
  private:
+  using BlockPage = HashTableBlockPage<KeyType, ValueType, KeyComparator>;
+
+  enum class InsertResult { INSERTED, DUPLICATE, FULL, RETRY };
+
+  Page *FetchPage(page_id_t page_id);
+
+  /**
+   * Creates the header and block pages of a table of at least num_buckets
+   * buckets, as many as a header page can list at most.
+   * @return the page id of the header page
+   */
+  page_id_t NewTable(size_t num_buckets);
+
+  /**
+   * Visits the buckets from the one key hashes to on, latching each block
+   * while visiting it, until visit returns true or a bucket that was never
+   * occupied has been visited.
+   * @param exclusive whether to write latch blocks, rather than read latch them
+   * @param visit called as visit(block, slot, bucket) for every bucket
+   * @return whether visit returned true
+   */
+  template <typename Visitor>
+  bool Probe(HashTableHeaderPage *header, const KeyType &key, bool exclusive, Visitor &&visit);
+
+  /** Inserts into the table under the table latch. @param[out] size the number of buckets it has */
+  InsertResult TryInsert(const KeyType &key, const ValueType &value, size_t *size);
+
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
@@ -95,6 +131,12 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   // Readers includes inserts and removes, writer is only resize
   ReaderWriterLatch table_latch_;
 
+  // Readers are lookups, writer is resize while it replaces the pages of the table
+  ReaderWriterLatch header_latch_;
+
+  // Buckets holding a pair or a tombstone
+  std::atomic<size_t> num_occupied_{0};
+
   // Hash function
   HashFunction<KeyType> hash_fn_;
 };
@@ -37,13 +37,14 @@ class ExecutionEngine {
     // prepare
     executor->Init();
 
-    // execute
+    // execute, a batch at a time
     try {
-      Tuple tuple;
-      RID rid;
-      while (executor->Next(&tuple, &rid)) {
+      TupleBatch batch;
+      while (executor->NextBatch(&batch)) {
         if (result_set != nullptr) {
-          result_set->push_back(tuple);
+          for (size_t row = 0; row < batch.NumRows(); row++) {
+            result_set->push_back(batch.GetTuple(row, executor->GetOutputSchema()));
+          }
         }
       }
     } catch (Exception &e) {
@@ -13,11 +13,14 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 /**
- * AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * AbstractExecutor implements the Volcano tuple-at-a-time iterator model, and its batch-at-a-time counterpart:
+ * NextBatch() hands over up to a batch of rows, column by column, in one call. Executors that do not produce batches
+ * of their own get them from Next(), so that every executor can be the child of one that consumes batches.
  */
 class AbstractExecutor {
  public:
@@ -44,6 +47,22 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Produces the next batch of tuples from this executor. Next() and NextBatch() take from the same rows, a caller
+   * uses one or the other.
+   * @param[out] batch the next tuples produced by this executor, at least one, in the columns of the output schema
+   * @return true if a batch was produced, false if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    batch->Reset(GetOutputSchema());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->AppendTuple(tuple, GetOutputSchema(), rid);
+    }
+    return !batch->IsEmpty();
+  }
+
   /** @return the schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
@@ -51,6 +70,26 @@ class AbstractExecutor {
   ExecutorContext *GetExecutorContext() { return exec_ctx_; }
 
  protected:
+  /**
+   * Reads the next tuple of a child a batch at a time, for executors that consume their children tuple by tuple.
+   * @param child the child executor to read from
+   * @param batch the batch of the child being read, empty to start with
+   * @param row the next row of the batch to be read
+   * @param[out] tuple the next tuple of the child
+   * @return false once the child is exhausted
+   */
+  static bool NextChildTuple(AbstractExecutor *child, TupleBatch *batch, size_t *row, Tuple *tuple) {
+    while (*row >= batch->NumRows()) {
+      *row = 0;
+      if (!child->NextBatch(batch)) {
+        batch->Reset(nullptr);
+        return false;
+      }
+    }
+    *tuple = batch->GetTuple((*row)++, child->GetOutputSchema());
+    return true;
+  }
+
   ExecutorContext *exec_ctx_;
 };
 }  // namespace bustub
@@ -70,24 +70,29 @@ class SimpleAggregationHashTable {
   /** Combines the input into the aggregation result. */
   void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
     for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
-      switch (agg_types_[i]) {
-        case AggregationType::CountAggregate:
-          // Count increases by one.
-          result->aggregates_[i] = result->aggregates_[i].Add(ValueFactory::GetIntegerValue(1));
-          break;
-        case AggregationType::SumAggregate:
-          // Sum increases by addition.
-          result->aggregates_[i] = result->aggregates_[i].Add(input.aggregates_[i]);
-          break;
-        case AggregationType::MinAggregate:
-          // Min is just the min.
-          result->aggregates_[i] = result->aggregates_[i].Min(input.aggregates_[i]);
-          break;
-        case AggregationType::MaxAggregate:
-          // Max is just the max.
-          result->aggregates_[i] = result->aggregates_[i].Max(input.aggregates_[i]);
-          break;
-      }
+      CombineAggregateValue(&result->aggregates_[i], agg_types_[i], input.aggregates_[i]);
+    }
+  }
+
+  /** Combines the input into the result of one aggregate. */
+  static void CombineAggregateValue(Value *result, AggregationType agg_type, const Value &input) {
+    switch (agg_type) {
+      case AggregationType::CountAggregate:
+        // Count increases by one.
+        *result = result->Add(ValueFactory::GetIntegerValue(1));
+        break;
+      case AggregationType::SumAggregate:
+        // Sum increases by addition.
+        *result = result->Add(input);
+        break;
+      case AggregationType::MinAggregate:
+        // Min is just the min.
+        *result = result->Min(input);
+        break;
+      case AggregationType::MaxAggregate:
+        // Max is just the max.
+        *result = result->Max(input);
+        break;
     }
   }
 
@@ -103,6 +108,29 @@ class SimpleAggregationHashTable {
     CombineAggregateValues(&ht[agg_key], agg_val);
   }
 
+  /**
+   * Inserts a batch of rows into the hash table, combining each with the current aggregation of its group.
+   * @param group_bys the values of each group by term, one a row
+   * @param aggregates the values of each aggregate expression, one a row
+   * @param num_rows the number of rows
+   */
+  void InsertCombineBatch(const std::vector<std::vector<Value>> &group_bys,
+                          const std::vector<std::vector<Value>> &aggregates, size_t num_rows) {
+    AggregateKey agg_key{std::vector<Value>(group_bys.size())};
+    for (size_t row = 0; row < num_rows; row++) {
+      for (size_t i = 0; i < group_bys.size(); i++) {
+        agg_key.group_bys_[i] = group_bys[i][row];
+      }
+      auto it = ht.find(agg_key);
+      if (it == ht.end()) {
+        it = ht.emplace(agg_key, GenerateInitialAggregateValue()).first;
+      }
+      for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+        CombineAggregateValue(&it->second.aggregates_[i], agg_types_[i], aggregates[i][row]);
+      }
+    }
+  }
+
   /**
    * An iterator through the simplified aggregation hash table.
    */
@@ -172,6 +200,9 @@ class AggregationExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /** Emits the groups that pass the having clause, a batch at a time. */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return the tuple as an AggregateKey */
   AggregateKey MakeKey(const Tuple *tuple) {
     std::vector<Value> keys;
@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.h
+//
+// Identification: src/include/execution/executors/hash_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/hash_join_plan.h"
+#include "storage/table/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * HashJoinExecutor joins the tuples of two children whose join keys are equal.
+ *
+ * Both children are read in turn until one of them runs out within the memory budget of the plan. That smaller side
+ * is built into an in-memory hash table, and the other side probes it tuple by tuple, the tuples read of it so far
+ * first, so each side holds at most the budget in memory meanwhile. When both sides outgrow the budget, they are
+ * grace hash joined instead: both are partitioned on the hash of their keys into TmpTupleRun pages of the buffer
+ * pool, and every pair of partitions is joined on its own, building on whichever of the two is smaller. A pair whose
+ * smaller partition still exceeds the budget is partitioned again, with another hash, up to MAX_PARTITION_LEVEL times.
+ */
+class HashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new hash join executor.
+   * @param exec_ctx the executor context
+   * @param plan the hash join plan to be executed
+   * @param left_executor the child executor that produces tuples for the left side of the join
+   * @param right_executor the child executor that produces tuples for the right side of the join
+   */
+  HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                   std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** Fills the batch with joined tuples, evaluating the output columns straight into it. */
+  bool NextBatch(TupleBatch *batch) override;
+
+ private:
+  using Partitions = std::vector<std::unique_ptr<TmpTupleRun>>;
+
+  /** Partitioning levels after the first, each with another hash, before a pair is joined whatever its size. */
+  static constexpr int MAX_PARTITION_LEVEL = 3;
+
+  /** A pair of partitions still to be joined, and the level they were partitioned at. */
+  struct PartitionPair {
+    std::unique_ptr<TmpTupleRun> left_;
+    std::unique_ptr<TmpTupleRun> right_;
+    int level_;
+  };
+
+  /** @return the join key of a tuple of the left or the right side */
+  HashJoinKey MakeKey(const Tuple &tuple, bool left) const;
+
+  /** Reads the next tuple of the left or the right child. @return false once the child is exhausted */
+  bool NextSideTuple(bool left, Tuple *tuple);
+
+  /**
+   * Reads the next tuple of the left or the right child whose key is not null into tuples, adding up its bytes.
+   * @return false once the child is exhausted
+   */
+  bool BufferTuple(bool left, std::vector<Tuple> *tuples, size_t *bytes);
+
+  /** @return the partition a key goes to at a partitioning level */
+  size_t PartitionOf(const HashJoinKey &key, int level) const;
+
+  /** @return new empty partitions, one for every partition a level fans out to */
+  Partitions NewPartitions();
+
+  /** Partitions the tuples read of the left or the right side at the first level, then the rest of its child. */
+  void PartitionSide(bool left, std::vector<Tuple> *tuples, Partitions *partitions);
+
+  /** Reads a partition of the left or the right side back and partitions its tuples at a level, then finishes them. */
+  void Repartition(TmpTupleRun *partition, bool left, int level, Partitions *partitions) const;
+
+  /** Queues the pairs of partitions of both sides to be joined, dropping those with an empty side. */
+  void AddPairs(Partitions *left, Partitions *right, int level);
+
+  /** Reads the next tuple to probe the hash table with. @return false once the probe side is exhausted */
+  bool NextProbeTuple(Tuple *tuple);
+
+  /**
+   * Builds the hash table of the next pair of partitions that is small enough, partitioning the others again.
+   * @return false once no pair is left
+   */
+  bool LoadNextPair();
+
+  /**
+   * Finds the next pair of matching tuples.
+   * @param[out] left the tuple of the left side
+   * @param[out] right the tuple of the right side
+   * @return false once the join is done
+   */
+  bool NextMatch(const Tuple **left, const Tuple **right);
+
+  /** The hash join plan node to be executed. */
+  const HashJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /** The bytes of tuples the hash table is built from at most, unless partitioning gave up. */
+  size_t memory_bytes_;
+  /** The number of partitions a partitioning level fans out to. */
+  size_t num_partitions_;
+
+  /** Whether neither side fit in memory, and the join runs over pairs of partitions. */
+  bool spilled_{false};
+  /** The hash table on the build side, the smaller one of the children or of the pair of partitions being joined. */
+  std::unordered_multimap<HashJoinKey, Tuple> table_;
+  bool build_left_{true};
+  /** The pairs of partitions still to be joined; empty while the join runs in memory. */
+  std::vector<PartitionPair> pairs_;
+  /** The partition being probed with, nullptr while the probe child probes the in-memory hash table. */
+  std::unique_ptr<TmpTupleRun> probe_partition_;
+  /** The tuples of the page of the partition, or of the probe child read before the build side was known. */
+  std::vector<Tuple> probe_tuples_;
+  size_t probe_pos_{0};
+  TupleBatch left_batch_;
+  size_t left_row_{0};
+  TupleBatch right_batch_;
+  size_t right_row_{0};
+  /** The tuple being probed with, and the build tuples with its key not yet looked at. */
+  Tuple probe_tuple_;
+  std::unordered_multimap<HashJoinKey, Tuple>::const_iterator match_;
+  std::unordered_multimap<HashJoinKey, Tuple>::const_iterator match_end_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "common/rid.h"
@@ -24,6 +26,13 @@ namespace bustub {
 
 /**
  * IndexScanExecutor executes an index scan over a table.
+ *
+ * The scan covers the range of the first key column the plan bounds, or else the range the predicate bounds it to: it
+ * seeks to the lower bound and stops past the upper bound. The predicate still filters every tuple in the range.
+ *
+ * Tuples are fetched in batches of INDEX_FETCH_BATCH_SIZE rids, each page of a batch once, so an index whose order
+ * has little to do with the order of the table does not fetch a page per tuple. Unless the plan keeps index order, a
+ * batch comes out in the order its tuples are stored in.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -45,11 +54,25 @@ class IndexScanExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /** Fetches the tuples of the next batch of rids in range. @return false once the range is exhausted */
+  bool FetchBatch();
+
+  /** @return the first column of the index key, as held by the key the iterator is at */
+  Value LeadingKeyValue();
+
+  /** @return whether value, of the first key column, is past the bound: below a lower, above an upper bound */
+  static bool PastBound(const Value &value, const IndexScanBound &bound, bool upper);
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
   TableMetadata *table_info;
   IndexInfo *index_info;
   TableHeap *table_heap;
   IndexIterator_TYPE itor;
+  std::optional<IndexScanBound> lower_bound_;
+  std::optional<IndexScanBound> upper_bound_;
+  std::vector<RID> batch_rids_;
+  std::vector<std::pair<size_t, Tuple>> batch_;
+  size_t batch_offset_{0};
 };
 }  // namespace bustub
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.h
+//
+// Identification: src/include/execution/executors/merge_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * MergeJoinExecutor joins two children that produce their tuples in ascending order of their join keys.
+ *
+ * Both children are read once, side by side, always advancing the one with the smaller key. When the keys are equal,
+ * the right tuples with that key are held in memory and joined with every left tuple with the key, so memory is bound
+ * by the longest run of equal right keys rather than by the input. Tuples with a null key join with nothing.
+ */
+class MergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new merge join executor.
+   * @param exec_ctx the executor context
+   * @param plan the merge join plan to be executed
+   * @param left_executor the child executor that produces tuples for the left side of the join
+   * @param right_executor the child executor that produces tuples for the right side of the join
+   */
+  MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                    std::unique_ptr<AbstractExecutor> &&left_executor,
+                    std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** Fills the batch with joined tuples, evaluating the output columns straight into it. */
+  bool NextBatch(TupleBatch *batch) override;
+
+ private:
+  /** @return the join key of a tuple of the left or the right side */
+  SortKey MakeKey(const Tuple &tuple, bool left) const;
+
+  /** Reads the next tuple of the left side and its key. */
+  void AdvanceLeft();
+
+  /** Reads the next tuple of the right side and its key. */
+  void AdvanceRight();
+
+  /**
+   * Finds the next pair of matching tuples.
+   * @param[out] left the tuple of the left side
+   * @param[out] right the tuple of the right side
+   * @return false once the join is done
+   */
+  bool NextMatch(const Tuple **left, const Tuple **right);
+
+  /** The merge join plan node to be executed. */
+  const MergeJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /** The direction of every join key, all ascending. */
+  std::vector<OrderByType> key_types_;
+
+  TupleBatch left_batch_;
+  size_t left_row_{0};
+  TupleBatch right_batch_;
+  size_t right_row_{0};
+  /** The current tuple of each side and its key, unless the side is exhausted. */
+  bool has_left_{false};
+  Tuple left_tuple_;
+  SortKey left_key_;
+  bool has_right_{false};
+  Tuple right_tuple_;
+  SortKey right_key_;
+  /** The right tuples with the key of the current left tuple, and the next one to join it with. */
+  std::vector<Tuple> run_;
+  SortKey run_key_;
+  size_t run_pos_{0};
+};
+
+}  // namespace bustub
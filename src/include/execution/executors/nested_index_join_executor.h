@@ -29,6 +29,10 @@ namespace bustub {
 
 /**
  * IndexJoinExecutor executes index join operations.
+ *
+ * Outer tuples are joined in batches: the index is probed for INDEX_FETCH_BATCH_SIZE outer tuples, and the inner
+ * tuples they match are fetched together, each page once. Unless the plan keeps outer order, a batch comes out in the
+ * order its inner tuples are stored in.
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
@@ -48,6 +52,9 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /** Probes the index for the next batch of outer tuples and fetches their matches. @return false once done */
+  bool FetchBatch();
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
   // my data
@@ -55,5 +62,11 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   Catalog *catalog;
   TableMetadata *innerTable_info;
   IndexInfo *innerIndex_info;
+  std::vector<Tuple> outer_batch_;
+  std::vector<RID> inner_rids_;
+  /** The outer tuple of every rid in inner_rids_. */
+  std::vector<size_t> inner_outer_;
+  std::vector<std::pair<size_t, Tuple>> inner_batch_;
+  size_t batch_offset_{0};
 };
 }  // namespace bustub
@@ -23,8 +23,10 @@
 
 namespace bustub {
 /**
- * NestedLoopJoinExecutor joins two tables using nested loop.
- * The child executor can either be a sequential scan
+ * NestedLoopJoinExecutor joins two tables using block nested loop.
+ * The left child is read a block of tuples at a time, at most as many pages of tuples as the plan allows, and the right
+ * child is scanned once for every block. Joined tuples are produced as the scan finds them, so neither side nor the
+ * result is held in memory as a whole.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
@@ -46,15 +48,42 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
-  bool do_child_executor(std::vector<Tuple> *child_tuple, AbstractExecutor *child_executor);
+  /** Fills the batch with joined tuples, evaluating the output columns straight into it. */
+  bool NextBatch(TupleBatch *batch) override;
 
  private:
+  /**
+   * Reads the next block of left tuples and starts a scan of the right child for it.
+   * @return false once the left child is exhausted
+   */
+  bool LoadNextBlock();
+
+  /**
+   * Finds the next pair of matching tuples.
+   * @param[out] left the tuple of the left side
+   * @param[out] right the tuple of the right side
+   * @return false once the join is done
+   */
+  bool NextMatch(const Tuple **left, const Tuple **right);
+
   /** The NestedLoop plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
 
   std::unique_ptr<AbstractExecutor> left_executor_;
   std::unique_ptr<AbstractExecutor> right_executor_;
-  std::vector<Tuple> res;  // return tuple in Next()
-  uint32_t idx{0};
+  /** The bytes of left tuples in a block at most, unless a single tuple is larger. */
+  size_t block_bytes_;
+
+  /** The block of left tuples the right child is being scanned for. */
+  std::vector<Tuple> block_;
+  TupleBatch left_batch_;
+  size_t left_row_{0};
+  TupleBatch right_batch_;
+  size_t right_row_{0};
+  /** Whether a scan of the right child found no tuple, so that no further block can join. */
+  bool right_empty_{false};
+  /** The right tuple being joined, and the position in the block of the next left tuple to try it with. */
+  Tuple right_tuple_;
+  size_t block_pos_{0};
 };
 }  // namespace bustub
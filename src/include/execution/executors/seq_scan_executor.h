@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "execution/executor_context.h"
@@ -37,14 +38,29 @@ class SeqScanExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Fills the batch with the output columns of table tuples, then drops the rows the predicate rejects. Reads the
+   * table a page at a time, apart from the iterator Next uses: an executor is drained by one or the other.
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
  private:
+  /** Takes the shared lock on rid that reading it under the isolation level of the transaction needs. */
+  void LockRow(const RID &rid);
+  /** Gives the lock on rid back if the isolation level lets reads do so once done. */
+  void UnlockRow(const RID &rid);
+
   /** The sequential scan plan node to be executed. */
   const SeqScanPlanNode *plan_;
   // my data structure
   TableMetadata *table_info;
   TableHeap *table_heap;
   TableIterator itor;
+  /** The tuples of the page NextBatch reads, the position of the next one, and the page after it. */
+  std::vector<std::pair<RID, Tuple>> page_tuples_;
+  size_t page_pos_{0};
+  page_id_t next_page_id_{INVALID_PAGE_ID};
 };
 }  // namespace bustub
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/external_sorter.h"
+#include "storage/table/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * SortExecutor returns the tuples of its child ordered on the sort keys of the plan. Tuples with equal keys keep the
+ * order the child produced them in.
+ *
+ * The tuples are sorted by an ExternalSorter, in memory as long as they fit in the memory budget of the plan, and
+ * else in sorted runs of TmpTupleRun pages, merged at most as many at a time as the budget holds pages. A sort with a
+ * limit keeps only the tuples it is going to return, in a bounded heap, for as long as they fit in the budget.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort executor.
+   * @param exec_ctx the executor context
+   * @param plan the sort plan to be executed
+   * @param child_executor the child executor that produces the tuples to be sorted
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Makes the sort return no more than its first limit tuples, for a LimitExecutor right above it. Call before Init().
+   * @param limit the number of tuples the consumer of the sort takes at most
+   */
+  void SetLimit(size_t limit) {
+    has_limit_ = true;
+    limit_ = limit;
+  }
+
+ private:
+  /** A tuple to be sorted, with its sort key and the RID the child returned it with. */
+  struct Entry {
+    SortKey key_;
+    Tuple tuple_;
+    RID rid_;
+  };
+
+  /** A tuple kept by a sort with a limit, and its position in the input, which breaks ties between equal keys. */
+  struct TopNEntry {
+    SortKey key_;
+    size_t seq_;
+    Tuple tuple_;
+    RID rid_;
+  };
+
+  /** Orders entries on their sort keys. */
+  struct EntryLess {
+    bool operator()(const Entry &lhs, const Entry &rhs) const {
+      return lhs.key_.Compare(rhs.key_, *order_by_types_) < 0;
+    }
+
+    const std::vector<OrderByType> *order_by_types_;
+  };
+
+  /**
+   * A sorted run of entries, their tuples written out as a TmpTupleRun and their RIDs as a TmpRecordRun alongside, and
+   * their keys evaluated again on reading.
+   */
+  class SortRun {
+   public:
+    SortRun(BufferPoolManager *buffer_pool_manager, const SortExecutor *sort)
+        : run_(buffer_pool_manager), rid_run_(buffer_pool_manager), sort_(sort) {}
+
+    void Append(const Entry &entry) {
+      run_.Append(entry.tuple_);
+      rid_run_.Append(entry.rid_);
+    }
+
+    void Finish() {
+      run_.Finish();
+      rid_run_.Finish();
+    }
+
+    bool ReadPage(std::vector<Entry> *entries);
+
+   private:
+    TmpTupleRun run_;
+    TmpRecordRun<RID> rid_run_;
+    /** The RIDs read from rid_run_ and not yet given to a tuple, from next_rid_ on. */
+    std::vector<RID> rids_;
+    size_t next_rid_{0};
+    const SortExecutor *sort_;
+  };
+
+  /** @return the sort key of a tuple of the child */
+  SortKey MakeKey(const Tuple &tuple) const;
+
+  /** @return whether a tuple kept by a sort with a limit comes before another one */
+  bool TopNLess(const TopNEntry &lhs, const TopNEntry &rhs) const;
+
+  /** The sort plan node to be executed. */
+  const SortPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The bytes of tuples the sort holds in memory at most. */
+  size_t memory_bytes_;
+  /** The runs a merge reads from at once. */
+  size_t fan_in_;
+  bool has_limit_{false};
+  size_t limit_{0};
+
+  /** The sorter of the tuples, made anew by every Init(). */
+  std::unique_ptr<ExternalSorter<Entry, SortRun, EntryLess>> sorter_;
+};
+
+}  // namespace bustub
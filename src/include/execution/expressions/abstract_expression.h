@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -39,6 +40,14 @@ class AbstractExpression {
   /** @return the value obtained by evaluating the tuple with the given schema */
   virtual Value Evaluate(const Tuple *tuple, const Schema *schema) const = 0;
 
+  /**
+   * Evaluates the expression on every row of a batch, the columns of the batch being those of the schema Evaluate()
+   * would be given.
+   * @param batch the rows to evaluate
+   * @param[out] result the value of each row, in the order of the rows
+   */
+  virtual void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const = 0;
+
   /**
    * Returns the value obtained by evaluating a join.
    * @param left_tuple the left tuple
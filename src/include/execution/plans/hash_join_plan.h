@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_plan.h
+//
+// Identification: src/include/execution/plans/hash_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * HashJoinPlanNode joins the tuples of two children whose join keys are equal.
+ * The executor builds its hash table on whichever child turns out to be smaller.
+ */
+class HashJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new hash join plan node.
+   * @param output_schema the output format of this hash join node
+   * @param children the left and the right child plans
+   * @param left_keys the join keys, evaluated on the tuples of the left child
+   * @param right_keys the join keys, evaluated on the tuples of the right child, one for every left key
+   * @param predicate a further condition the joined tuples must satisfy, nullptr for none
+   * @param memory_pages pages of tuples the join builds its hash table from before it partitions its input to disk
+   */
+  HashJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                   std::vector<const AbstractExpression *> &&left_keys,
+                   std::vector<const AbstractExpression *> &&right_keys, const AbstractExpression *predicate = nullptr,
+                   int memory_pages = HASH_JOIN_MEMORY_PAGES)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        left_keys_(std::move(left_keys)),
+        right_keys_(std::move(right_keys)),
+        predicate_(predicate),
+        memory_pages_(memory_pages) {
+    BUSTUB_ASSERT(left_keys_.size() == right_keys_.size(), "Both sides of a hash join need as many keys.");
+  }
+
+  PlanType GetType() const override { return PlanType::HashJoin; }
+
+  /** @return the join keys of the left side */
+  const std::vector<const AbstractExpression *> &GetLeftKeys() const { return left_keys_; }
+
+  /** @return the join keys of the right side */
+  const std::vector<const AbstractExpression *> &GetRightKeys() const { return right_keys_; }
+
+  /** @return the predicate the joined tuples must satisfy besides equal keys, nullptr if there is none */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the pages of tuples the join holds in memory */
+  int GetMemoryPages() const { return memory_pages_; }
+
+  /** @return the left plan node of the hash join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node of the hash join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+ private:
+  std::vector<const AbstractExpression *> left_keys_;
+  std::vector<const AbstractExpression *> right_keys_;
+  const AbstractExpression *predicate_;
+  int memory_pages_;
+};
+
+struct HashJoinKey {
+  std::vector<Value> keys_;
+
+  /**
+   * Compares two join keys for equality.
+   * @param other the other join key to be compared with
+   * @return true if every key value is equal to the one of the other join key
+   */
+  bool operator==(const HashJoinKey &other) const {
+    for (uint32_t i = 0; i < other.keys_.size(); i++) {
+      if (keys_[i].CompareEquals(other.keys_[i]) != CmpBool::CmpTrue) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** @return whether a key value is null, so that the key equals no other */
+  bool HasNull() const {
+    for (const auto &key : keys_) {
+      if (key.IsNull()) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+}  // namespace bustub
+
+namespace std {
+
+/**
+ * Implements std::hash on HashJoinKey.
+ */
+template <>
+struct hash<bustub::HashJoinKey> {
+  std::size_t operator()(const bustub::HashJoinKey &join_key) const {
+    size_t curr_hash = 0;
+    for (const auto &key : join_key.keys_) {
+      curr_hash = bustub::HashUtil::CombineHashes(curr_hash, bustub::HashUtil::HashValue(&key));
+    }
+    return curr_hash;
+  }
+};
+
+}  // namespace std
@@ -12,11 +12,24 @@
 
 #pragma once
 
+#include <optional>
+#include <utility>
+
 #include "catalog/catalog.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
 #include "execution/plans/abstract_plan.h"
 
 namespace bustub {
+
+/** A bound on the first key column of an index scan: keys past value are out of range, and so is value unless
+ * inclusive. */
+struct IndexScanBound {
+  Value value_;
+  bool inclusive_;
+};
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
  */
@@ -28,9 +41,19 @@ class IndexScanPlanNode : public AbstractPlanNode {
    * @param predicate the predicate to scan with, tuples are returned if predicate(tuple) == true or predicate ==
    * nullptr
    * @param table_oid the identifier of table to be scanned
+   * @param lower_bound the least first key column to scan; without one the scan derives it from the predicate
+   * @param upper_bound the greatest first key column to scan; without one the scan derives it from the predicate
+   * @param keep_order whether tuples come out in index order, rather than in the order they are stored in
    */
-  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid)
-      : AbstractPlanNode(output, {}), predicate_{predicate}, index_oid_(index_oid) {}
+  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid,
+                    std::optional<IndexScanBound> lower_bound = std::nullopt,
+                    std::optional<IndexScanBound> upper_bound = std::nullopt, bool keep_order = true)
+      : AbstractPlanNode(output, {}),
+        predicate_{predicate},
+        index_oid_(index_oid),
+        lower_bound_(std::move(lower_bound)),
+        upper_bound_(std::move(upper_bound)),
+        keep_order_(keep_order) {}
 
   PlanType GetType() const override { return PlanType::IndexScan; }
 
@@ -40,11 +63,72 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** @return the identifier of the table that should be scanned */
   index_oid_t GetIndexOid() const { return index_oid_; }
 
+  /** @return the least first key column to scan, if the plan bounds it */
+  const std::optional<IndexScanBound> &GetLowerBound() const { return lower_bound_; }
+
+  /** @return the greatest first key column to scan, if the plan bounds it */
+  const std::optional<IndexScanBound> &GetUpperBound() const { return upper_bound_; }
+
+  /** @return whether tuples come out in index order */
+  bool KeepOrder() const { return keep_order_; }
+
+  /**
+   * Derives the bounds a predicate puts on a column, if it compares the column with a constant.
+   * @param predicate the predicate, evaluated against the output schema
+   * @param column_idx the column of the output schema to bound
+   * @param[out] lower_bound set if the predicate bounds the column from below
+   * @param[out] upper_bound set if the predicate bounds the column from above
+   */
+  static void ExtractBounds(const AbstractExpression *predicate, uint32_t column_idx,
+                            std::optional<IndexScanBound> *lower_bound, std::optional<IndexScanBound> *upper_bound) {
+    const auto *comparison = dynamic_cast<const ComparisonExpression *>(predicate);
+    if (comparison == nullptr) {
+      return;
+    }
+    ComparisonType comp_type = comparison->GetComparisonType();
+    const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+    const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+    if (column == nullptr) {
+      // constant op column is column op' constant
+      column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+      constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0));
+      comp_type = ComparisonExpression::Mirror(comp_type);
+    }
+    if (column == nullptr || constant == nullptr || column->GetColIdx() != column_idx) {
+      return;
+    }
+    Value value = constant->Evaluate(nullptr, nullptr);
+    if (value.IsNull()) {
+      return;
+    }
+    switch (comp_type) {
+      case ComparisonType::Equal:
+        *lower_bound = IndexScanBound{value, true};
+        *upper_bound = IndexScanBound{value, true};
+        break;
+      case ComparisonType::GreaterThan:
+      case ComparisonType::GreaterThanOrEqual:
+        *lower_bound = IndexScanBound{value, comp_type == ComparisonType::GreaterThanOrEqual};
+        break;
+      case ComparisonType::LessThan:
+      case ComparisonType::LessThanOrEqual:
+        *upper_bound = IndexScanBound{value, comp_type == ComparisonType::LessThanOrEqual};
+        break;
+      default:
+        break;
+    }
+  }
+
  private:
   /** The predicate that all returned tuples must satisfy. */
   const AbstractExpression *predicate_;
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
+  /** The range of the first key column to scan. */
+  std::optional<IndexScanBound> lower_bound_;
+  std::optional<IndexScanBound> upper_bound_;
+  /** Whether the scan restores index order after fetching a batch of tuples page by page. */
+  bool keep_order_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_plan.h
+//
+// Identification: src/include/execution/plans/merge_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * MergeJoinPlanNode joins the tuples of two children whose join keys are equal, both children producing their tuples
+ * in ascending order of their join keys, such as index scans over the join keys or sorts on them.
+ */
+class MergeJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new merge join plan node.
+   * @param output_schema the output format of this merge join node
+   * @param children the left and the right child plans, both ordered on their join keys
+   * @param left_keys the join keys, evaluated on the tuples of the left child, the most significant first
+   * @param right_keys the join keys, evaluated on the tuples of the right child, one for every left key
+   * @param predicate a further condition the joined tuples must satisfy, nullptr for none
+   */
+  MergeJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                    std::vector<const AbstractExpression *> &&left_keys,
+                    std::vector<const AbstractExpression *> &&right_keys, const AbstractExpression *predicate = nullptr)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        left_keys_(std::move(left_keys)),
+        right_keys_(std::move(right_keys)),
+        predicate_(predicate) {
+    BUSTUB_ASSERT(left_keys_.size() == right_keys_.size(), "Both sides of a merge join need as many keys.");
+  }
+
+  PlanType GetType() const override { return PlanType::MergeJoin; }
+
+  /** @return the join keys of the left side */
+  const std::vector<const AbstractExpression *> &GetLeftKeys() const { return left_keys_; }
+
+  /** @return the join keys of the right side */
+  const std::vector<const AbstractExpression *> &GetRightKeys() const { return right_keys_; }
+
+  /** @return the predicate the joined tuples must satisfy besides equal keys, nullptr if there is none */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the left plan node of the merge join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node of the merge join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+ private:
+  std::vector<const AbstractExpression *> left_keys_;
+  std::vector<const AbstractExpression *> right_keys_;
+  const AbstractExpression *predicate_;
+};
+
+}  // namespace bustub
@@ -31,13 +31,15 @@ class NestedIndexJoinPlanNode : public AbstractPlanNode {
  public:
   NestedIndexJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
                           const AbstractExpression *predicate, table_oid_t inner_table_oid, std::string index_name,
-                          const Schema *outer_table_schema, const Schema *inner_table_schema)
+                          const Schema *outer_table_schema, const Schema *inner_table_schema,
+                          bool keep_order = true)
       : AbstractPlanNode(output_schema, std::move(children)),
         predicate_(predicate),
         inner_table_oid_(inner_table_oid),
         index_name_(std::move(index_name)),
         outer_table_schema_(outer_table_schema),
-        inner_table_schema_(inner_table_schema) {}
+        inner_table_schema_(inner_table_schema),
+        keep_order_(keep_order) {}
 
   PlanType GetType() const override { return PlanType::NestedIndexJoin; }
 
@@ -59,6 +61,9 @@ class NestedIndexJoinPlanNode : public AbstractPlanNode {
   /** @return Schema with needed columns in from the inner table */
   const Schema *InnerTableSchema() const { return inner_table_schema_; }
 
+  /** @return whether joined tuples come out in the order of the outer tuples */
+  bool KeepOrder() const { return keep_order_; }
+
  private:
   /** The nested index join predicate. */
   const AbstractExpression *predicate_;
@@ -66,5 +71,7 @@ class NestedIndexJoinPlanNode : public AbstractPlanNode {
   const std::string index_name_;
   const Schema *outer_table_schema_;
   const Schema *inner_table_schema_;
+  /** Whether the join restores outer order after fetching a batch of inner tuples page by page. */
+  bool keep_order_;
 };
 }  // namespace bustub
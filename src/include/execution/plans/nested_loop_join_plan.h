@@ -31,16 +31,20 @@ class NestedLoopJoinPlanNode : public AbstractPlanNode {
    * @param children two sequential scan children plans
    * @param predicate the predicate to join with, the tuples are joined if predicate(tuple) = true or predicate =
    * nullptr
+   * @param block_pages pages of left tuples the join holds in memory for every scan of the right child
    */
   NestedLoopJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
-                         const AbstractExpression *predicate)
-      : AbstractPlanNode(output_schema, std::move(children)), predicate_(predicate) {}
+                         const AbstractExpression *predicate, int block_pages = NESTED_LOOP_JOIN_BLOCK_PAGES)
+      : AbstractPlanNode(output_schema, std::move(children)), predicate_(predicate), block_pages_(block_pages) {}
 
   PlanType GetType() const override { return PlanType::NestedLoopJoin; }
 
   /** @return the predicate to be used in the nested loop join */
   const AbstractExpression *Predicate() const { return predicate_; }
 
+  /** @return the pages of left tuples the join holds in memory */
+  int GetBlockPages() const { return block_pages_; }
+
   /** @return the left plan node of the nested loop join, by convention it should be the smaller table*/
   const AbstractPlanNode *GetLeftPlan() const {
     BUSTUB_ASSERT(GetChildren().size() == 2, "Nested loop joins should have exactly two children plans.");
@@ -56,6 +60,8 @@ class NestedLoopJoinPlanNode : public AbstractPlanNode {
  private:
   /** The join predicate. */
   const AbstractExpression *predicate_;
+  /** The pages of left tuples in a block. */
+  int block_pages_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_plan.h
+//
+// Identification: src/include/execution/plans/sort_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** OrderByType enumerates the directions a sort key can be ordered in. */
+enum class OrderByType { Asc, Desc };
+
+/**
+ * SortPlanNode orders the tuples of its child, like ORDER BY.
+ * Its output schema is the output schema of its child, whose tuples it returns as they are.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new sort plan node.
+   * @param output_schema the output format of this sort node, the one of its child
+   * @param child the child plan to sort the tuples of
+   * @param order_bys the sort keys, evaluated on the tuples of the child, the most significant first
+   * @param order_by_types the direction of every sort key
+   * @param memory_pages pages of tuples the sort holds in memory before it writes sorted runs to disk
+   */
+  SortPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<const AbstractExpression *> &&order_bys, std::vector<OrderByType> &&order_by_types,
+               int memory_pages = SORT_MEMORY_PAGES)
+      : AbstractPlanNode(output_schema, {child}),
+        order_bys_(std::move(order_bys)),
+        order_by_types_(std::move(order_by_types)),
+        memory_pages_(memory_pages) {
+    BUSTUB_ASSERT(order_bys_.size() == order_by_types_.size(), "Every sort key needs a direction.");
+  }
+
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  /** @return the child of this sort plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Sort expected to only have one child.");
+    return GetChildAt(0);
+  }
+
+  /** @return the sort key expressions */
+  const std::vector<const AbstractExpression *> &GetOrderBys() const { return order_bys_; }
+
+  /** @return the directions of the sort keys */
+  const std::vector<OrderByType> &GetOrderByTypes() const { return order_by_types_; }
+
+  /** @return the pages of tuples the sort holds in memory */
+  int GetMemoryPages() const { return memory_pages_; }
+
+ private:
+  std::vector<const AbstractExpression *> order_bys_;
+  std::vector<OrderByType> order_by_types_;
+  int memory_pages_;
+};
+
+struct SortKey {
+  std::vector<Value> keys_;
+
+  /**
+   * Compares two sort keys. A null key value comes before any other value, and after it in descending order.
+   * @param other the other sort key to be compared with
+   * @param order_by_types the direction of every key value
+   * @return negative if this key sorts first, positive if the other one does, 0 if they are equal
+   */
+  int Compare(const SortKey &other, const std::vector<OrderByType> &order_by_types) const {
+    for (uint32_t i = 0; i < keys_.size(); i++) {
+      int cmp;
+      if (keys_[i].IsNull() || other.keys_[i].IsNull()) {
+        cmp = static_cast<int>(other.keys_[i].IsNull()) - static_cast<int>(keys_[i].IsNull());
+      } else if (keys_[i].CompareLessThan(other.keys_[i]) == CmpBool::CmpTrue) {
+        cmp = -1;
+      } else {
+        cmp = keys_[i].CompareGreaterThan(other.keys_[i]) == CmpBool::CmpTrue ? 1 : 0;
+      }
+      if (cmp != 0) {
+        return order_by_types[i] == OrderByType::Asc ? cmp : -cmp;
+      }
+    }
+    return 0;
+  }
+
+  /** @return whether a key value is null */
+  bool HasNull() const {
+    for (const auto &key : keys_) {
+      if (key.IsNull()) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+}  // namespace bustub
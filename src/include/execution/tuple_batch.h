@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch holds up to TUPLE_BATCH_SIZE rows of an executor's output, column by column: the values of each column
+ * of the output schema in a vector of their own, plus the RID of each row. Executors pass batches to each other
+ * without serializing rows into Tuples; a batch is reused from call to call, keeping the memory of its columns.
+ */
+class TupleBatch {
+ public:
+  explicit TupleBatch(size_t capacity = TUPLE_BATCH_SIZE) : capacity_(capacity) {}
+
+  /** Empties the batch, and gives it the columns of schema (none if schema is nullptr). */
+  void Reset(const Schema *schema);
+
+  size_t NumRows() const { return num_rows_; }
+  size_t NumColumns() const { return columns_.size(); }
+  size_t Capacity() const { return capacity_; }
+  bool IsEmpty() const { return num_rows_ == 0; }
+  bool IsFull() const { return num_rows_ >= capacity_; }
+
+  /** @return the values of column col_idx, one a row */
+  const std::vector<Value> &GetColumn(uint32_t col_idx) const { return columns_[col_idx]; }
+  const Value &GetValue(uint32_t col_idx, size_t row) const { return columns_[col_idx][row]; }
+  const RID &GetRid(size_t row) const { return rids_[row]; }
+
+  /** Appends the value of column col_idx of the row being added; FinishRow() ends the row. */
+  void Append(uint32_t col_idx, const Value &value) { columns_[col_idx].push_back(value); }
+  /** Ends the row being added, every column having had a value appended. */
+  void FinishRow(const RID &rid);
+
+  /** Appends a row with the values of every column of tuple, which has the schema of the batch. */
+  void AppendTuple(const Tuple &tuple, const Schema *schema, const RID &rid);
+
+  /** @return row as a Tuple of schema, the schema of the batch */
+  Tuple GetTuple(size_t row, const Schema *schema) const;
+
+  /** Keeps the rows whose value in mask, a boolean a row, is true, in order. */
+  void Select(const std::vector<Value> &mask);
+
+ private:
+  size_t capacity_;
+  size_t num_rows_{0};
+  std::vector<std::vector<Value>> columns_;
+  std::vector<RID> rids_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_io_engine.h
+//
+// Identification: src/include/storage/disk/async_io_engine.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <condition_variable>  // NOLINT
+#include <cstddef>
+#include <deque>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace bustub {
+
+/**
+ * AsyncIOEngine keeps many reads and writes on one file descriptor in flight at once.
+ *
+ * Requests go to an io_uring submission queue and a reaper thread completes their futures as the kernel posts
+ * completions. Where io_uring cannot be set up (old kernel, seccomp filter, or use_io_uring == false) the requests are
+ * served by a small pool of threads doing pread/pwrite instead; callers see no difference.
+ */
+class AsyncIOEngine {
+ public:
+  /**
+   * @param fd file descriptor the I/O is issued against, owned by the caller
+   * @param queue_depth the most requests in flight at once, further submissions wait for a slot
+   * @param num_workers the number of threads of the pread/pwrite fallback
+   * @param use_io_uring false to always use the fallback
+   */
+  AsyncIOEngine(int fd, size_t queue_depth, size_t num_workers, bool use_io_uring = true);
+
+  /** Waits for every request in flight and releases the ring or the workers. */
+  ~AsyncIOEngine();
+
+  /**
+   * Reads size bytes at offset into data. Bytes past the end of the file read as zeros.
+   * @param submit false to only queue the request until the next Submit(), batching it with others
+   * @return a future that becomes ready once data holds the result; get() throws an Exception if the read failed
+   */
+  std::future<void> Read(char *data, size_t size, off_t offset, bool submit = true);
+
+  /**
+   * Writes size bytes of data at offset. data must stay untouched until the write completes.
+   * @param submit false to only queue the request until the next Submit(), batching it with others
+   * @return a future that becomes ready once the write has been handed to the operating system; get() throws an
+   * Exception if the write failed
+   */
+  std::future<void> Write(const char *data, size_t size, off_t offset, bool submit = true);
+
+  /** Hands every queued request to the kernel with a single system call. */
+  void Submit();
+
+  /** @return true if requests go through io_uring, false if through the fallback threads */
+  bool UsingIoUring() const { return ring_fd_ >= 0; }
+
+ private:
+  struct Request {
+    bool is_write_;
+    char *data_;
+    size_t size_;
+    off_t offset_;
+    struct iovec iov_;
+    std::promise<void> promise_;
+  };
+
+  /** Maps the submission and completion rings, false if io_uring is unavailable. */
+  bool SetupRing(size_t entries);
+  /** Unmaps the rings and closes the ring descriptor. */
+  void TearDownRing();
+  /** Places a request (nullptr for a wake-up no-op) in the submission queue, latch_ must be held. */
+  void Enqueue(Request *request, std::unique_lock<std::mutex> *lock);
+  /** Enters the kernel to submit everything enqueued so far, latch_ must be held. */
+  void SubmitLocked();
+  /** Takes back the entries the kernel refused to submit and does them synchronously, latch_ must be held. */
+  void TakeBackUnsubmitted();
+  /** Body of the reaper thread: turns completion queue entries into ready futures. */
+  void ReapCompletions();
+  /** Body of a fallback thread. */
+  void ServeRequests();
+  /** Finishes a request whose first res bytes were transferred (res < 0 is an error code) and releases it. */
+  void Complete(Request *request, int res);
+  /** Makes the future of a request ready, failed if err is not 0, and releases the request. */
+  void Resolve(Request *request, int err);
+  /** Does (the rest of) a request with blocking pread/pwrite, returns 0 or the errno it failed with. */
+  int TransferSync(Request *request, size_t done);
+
+  int fd_;
+  size_t queue_depth_;
+
+  // protects in_flight_, stopping_, the submission queue and pending_
+  std::mutex latch_;
+  // signalled when a request leaves the engine, or a fallback request arrives
+  std::condition_variable cv_;
+  size_t in_flight_{0};
+  bool stopping_{false};
+
+  // io_uring state
+  int ring_fd_{-1};
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  void *sqes_{nullptr};
+  size_t sqes_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  void *cqes_{nullptr};
+  // entries placed in the submission queue but not yet handed to the kernel
+  unsigned unsubmitted_{0};
+  std::thread reaper_;
+
+  // fallback state
+  std::deque<Request *> pending_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
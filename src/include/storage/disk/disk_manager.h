@@ -12,15 +12,36 @@
 
 #pragma once
 
+#include <sys/types.h>
+
 #include <atomic>
+#include <cstdint>
 #include <fstream>
 #include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/async_io_engine.h"
 
 namespace bustub {
 
+/** How DiskManager reads and writes pages of the database file. */
+enum class DiskIOBackend {
+  /** One std::fstream whose seek + read/write is serialized by a latch, flushed after every write. */
+  FSTREAM,
+  /** pread/pwrite at page_id * PAGE_SIZE on a file descriptor; calls run in parallel and Sync() makes them durable. */
+  POSITIONAL,
+  /**
+   * POSITIONAL on a file opened with O_DIRECT, bypassing the kernel page cache so the buffer pool is the only cache.
+   * Page buffers should be PAGE_SIZE aligned, as buffer pool frames are; others are copied through an aligned buffer.
+   * Falls back to POSITIONAL on file systems without direct I/O.
+   */
+  DIRECT
+};
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
@@ -30,10 +51,11 @@ class DiskManager {
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param backend how pages are read and written
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, DiskIOBackend backend = DiskIOBackend::POSITIONAL);
 
-  ~DiskManager() = default;
+  ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
@@ -54,6 +76,38 @@ class DiskManager {
    */
   void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Starts reading a page from the database file. With the POSITIONAL backend up to ASYNC_IO_QUEUE_DEPTH reads and
+   * writes are in flight at once, through io_uring where the kernel allows it and worker threads otherwise; the
+   * FSTREAM backend reads synchronously.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, must not be touched until the returned future is ready
+   * @param submit false to queue the read until the next SubmitAsync(), so a batch costs a single system call
+   * @return a future that becomes ready once page_data holds the page; get() throws an Exception if the read failed
+   */
+  std::future<void> ReadPageAsync(page_id_t page_id, char *page_data, bool submit = true);
+
+  /**
+   * Starts writing a page to the database file, see ReadPageAsync().
+   * @param page_id id of the page
+   * @param page_data raw page data, must not be modified until the returned future is ready
+   * @param submit false to queue the write until the next SubmitAsync()
+   * @return a future that becomes ready once the page has been written; get() throws an Exception if the write failed
+   */
+  std::future<void> WritePageAsync(page_id_t page_id, const char *page_data, bool submit = true);
+
+  /** Submits every asynchronous read and write queued with submit == false. */
+  void SubmitAsync();
+
+  /**
+   * Makes every page written so far durable. With the POSITIONAL backend, WritePage() only hands the page to the
+   * operating system, so this is the durability point.
+   */
+  void Sync();
+
+  /** @return the I/O backend of the database file, POSITIONAL if DIRECT was asked for but is not supported */
+  DiskIOBackend GetBackend() const { return backend_; }
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -71,17 +125,40 @@ class DiskManager {
   bool ReadLog(char *log_data, int size, int offset);
 
   /**
-   * Allocate a page on disk.
+   * Allocate a page on disk, reusing a deallocated page if there is one.
+   * @param hint a page the new one will be used together with; the free page closest to it is picked, for locality
+   * @return the id of the allocated page
+   */
+  page_id_t AllocatePage(page_id_t hint = INVALID_PAGE_ID);
+
+  /**
+   * Allocate a page on disk whose id is shard modulo num_shards, for a buffer pool sharded by page id.
+   * @param hint a page the new one will be used together with; the free page of the shard closest to it is picked
+   * @param num_shards the number of shards
+   * @param shard the shard the id has to map to
    * @return the id of the allocated page
    */
-  page_id_t AllocatePage();
+  page_id_t AllocatePage(page_id_t hint, size_t num_shards, size_t shard);
 
   /**
-   * Deallocate a page on disk.
+   * Deallocate a page on disk, so that AllocatePage() can hand it out again.
    * @param page_id id of the page to deallocate
    */
   void DeallocatePage(page_id_t page_id);
 
+  /** @return the number of deallocated pages waiting to be reused */
+  size_t GetNumFreePages();
+
+  /**
+   * Besides the pages, the database file holds a file header recording the next page id, and before every
+   * PAGES_PER_FREE_MAP pages a bitmap of which of them are free.
+   * @return the offset of a page in the database file
+   */
+  static off_t GetPageOffset(page_id_t page_id);
+
+  /** @return the id the next AllocatePage() will hand out, every lower id has been allocated */
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
   /** @return the number of disk flushes */
   int GetNumFlushes() const;
 
@@ -91,6 +168,9 @@ class DiskManager {
   /** @return the number of disk writes */
   int GetNumWrites() const;
 
+  /** @return the number of disk reads */
+  int GetNumReads() const;
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -101,16 +181,47 @@ class DiskManager {
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
  private:
-  int GetFileSize(const std::string &file_name);
+  /** Identifies a database file, in the first bytes of its header. */
+  static constexpr uint32_t FILE_MAGIC = 0x42545542;
+  /** Pages covered by one free-space map, one bit each. */
+  static constexpr size_t PAGES_PER_FREE_MAP = PAGE_SIZE * 8;
+  static constexpr size_t WORDS_PER_FREE_MAP = PAGES_PER_FREE_MAP / 64;
+
+  off_t GetFileSize(const std::string &file_name);
+  AsyncIOEngine *GetAsyncIO();
+  void WriteBlock(off_t offset, const char *data);
+  void ReadBlock(off_t offset, char *data);
+  void LoadFreeSpaceMap();
+  void WriteFileHeader();
+  void WriteFreeMap(size_t group);
+  page_id_t ExtendFile();
+  page_id_t TakeFreePage(page_id_t page_id);
+  bool MarkFree(page_id_t page_id);
+  static uint64_t ShardMask(size_t word_idx, size_t num_shards, size_t shard);
+  page_id_t FindFreePage(page_id_t hint, size_t num_shards, size_t shard);
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
+  DiskIOBackend backend_;
+  // stream to write db file, FSTREAM backend only
   std::fstream db_io_;
+  // serializes seek + read/write on db_io_, which may be shared by several buffer pool instances
+  std::mutex db_io_latch_;
+  // descriptor of the db file, POSITIONAL backend only
+  int db_fd_{-1};
+  // serves ReadPageAsync/WritePageAsync, started by the first of them
+  std::unique_ptr<AsyncIOEngine> async_io_;
+  std::once_flag async_io_started_;
   std::string file_name_;
   std::atomic<page_id_t> next_page_id_;
+  // one bit per allocated page id, set while the page is free
+  std::vector<uint64_t> free_map_;
+  size_t num_free_pages_{0};
+  // protects free_map_ and num_free_pages_, and orders page id allocation with them
+  std::mutex free_map_latch_;
   int num_flushes_;
-  int num_writes_;
+  std::atomic<int> num_writes_;
+  std::atomic<int> num_reads_;
   bool flush_log_;
   std::future<void> *flush_log_f_;
 };
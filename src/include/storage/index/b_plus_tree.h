@@ -10,26 +10,56 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <queue>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "common/logger.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
+#include "storage/index/posting_lists.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_prefix_page.h"
 
 namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/** Shape of a B+ tree: its height, the pages it takes and how full they are. */
+struct BPlusTreeStats {
+  int height_{0};
+  int leaf_pages_{0};
+  int internal_pages_{0};
+  int64_t entries_{0};
+  // children of all internal pages
+  int64_t children_{0};
+  // key bytes pages store once as their prefix, summed over all pages
+  int64_t prefix_bytes_{0};
+
+  double AverageLeafEntries() const { return leaf_pages_ == 0 ? 0 : static_cast<double>(entries_) / leaf_pages_; }
+  double AverageFanout() const { return internal_pages_ == 0 ? 0 : static_cast<double>(children_) / internal_pages_; }
+
+  std::string ToString() const {
+    std::ostringstream os;
+    os << "height=" << height_ << " leaf_pages=" << leaf_pages_ << " internal_pages=" << internal_pages_
+       << " entries=" << entries_ << " entries/leaf=" << AverageLeafEntries() << " fanout=" << AverageFanout()
+       << " prefix_bytes/page=" << (leaf_pages_ + internal_pages_ == 0 ? 0 : static_cast<double>(prefix_bytes_) /
+                                                                                  (leaf_pages_ + internal_pages_));
+    return os.str();
+  }
+};
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique, unless the tree is created non-unique: then every key
+ *     holds all of its values, more than one in a posting list (see PostingLists)
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
@@ -41,20 +71,34 @@ class BPlusTree {
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     bool unique = true);
 
   // Returns true if this B+ tree has no keys and values.
   // bool IsEmpty() const;
   bool IsEmpty();
 
-  // Insert a key-value pair into this B+ tree.
+  // Insert a key-value pair into this B+ tree; a non-unique tree adds the value to those of the key.
   bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr,
               OperationType ot = OperationType::OPTIMISTIC_READ);
 
-  // return the value associated with a given key
+  // Remove one value of a key, and the key along with its last value.
+  void RemoveValue(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  /**
+   * Builds the tree bottom up from entries in key order, filling every node to fill_factor of the entries it holds
+   * before it splits, and linking each new page close to the one before it. Of equal keys only the first is kept,
+   * as Insert() would, unless the tree is non-unique. A tree that is not empty has the entries inserted one by one
+   * instead. No other operation may run on the tree meanwhile.
+   * @param next stores the next entry and returns true, or returns false once there are no more
+   */
+  void BulkLoad(const std::function<bool(KeyType *, ValueType *)> &next, double fill_factor = INDEX_FILL_FACTOR,
+                Transaction *transaction = nullptr);
+
+  // return the values associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
   // index iterator
@@ -62,6 +106,9 @@ class BPlusTree {
   INDEXITERATOR_TYPE Begin(const KeyType &key);
   INDEXITERATOR_TYPE end();
 
+  /** Walks the whole tree to report its shape. No other operation may run on the tree meanwhile. */
+  BPlusTreeStats GetStats();
+
   void Print(BufferPoolManager *bpm) {
     ToString(reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(root_page_id_)->GetData()), bpm);
   }
@@ -84,8 +131,43 @@ class BPlusTree {
                      Transaction *transaction = nullptr);
 
  private:
+  /** The node a bulk load is filling on one level of the tree, and the last node it filled there before. */
+  struct BulkLoadLevel {
+    Page *page_{nullptr};
+    page_id_t prev_page_id_{INVALID_PAGE_ID};
+  };
+
+  // entries a bulk loaded leaf (or children an internal node) gets, kept between min and max size
+  int BulkLoadFill(const BPlusTreePage *node, double fill_factor) const;
+
+  int NonRootMinSize(const BPlusTreePage *node) const {
+    return node->IsLeafPage() ? node->GetMaxSize() / 2 : (node->GetMaxSize() + 1) / 2;
+  }
+
+  // the open node of the level for key, after closing it and opening a new one if it is full
+  template <typename N>
+  N *BulkLoadTarget(std::vector<BulkLoadLevel> *levels, size_t level, const KeyType &key, double fill_factor);
+
+  void BulkLoadAddChild(std::vector<BulkLoadLevel> *levels, size_t level, Page *child_page, double fill_factor);
+
+  // brings the last node of the level up to min size and hands it to the level above; the top one becomes the root
+  template <typename N>
+  void BulkLoadFinishLevel(std::vector<BulkLoadLevel> *levels, size_t level, double fill_factor);
+
+  /**
+   * Looks the key up without taking any latch. Every page on the way down is checked against its version, so the
+   * lookup notices a split, merge or leaf update racing with it.
+   * @param[out] value the value of the key, if found
+   * @param[out] found true if the key is in the tree
+   * @return false if a writer got in the way and the lookup has to restart
+   */
+  bool OptimisticLookup(const KeyType &key, ValueType *value, bool *found);
+
   void StartNewTree(const KeyType &key, const ValueType &value);
 
+  // removes the key, or if value is given and the key holds others too, only that value
+  void RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction, OperationType ot);
+
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr,
                       OperationType ot = OperationType::OPTIMISTIC_READ);
 
@@ -109,6 +191,9 @@ class BPlusTree {
 
   void UpdateRootPageId(int insert_record = 0);
 
+  // finds the posting pages with free slots of a tree being opened
+  void RecoverPostingLists();
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
@@ -125,11 +210,15 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // read without root_mutex by optimistic lookups
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  bool unique_;
+  // values of the keys of a non-unique tree that hold more than one
+  PostingLists posting_lists_;
   std::mutex root_mutex;
 };
 
@@ -14,11 +14,30 @@
 
 #include <cstring>
 
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
 namespace bustub {
 
+/**
+ * Writes the key tuple in an order-preserving binary encoding: comparing two encodings with memcmp orders them like
+ * comparing their columns one after the other. Each column starts with a byte that sorts NULL first. Integers follow
+ * big-endian with the sign bit flipped, decimals as IEEE bits flipped so they order as unsigned integers, and varchars
+ * as their bytes (0x00 escaped as 0x00 0xFF) ended by 0x00 0x00.
+ * @param tuple the key tuple, laid out by key_schema
+ * @param key_schema the schema of the key
+ * @param[out] data where the encoding goes, zero padded to size
+ * @param size the size of data; an encoding that does not fit throws, as cutting it off would make keys equal
+ */
+void NormalizeKey(const Tuple &tuple, const Schema *key_schema, char *data, size_t size);
+
+/**
+ * @return the size of the normalized encoding of a key of key_schema whose varchars fit their declared length and
+ * hold no zero bytes, which would be escaped
+ */
+size_t NormalizedKeySize(const Schema *key_schema);
+
 /**
  * Generic key is used for indexing with opaque data.
  *
@@ -35,6 +54,11 @@ class GenericKey {
     memcpy(data_, tuple.GetData(), tuple.GetLength());
   }
 
+  /** Sets the key to the normalized encoding of tuple, the key format of MemcmpComparator. */
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
+    NormalizeKey(tuple, key_schema, data_, KeySize);
+  }
+
   // NOTE: for test purpose only
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
@@ -77,6 +101,18 @@ template <size_t KeySize>
 class GenericComparator {
  public:
   inline int operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    switch (integer_key_width_) {
+      case sizeof(int64_t):
+        return CompareInteger<int64_t>(lhs, rhs);
+      case sizeof(int32_t):
+        return CompareInteger<int32_t>(lhs, rhs);
+      case sizeof(int16_t):
+        return CompareInteger<int16_t>(lhs, rhs);
+      case sizeof(int8_t):
+        return CompareInteger<int8_t>(lhs, rhs);
+      default:
+        break;
+    }
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
@@ -94,13 +130,92 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, integer_key_width_{other.integer_key_width_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema)
+      : key_schema_(key_schema), integer_key_width_(IntegerKeyWidth(key_schema)) {}
+
+  /**
+   * @return the size in bytes of the integer at the start of the keys if the key schema is a single integer column,
+   * whose keys are compared as plain integers without going through Value, 0 otherwise
+   */
+  inline uint32_t GetIntegerKeyWidth() const { return integer_key_width_; }
 
  private:
+  static uint32_t IntegerKeyWidth(Schema *key_schema) {
+    if (key_schema == nullptr || key_schema->GetColumnCount() != 1) {
+      return 0;
+    }
+    const auto &col = key_schema->GetColumn(0);
+    switch (col.GetType()) {
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+        break;
+      default:
+        return 0;
+    }
+    auto width = static_cast<uint32_t>(Type::GetTypeSize(col.GetType()));
+    return (col.GetOffset() == 0 && width <= KeySize) ? width : 0;
+  }
+
+  // NULL is stored as the smallest value of the type, so it sorts first. A key too narrow for T never has an integer
+  // key width of sizeof(T), the check only keeps the read from being compiled for it.
+  template <typename T>
+  static inline int CompareInteger(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) {
+    if constexpr (sizeof(T) <= KeySize) {
+      T lhs_value;
+      T rhs_value;
+      memcpy(&lhs_value, lhs.data_, sizeof(T));
+      memcpy(&rhs_value, rhs.data_, sizeof(T));
+      return lhs_value < rhs_value ? -1 : (lhs_value > rhs_value ? 1 : 0);
+    } else {
+      return 0;
+    }
+  }
+
   Schema *key_schema_;
+  uint32_t integer_key_width_;
 };
 
+/**
+ * Compares keys set by GenericKey::SetFromKey(tuple, key_schema) with a single memcmp, no matter the key schema.
+ * Normalized keys cannot be turned back into values with GenericKey::ToValue.
+ */
+template <size_t KeySize>
+class MemcmpComparator {
+ public:
+  inline int operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    return memcmp(lhs.data_, rhs.data_, KeySize);
+  }
+
+  MemcmpComparator(const MemcmpComparator &other) = default;
+
+  // constructor
+  explicit MemcmpComparator(Schema *key_schema) : key_schema_(key_schema) {
+    if (NormalizedKeySize(key_schema) > KeySize) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "normalized keys of the key schema do not fit the key size.");
+    }
+  }
+
+  inline Schema *GetKeySchema() const { return key_schema_; }
+
+ private:
+  Schema *key_schema_;
+};
+
+/** Builds the index key of a key tuple in the format the comparator of the index expects. */
+template <size_t KeySize>
+inline void MakeIndexKey(const Tuple &tuple, const GenericComparator<KeySize> &comparator, GenericKey<KeySize> *key) {
+  key->SetFromKey(tuple);
+}
+
+template <size_t KeySize>
+inline void MakeIndexKey(const Tuple &tuple, const MemcmpComparator<KeySize> &comparator, GenericKey<KeySize> *key) {
+  key->SetFromKey(tuple, comparator.GetKeySchema());
+}
+
 }  // namespace bustub
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_entry_sorter.h
+//
+// Identification: src/include/storage/index/index_entry_sorter.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/table/external_sorter.h"
+
+namespace bustub {
+
+/**
+ * IndexEntrySorter sorts the (key, value) entries an index is built from, so that they can be bulk loaded.
+ *
+ * It is an ExternalSorter of entries: they are sorted in memory while they fit in memory_pages pages, and written out
+ * as sorted runs of TmpRecordRun pages past that. Entries with equal keys come out in the order they were added.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class IndexEntrySorter {
+  using Entry = std::pair<KeyType, ValueType>;
+
+ public:
+  IndexEntrySorter(BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                   int memory_pages = INDEX_BUILD_SORT_PAGES)
+      : sorter_([buffer_pool_manager] { return std::make_unique<TmpRecordRun<Entry>>(buffer_pool_manager); },
+                EntryLess{comparator}, static_cast<size_t>(std::max(1, memory_pages)) * PAGE_SIZE,
+                // a merge holds a page of every run it reads from
+                std::max(2, memory_pages)) {}
+
+  DISALLOW_COPY_AND_MOVE(IndexEntrySorter);
+
+  /** Adds an entry, spilling the entries added so far once they fill the memory budget. */
+  void Add(const KeyType &key, const ValueType &value) { sorter_.Add(Entry(key, value), sizeof(Entry)); }
+
+  /** Sorts what is left in memory and prepares the merge. Call once after the last Add(). */
+  void Finish() { sorter_.Finish(); }
+
+  /** @return the entries are sorted in memory and nothing was written out */
+  bool InMemory() const { return sorter_.InMemory(); }
+
+  /**
+   * Takes the next entry in key order.
+   * @return false once every entry has been taken
+   */
+  bool Next(KeyType *key, ValueType *value) {
+    Entry entry;
+    if (!sorter_.Next(&entry)) {
+      return false;
+    }
+    *key = entry.first;
+    *value = entry.second;
+    return true;
+  }
+
+ private:
+  struct EntryLess {
+    bool operator()(const Entry &lhs, const Entry &rhs) const { return comparator_(lhs.first, rhs.first) < 0; }
+
+    KeyComparator comparator_;
+  };
+
+  ExternalSorter<Entry, TmpRecordRun<Entry>, EntryLess> sorter_;
+};
+
+}  // namespace bustub
@@ -13,7 +13,11 @@
  * For range scan of b+ tree
  */
 #pragma once
-#include "storage/page/b_plus_tree_leaf_page.h"
+#include <vector>
+
+#include "buffer/read_ahead.h"
+#include "storage/index/posting_lists.h"
+#include "storage/page/b_plus_tree_prefix_page.h"
 
 namespace bustub {
 
@@ -27,6 +31,10 @@ class IndexIterator {
                          B_PLUS_TREE_LEAF_PAGE_TYPE *leaf = nullptr);
   ~IndexIterator();
 
+  // the pinned leaf moves along with the iterator, and the read-ahead starts over from it
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator &operator=(IndexIterator &&other) noexcept;
+
   // what's the definition of isEnd()
   bool isEnd();
 
@@ -35,18 +43,26 @@ class IndexIterator {
   IndexIterator &operator++();
 
   bool operator==(const IndexIterator &itr) const {
-    return this->leaf_node == itr.leaf_node && this->kv_idx == itr.kv_idx;
+    return this->leaf_node == itr.leaf_node && this->kv_idx == itr.kv_idx && this->posting_idx_ == itr.posting_idx_;
   }
 
-  bool operator!=(const IndexIterator &itr) const {
-    return this->leaf_node != itr.leaf_node || this->kv_idx != itr.kv_idx;
-  }
+  bool operator!=(const IndexIterator &itr) const { return !(*this == itr); }
 
  private:
+  // reads the posting list of the current key, if it has one and it is not read yet
+  void LoadPostings();
+
   // add your own private member variables here
   BufferPoolManager *buffer_pool_manager_;
   int kv_idx;
   B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_node;
+  // the entry operator* last read
+  MappingType item_;
+  // a key with a posting list comes out once per value, the values read when the iterator gets to the key
+  std::vector<ValueType> postings_;
+  size_t posting_idx_{0};
+  // prefetches the leaves the scan is about to reach
+  ReadAhead read_ahead_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,219 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_search.h
+//
+// Identification: src/include/storage/index/key_search.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/*
+ * Searches the sorted keys of a B+ tree page. KeyLowerBound() returns the first index in [begin, end) whose key is not
+ * less than key, KeyUpperBound() the first whose key is greater than key; both return end if there is none.
+ *
+ * Keys of any comparator are binary searched through it. GenericKeys of a single integer column are read as integers
+ * instead: a binary search narrows them down to KEY_SEARCH_BLOCK keys, and those are compared with the search key a
+ * vector at a time, with AVX2 or SSE if the build targets them.
+ */
+
+/** Number of keys left to the vector compare once the binary search has narrowed them down. */
+static constexpr int KEY_SEARCH_BLOCK = 16;
+
+template <typename T>
+inline T LoadIntegerKey(const char *key) {
+  T value;
+  memcpy(&value, key, sizeof(T));
+  return value;
+}
+
+/** @return how many of the n keys stride bytes apart at keys are less than key (not greater than key if Upper) */
+template <bool Upper, typename T>
+inline int ScalarCountKeysBelow(const char *keys, size_t stride, int n, T key) {
+  int count = 0;
+  for (int i = 0; i < n; i++) {
+    T value = LoadIntegerKey<T>(keys + i * stride);
+    count += (value < key || (Upper && value == key)) ? 1 : 0;
+  }
+  return count;
+}
+
+#if defined(__AVX2__)
+
+/** The 64-bit integer the AVX2 intrinsics take pointers to, which need not be the same type as int64_t. */
+using Avx2Int64 = std::remove_reference_t<decltype(std::declval<__m256i>()[0])>;
+static_assert(sizeof(Avx2Int64) == sizeof(int64_t));
+
+template <bool Upper>
+inline int VectorCountKeysBelow(const char *keys, size_t stride, int n, int64_t key) {
+  const __m256i needle = _mm256_set1_epi64x(key);
+  const auto step = static_cast<int>(stride);
+  const __m128i offsets = _mm_setr_epi32(0, step, 2 * step, 3 * step);
+  int count = 0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i values = _mm256_i32gather_epi64(reinterpret_cast<const Avx2Int64 *>(keys + i * stride), offsets, 1);
+    // for Upper count the lanes where value > key does not hold
+    __m256i mask = Upper ? _mm256_cmpgt_epi64(values, needle) : _mm256_cmpgt_epi64(needle, values);
+    int lanes = __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+    count += Upper ? 4 - lanes : lanes;
+  }
+  return count + ScalarCountKeysBelow<Upper>(keys + i * stride, stride, n - i, key);
+}
+
+template <bool Upper>
+inline int VectorCountKeysBelow(const char *keys, size_t stride, int n, int32_t key) {
+  const __m256i needle = _mm256_set1_epi32(key);
+  const auto step = static_cast<int>(stride);
+  const __m256i offsets = _mm256_setr_epi32(0, step, 2 * step, 3 * step, 4 * step, 5 * step, 6 * step, 7 * step);
+  int count = 0;
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i values = _mm256_i32gather_epi32(reinterpret_cast<const int *>(keys + i * stride), offsets, 1);
+    __m256i mask = Upper ? _mm256_cmpgt_epi32(values, needle) : _mm256_cmpgt_epi32(needle, values);
+    int lanes = __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+    count += Upper ? 8 - lanes : lanes;
+  }
+  return count + ScalarCountKeysBelow<Upper>(keys + i * stride, stride, n - i, key);
+}
+
+#elif defined(__SSE4_2__)
+
+template <bool Upper>
+inline int VectorCountKeysBelow(const char *keys, size_t stride, int n, int64_t key) {
+  const __m128i needle = _mm_set1_epi64x(key);
+  int count = 0;
+  int i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const char *pair = keys + i * stride;
+    __m128i values = _mm_set_epi64x(LoadIntegerKey<int64_t>(pair + stride), LoadIntegerKey<int64_t>(pair));
+    __m128i mask = Upper ? _mm_cmpgt_epi64(values, needle) : _mm_cmpgt_epi64(needle, values);
+    int lanes = __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+    count += Upper ? 2 - lanes : lanes;
+  }
+  return count + ScalarCountKeysBelow<Upper>(keys + i * stride, stride, n - i, key);
+}
+
+template <bool Upper>
+inline int VectorCountKeysBelow(const char *keys, size_t stride, int n, int32_t key) {
+  const __m128i needle = _mm_set1_epi32(key);
+  int count = 0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const char *quad = keys + i * stride;
+    __m128i values = _mm_setr_epi32(LoadIntegerKey<int32_t>(quad), LoadIntegerKey<int32_t>(quad + stride),
+                                    LoadIntegerKey<int32_t>(quad + 2 * stride),
+                                    LoadIntegerKey<int32_t>(quad + 3 * stride));
+    __m128i mask = Upper ? _mm_cmpgt_epi32(values, needle) : _mm_cmpgt_epi32(needle, values);
+    int lanes = __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+    count += Upper ? 4 - lanes : lanes;
+  }
+  return count + ScalarCountKeysBelow<Upper>(keys + i * stride, stride, n - i, key);
+}
+
+#endif
+
+/** Binary search down to a block of keys, then count the keys of the block below key. */
+template <bool Upper, typename T>
+inline int IntegerKeyBound(const char *keys, size_t stride, int begin, int end, T key) {
+  while (end - begin > KEY_SEARCH_BLOCK) {
+    int mid = begin + (end - begin) / 2;
+    T value = LoadIntegerKey<T>(keys + mid * stride);
+    if (value < key || (Upper && value == key)) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  const char *block = keys + begin * stride;
+#if defined(__AVX2__) || defined(__SSE4_2__)
+  if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, int32_t>) {
+    return begin + VectorCountKeysBelow<Upper>(block, stride, end - begin, key);
+  }
+#endif
+  return begin + ScalarCountKeysBelow<Upper>(block, stride, end - begin, key);
+}
+
+/** Plain binary search, comparing through the comparator. */
+template <bool Upper, typename EntryType, typename KeyType, typename KeyComparator>
+inline int ComparatorKeyBound(const EntryType *array, int begin, int end, const KeyType &key,
+                              const KeyComparator &comparator) {
+  while (begin < end) {
+    int mid = begin + (end - begin) / 2;
+    int cmp = comparator(array[mid].first, key);
+    if (cmp < 0 || (Upper && cmp == 0)) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin;
+}
+
+template <bool Upper, typename EntryType, typename KeyType, typename KeyComparator>
+inline int KeyBound(const EntryType *array, int begin, int end, const KeyType &key, const KeyComparator &comparator) {
+  return ComparatorKeyBound<Upper>(array, begin, end, key, comparator);
+}
+
+/** Searches GenericKeys holding an integer of type T; keys too narrow for T never do, and go through the comparator. */
+template <bool Upper, typename T, typename EntryType, size_t KeySize>
+inline int GenericIntegerKeyBound(const EntryType *array, int begin, int end, const GenericKey<KeySize> &key,
+                                  const GenericComparator<KeySize> &comparator) {
+  if constexpr (sizeof(T) <= KeySize) {
+    return IntegerKeyBound<Upper>(array[0].first.data_, sizeof(EntryType), begin, end, LoadIntegerKey<T>(key.data_));
+  } else {
+    return ComparatorKeyBound<Upper>(array, begin, end, key, comparator);
+  }
+}
+
+template <bool Upper, typename EntryType, size_t KeySize>
+inline int KeyBound(const EntryType *array, int begin, int end, const GenericKey<KeySize> &key,
+                    const GenericComparator<KeySize> &comparator) {
+  if (begin >= end) {
+    return begin;
+  }
+  switch (comparator.GetIntegerKeyWidth()) {
+    case sizeof(int64_t):
+      return GenericIntegerKeyBound<Upper, int64_t>(array, begin, end, key, comparator);
+    case sizeof(int32_t):
+      return GenericIntegerKeyBound<Upper, int32_t>(array, begin, end, key, comparator);
+    case sizeof(int16_t):
+      return GenericIntegerKeyBound<Upper, int16_t>(array, begin, end, key, comparator);
+    case sizeof(int8_t):
+      return GenericIntegerKeyBound<Upper, int8_t>(array, begin, end, key, comparator);
+    default:
+      break;
+  }
+  return ComparatorKeyBound<Upper>(array, begin, end, key, comparator);
+}
+
+template <typename EntryType, typename KeyType, typename KeyComparator>
+inline int KeyLowerBound(const EntryType *array, int begin, int end, const KeyType &key,
+                         const KeyComparator &comparator) {
+  return KeyBound<false>(array, begin, end, key, comparator);
+}
+
+template <typename EntryType, typename KeyType, typename KeyComparator>
+inline int KeyUpperBound(const EntryType *array, int begin, int end, const KeyType &key,
+                         const KeyComparator &comparator) {
+  return KeyBound<true>(array, begin, end, key, comparator);
+}
+
+}  // namespace bustub
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posting_lists.h
+//
+// Identification: src/include/storage/index/posting_lists.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_posting_page.h"
+
+namespace bustub {
+
+/**
+ * PostingLists keeps the RIDs of the keys a non-unique B+ tree holds more than one RID for.
+ *
+ * The value a leaf stores for a key is the RID itself while the key has one. Once it has more, the leaf stores a
+ * reference to the key's posting list instead: a RID whose slot number has its top bit set, pointing at a slot of a
+ * posting page (see BPlusTreePostingPage). Slots come in size classes of 2, 4, 8, ... RIDs, every posting page holding
+ * slots of one class, so that a list takes little more than 8 bytes a RID; a list that outgrows its slot moves to one
+ * twice the size, and moves back down once it shrinks to a quarter. A list larger than the largest slot, a page of its
+ * own, continues on overflow pages. The order of the RIDs in a list is not kept.
+ *
+ * A list is only ever changed by a writer holding the latch of the leaf that refers to it; posting page latches keep
+ * readers from seeing a slot half written, and writers of other lists on the same page out. Which pages have free
+ * slots is only kept in memory; a tree being opened hands its posting pages to Recover() to find them again.
+ */
+class PostingLists {
+ public:
+  explicit PostingLists(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {}
+
+  DISALLOW_COPY_AND_MOVE(PostingLists);
+
+  /** @return whether a leaf value refers to a posting list, rather than being a RID */
+  static bool IsList(const RID &value) { return (value.GetSlotNum() & LIST_FLAG) != 0; }
+
+  /** Appends the RIDs a leaf value stands for: the RID itself, or all RIDs of its posting list. */
+  static void Read(BufferPoolManager *buffer_pool_manager, const RID &value, std::vector<RID> *rids);
+
+  /** @return the leaf value for rids, a posting list if there is more than one */
+  RID Make(const std::vector<RID> &rids);
+
+  /** @return the leaf value for the RIDs value stands for and rid; a value already in a list is not looked for */
+  RID Add(const RID &value, const RID &rid);
+
+  /**
+   * Removes rid from the posting list value refers to.
+   * @param[out] rest the leaf value for the RIDs left, the one RID once there is only one
+   * @return false if the list does not hold rid
+   */
+  bool Remove(const RID &value, const RID &rid, RID *rest);
+
+  /** Drops the posting list value refers to, if it refers to one. */
+  void Free(const RID &value);
+
+  /** Takes a posting page written before this PostingLists existed, to reuse its free slots. Call once a page. */
+  void Recover(page_id_t page_id);
+
+ private:
+  static constexpr uint32_t LIST_FLAG = 1U << 31;
+  static constexpr size_t NUM_SIZE_CLASSES = 9;
+
+  /** @return the RIDs a slot of the size class holds, 2 << size_class up to a whole page */
+  static uint32_t SlotCapacity(size_t size_class);
+  /** @return the smallest size class whose slots hold size RIDs, the largest if none does */
+  static size_t SizeClassFor(size_t size);
+  static RID Reference(page_id_t page_id, uint32_t slot) { return RID(page_id, slot | LIST_FLAG); }
+  static uint32_t SlotOf(const RID &value) { return value.GetSlotNum() & ~LIST_FLAG; }
+  static Page *FetchPage(BufferPoolManager *buffer_pool_manager, page_id_t page_id);
+
+  /** Stores rids, at least two of them, in a new list. @return the reference to it */
+  RID Store(const std::vector<RID> &rids);
+
+  /** Takes a free slot of the size class. @return its page, pinned and write latched */
+  Page *AllocateSlot(size_t size_class, uint32_t *slot);
+
+  /** @return a new overflow page holding rids[0, count), linked in front of next_page_id */
+  page_id_t NewOverflowPage(const RID *rids, uint32_t count, page_id_t next_page_id);
+
+  BufferPoolManager *buffer_pool_manager_;
+  /** Guards free_pages_, and slots being taken or given back. */
+  std::mutex latch_;
+  /** Per size class, the posting pages with a free slot. */
+  std::vector<page_id_t> free_pages_[NUM_SIZE_CLASSES];
+};
+
+}  // namespace bustub
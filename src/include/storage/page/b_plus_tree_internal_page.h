@@ -47,6 +47,8 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
   void Remove(int index);
   ValueType RemoveAndReturnOnlyChild();
+  // bulk loading adds children in key order
+  void Append(const KeyType &key, const ValueType &value);
 
   // Split and Merge utility methods
   void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager);
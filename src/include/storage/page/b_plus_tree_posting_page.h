@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_posting_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * Posting pages hold the RIDs of the keys a non-unique B+ tree holds more than one RID for (see PostingLists).
+ *
+ * A page is cut into slots of one size, every slot holding one posting list of up to SlotCapacity() RIDs. A slot
+ * whose size is 0 is free. A page of the largest size class has a single slot taking the whole page; the list in it
+ * continues on overflow pages chained through NextPageId, pages of the same format that only this list uses.
+ *
+ * Page format (slots of SIZE (4) followed by SlotCapacity() RIDs):
+ *  ----------------------------------------------
+ * | HEADER | SLOT(0) | SLOT(1) | ... | SLOT(n-1)
+ *  ----------------------------------------------
+ *
+ *  Header format (size in byte, 16 bytes in total):
+ *  ----------------------------------------------------------------------------------------
+ * | PageId (4) | NextPageId (4) | SlotCapacity (2) | NumSlots (2) | NumUsed (2) | Unused (2)
+ *  ----------------------------------------------------------------------------------------
+ */
+class BPlusTreePostingPage {
+ public:
+  static constexpr size_t HEADER_SIZE = 16;
+  /** RIDs in the one slot of a page of the largest size class. */
+  static constexpr uint32_t MAX_SLOT_CAPACITY = (PAGE_SIZE - HEADER_SIZE - sizeof(uint32_t)) / sizeof(RID);
+
+  /** Cuts the page into as many slots of slot_capacity RIDs as fit, all free. */
+  void Init(page_id_t page_id, uint32_t slot_capacity);
+
+  page_id_t GetPageId() const { return page_id_; }
+  page_id_t GetNextPageId() const { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+  uint32_t GetSlotCapacity() const { return slot_capacity_; }
+  uint32_t GetNumSlots() const { return num_slots_; }
+  uint32_t GetNumUsed() const { return num_used_; }
+  bool IsFull() const { return num_used_ == num_slots_; }
+
+  /** Takes a free slot. @return its index, the page must not be full */
+  uint32_t AllocateSlot();
+  /** Gives a slot back, dropping whatever it holds. */
+  void FreeSlot(uint32_t slot);
+
+  uint32_t GetSize(uint32_t slot) const { return *SlotSize(slot); }
+  void SetSize(uint32_t slot, uint32_t size) { *SlotSize(slot) = size; }
+  RID *GetRids(uint32_t slot) { return reinterpret_cast<RID *>(SlotSize(slot) + 1); }
+  const RID *GetRids(uint32_t slot) const { return reinterpret_cast<const RID *>(SlotSize(slot) + 1); }
+
+ private:
+  uint32_t *SlotSize(uint32_t slot) {
+    return reinterpret_cast<uint32_t *>(data_ + slot * (sizeof(uint32_t) + slot_capacity_ * sizeof(RID)));
+  }
+  const uint32_t *SlotSize(uint32_t slot) const {
+    return reinterpret_cast<const uint32_t *>(data_ + slot * (sizeof(uint32_t) + slot_capacity_ * sizeof(RID)));
+  }
+
+  page_id_t page_id_;
+  page_id_t next_page_id_;
+  uint16_t slot_capacity_;
+  uint16_t num_slots_;
+  uint16_t num_used_;
+  uint16_t unused_;
+  char data_[0];
+};
+
+static_assert(sizeof(BPlusTreePostingPage) == BPlusTreePostingPage::HEADER_SIZE);
+
+}  // namespace bustub
@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_prefix_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_prefix_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <climits>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "storage/index/generic_key.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define PREFIX_PAGE_TEMPLATE_ARGUMENTS template <size_t KeySize, typename ValueType>
+#define B_PLUS_TREE_PREFIX_PAGE_TYPE BPlusTreePrefixPage<KeySize, ValueType>
+
+/** True for comparators whose keys order as plain bytes, the trees whose pages store keys prefix compressed. */
+template <typename KeyComparator>
+struct IsPrefixCompressed : std::false_type {};
+
+template <size_t KeySize>
+struct IsPrefixCompressed<MemcmpComparator<KeySize>> : std::true_type {};
+
+/**
+ * Leaf and internal pages of trees over normalized keys (MemcmpComparator) store the bytes all their keys share once
+ * per page, and of every key only the rest.
+ *
+ * Every page keeps its fences: the separator in its parent that bounds its keys from below (the low fence) and the
+ * one that bounds them from above (the high fence). Every key of the page sorts between the two, so it starts with
+ * whatever prefix the fences share. The leftmost page of a level has no low fence and the rightmost no high fence,
+ * those store no prefix. Fences are set whenever a split, merge or redistribution moves the separators, which is also
+ * the only time the prefix changes, so an insert or remove shifts entries in place as in an uncompressed page.
+ *
+ * How many entries fit depends on the prefix, so the max size of the page follows it. A tree created with a max size
+ * below what fits without a prefix keeps that max size; any other grows every page to what it can hold. Min sizes are
+ * half of what fits without a prefix, so that a page borrowing an entry from a sibling, whose prefix can be shorter
+ * afterwards, always has room for it.
+ *
+ * Page format (suffixes are KeySize - PrefixSize bytes):
+ *  ------------------------------------------------------------------------------------
+ * | HEADER | LOW FENCE | HIGH FENCE | SUFFIX(1) + VALUE(1) | ... | SUFFIX(n) + VALUE(n)
+ *  ------------------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 36 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ *  ---------------------------------------------------------------------
+ *  -----------------------------------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | SizeLimit (4) | PrefixSize (2) | HasLow (1) | HasHigh (1)
+ *  -----------------------------------------------------------------------------------------------
+ * Internal pages leave NextPageId unused.
+ */
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+class BPlusTreePrefixPage : public BPlusTreePage {
+ public:
+  using KeyType = GenericKey<KeySize>;
+  using EntryType = std::pair<KeyType, ValueType>;
+
+  /** @return how many entries fit in a page whose keys share prefix_size bytes */
+  static int Capacity(int prefix_size) {
+    return static_cast<int>((PAGE_SIZE - sizeof(BPlusTreePrefixPage)) / (KeySize - prefix_size + sizeof(ValueType)));
+  }
+
+  int GetPrefixSize() const { return prefix_size_; }
+  int GetMinSize() const;
+
+  KeyType KeyAt(int index) const;
+  ValueType ValueAt(int index) const;
+
+  /** @return the fence bounding the keys of the page from below (above), nullptr if there is none */
+  const KeyType *GetLowFence() const { return has_low_fence_ ? &low_fence_ : nullptr; }
+  const KeyType *GetHighFence() const { return has_high_fence_ ? &high_fence_ : nullptr; }
+
+  /** Sets the fences of the page, storing the entries again under the prefix the new fences share. */
+  void SetFences(const KeyType *low_fence, const KeyType *high_fence);
+
+ protected:
+  void InitPrefixPage(int max_size);
+
+  /** @return the first index from begin whose key is not less than (if Upper, greater than) key */
+  template <bool Upper>
+  int KeyBound(const KeyType &key, int begin) const;
+  bool KeyEquals(int index, const KeyType &key) const;
+
+  void SetKey(int index, const KeyType &key);
+  void SetValue(int index, const ValueType &value);
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+  void RemoveAt(int index);
+
+  std::vector<EntryType> GetEntries() const;
+  /** Replaces the entries of the page, and its fences along with the prefix they share. */
+  void SetEntries(const std::vector<EntryType> &entries, const KeyType *low_fence, const KeyType *high_fence);
+
+  page_id_t next_page_id_;
+
+ private:
+  // a page read without a latch may hold anything, never index past the page
+  int PrefixSize() const { return prefix_size_ < KeySize ? prefix_size_ : static_cast<int>(KeySize); }
+  int SuffixSize() const { return static_cast<int>(KeySize) - PrefixSize(); }
+  int EntrySize() const { return SuffixSize() + static_cast<int>(sizeof(ValueType)); }
+  int MaxSizeFor(int prefix_size) const { return size_limit_ < Capacity(0) ? size_limit_ : Capacity(prefix_size); }
+  bool SharesPrefix(const KeyType &key) const;
+  void WriteEntry(int index, const KeyType &key, const ValueType &value);
+
+  int size_limit_;
+  uint16_t prefix_size_;
+  bool has_low_fence_;
+  bool has_high_fence_;
+  KeyType low_fence_;
+  KeyType high_fence_;
+  char data_[0];
+};
+
+#define B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE BPlusTreeLeafPage<GenericKey<KeySize>, ValueType, MemcmpComparator<KeySize>>
+
+/** Leaf page of a tree over normalized keys; same interface as BPlusTreeLeafPage, keys prefix compressed. */
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+class BPlusTreeLeafPage<GenericKey<KeySize>, ValueType, MemcmpComparator<KeySize>>
+    : public BPlusTreePrefixPage<KeySize, ValueType> {
+  using KeyType = GenericKey<KeySize>;
+  using KeyComparator = MemcmpComparator<KeySize>;
+
+ public:
+  // max_size is the most entries the page holds, INT_MAX for as many as fit
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INT_MAX);
+  page_id_t GetNextPageId() const;
+  void SetNextPageId(page_id_t next_page_id);
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+  // entries are not stored whole, so the item is a copy
+  MappingType GetItem(int index) const;
+  void SetValueAt(int index, const ValueType &value) { this->SetValue(index, value); }
+
+  int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+  bool Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const;
+  int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
+  void Append(const KeyType &key, const ValueType &value);
+
+  void MoveHalfTo(BPlusTreeLeafPage *recipient, BufferPoolManager *buffer_pool_manager);
+  void MoveAllTo(BPlusTreeLeafPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager);
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient, const KeyType &middle_key,
+                        BufferPoolManager *buffer_pool_manager);
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient, const KeyType &middle_key,
+                         BufferPoolManager *buffer_pool_manager);
+};
+
+#define B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE \
+  BPlusTreeInternalPage<GenericKey<KeySize>, ValueType, MemcmpComparator<KeySize>>
+
+/** Internal page of a tree over normalized keys; same interface as BPlusTreeInternalPage, keys prefix compressed. */
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+class BPlusTreeInternalPage<GenericKey<KeySize>, ValueType, MemcmpComparator<KeySize>>
+    : public BPlusTreePrefixPage<KeySize, ValueType> {
+  using KeyType = GenericKey<KeySize>;
+  using KeyComparator = MemcmpComparator<KeySize>;
+  using EntryType = typename BPlusTreePrefixPage<KeySize, ValueType>::EntryType;
+
+ public:
+  // max_size is the most children the page holds, INT_MAX for as many as fit
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INT_MAX);
+
+  void SetKeyAt(int index, const KeyType &key);
+  int ValueIndex(const ValueType &value) const;
+
+  ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const;
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  void Remove(int index);
+  ValueType RemoveAndReturnOnlyChild();
+  void Append(const KeyType &key, const ValueType &value);
+
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager);
+  void MoveHalfTo(BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                        BufferPoolManager *buffer_pool_manager);
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                         BufferPoolManager *buffer_pool_manager);
+
+ private:
+  // points the children in entries [begin, end) at this page
+  void Adopt(const std::vector<EntryType> &entries, size_t begin, size_t end, BufferPoolManager *buffer_pool_manager);
+};
+
+}  // namespace bustub
@@ -57,16 +57,17 @@ class HashTableBlockPage {
 
   /**
    * Attempts to insert a key and value into an index in the block.
-   * The insert is thread safe. It uses compare and swap to claim the index,
-   * and then writes the key and value into the index, and then marks the
-   * index as readable.
+   * It uses compare and swap to claim the index, and then writes the key and
+   * value into the index, and then marks the index as readable. A tombstone
+   * is taken again too; as the readable bit is only set once the pair is
+   * written, inserts that may race for an index have to hold the write
+   * latch of the page, which LinearProbeHashTable does.
    *
    * @param bucket_ind index to write the key and value to
    * @param key key to insert
    * @param value value to insert
    * @return If the value is inserted successfully, it returns true. If the
-   * index is marked as occupied before the key and value can be inserted,
-   * Insert returns false.
+   * index holds a readable key and value, Insert returns false.
    */
   bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value);
 
@@ -94,6 +95,11 @@ class HashTableBlockPage {
   bool IsReadable(slot_offset_t bucket_ind) const;
 
  private:
+  /** Sets the bit of bucket_ind in bits. @return whether this call set it, false if it was set already */
+  static bool SetBit(std::atomic_char *bits, slot_offset_t bucket_ind);
+  static void ClearBit(std::atomic_char *bits, slot_offset_t bucket_ind);
+  static bool TestBit(const std::atomic_char *bits, slot_offset_t bucket_ind);
+
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bucket_page.h
+//
+// Identification: src/include/storage/page/hash_table_bucket_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+/**
+ * Store indexed key and and value together within bucket page of an
+ * extendible hash table. Supports non-unique keys, but not the same key and
+ * value twice.
+ *
+ * Bucket page format (keys are stored in no particular order):
+ *  ----------------------------------------------------------------------------------
+ * | NextPageId (4) | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------------------------
+ *
+ *  Here '+' means concatenation.
+ *
+ * A bucket that is full and cannot split any further goes on in a chain of
+ * overflow pages of the same format, linked by their next page ids.
+ *
+ * Inserts take the first index that is not readable, so the occupied
+ * indexes always come first and a scan stops at the first unoccupied one.
+ * Unlike HashTableBlockPage, the page is read and written under its latch.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableBucketPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableBucketPage() = delete;
+
+  /**
+   * Appends the values of every pair with the key to result.
+   * @return whether there were any
+   */
+  bool GetValue(const KeyType &key, KeyComparator cmp, std::vector<ValueType> *result) const;
+
+  /**
+   * Inserts a key and value into the first index that is not readable.
+   * @return false if the bucket is full or already holds the pair
+   */
+  bool Insert(const KeyType &key, const ValueType &value, KeyComparator cmp);
+
+  /**
+   * Removes the pair of the key and value.
+   * @return false if the bucket does not hold it
+   */
+  bool Remove(const KeyType &key, const ValueType &value, KeyComparator cmp);
+
+  KeyType KeyAt(uint32_t bucket_idx) const { return array_[bucket_idx].first; }
+  ValueType ValueAt(uint32_t bucket_idx) const { return array_[bucket_idx].second; }
+
+  /** Removes the pair at bucket_idx, leaving a tombstone. */
+  void RemoveAt(uint32_t bucket_idx) { readable_[bucket_idx / 8] &= static_cast<char>(~(1 << (bucket_idx % 8))); }
+
+  /** @return whether the index was ever used (key/value pair or tombstone) */
+  bool IsOccupied(uint32_t bucket_idx) const { return (occupied_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0; }
+
+  /** @return whether the index holds a key/value pair */
+  bool IsReadable(uint32_t bucket_idx) const { return (readable_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0; }
+
+  /** @return the number of pairs in the bucket */
+  uint32_t NumReadable() const;
+
+  bool IsFull() const { return NumReadable() == BUCKET_ARRAY_SIZE; }
+
+  bool IsEmpty() const { return NumReadable() == 0; }
+
+  /** @return the page id of the next overflow page of the bucket, INVALID_PAGE_ID at the end of the chain */
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  /** Links the page to the next overflow page of the bucket. New pages come zeroed, so every bucket sets this. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+ private:
+  page_id_t next_page_id_;
+  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  // 0 if tombstone/brand new (never occupied), 1 otherwise.
+  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  MappingType array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ *
+ * Directory Page for extendible hash table.
+ *
+ * The low GlobalDepth bits of a hash pick one of the first 2^GlobalDepth slots; the slot holds the page id of the
+ * bucket page the key goes to and the local depth of that bucket, the number of low bits all of its keys share. A
+ * bucket of local depth d is shared by the 2^(GlobalDepth - d) slots that agree on those d bits.
+ *
+ * Directory format (size in byte):
+ * --------------------------------------------------------------------------------------------
+ * | LSN (4) | PageId (4) | GlobalDepth (4) | LocalDepths (512) | BucketPageIds (2048) | Free(1524)
+ * --------------------------------------------------------------------------------------------
+ */
+class HashTableDirectoryPage {
+ public:
+  /** The largest global depth, at which the directory fills the page. */
+  static constexpr uint32_t MAX_DEPTH = 9;
+  static_assert((1U << MAX_DEPTH) == DIRECTORY_ARRAY_SIZE);
+
+  page_id_t GetPageId() const { return page_id_; }
+  void SetPageId(page_id_t page_id) { page_id_ = page_id; }
+  lsn_t GetLSN() const { return lsn_; }
+  void SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+  /** @return the number of slots in use, 2^GlobalDepth */
+  uint32_t Size() const { return 1U << global_depth_; }
+  uint32_t GetGlobalDepth() const { return global_depth_; }
+  /** @return the low GlobalDepth bits of a hash, the slot it picks */
+  uint32_t IndexOf(uint32_t hash) const { return hash & (Size() - 1); }
+
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const { return bucket_page_ids_[bucket_idx]; }
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) { bucket_page_ids_[bucket_idx] = bucket_page_id; }
+  uint32_t GetLocalDepth(uint32_t bucket_idx) const { return local_depths_[bucket_idx]; }
+  void SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth) {
+    assert(local_depth <= global_depth_);
+    local_depths_[bucket_idx] = static_cast<uint8_t>(local_depth);
+  }
+
+  /**
+   * Doubles the directory: the slots of the new half point at the buckets their lower half counterparts point at.
+   * The directory must not be at MAX_DEPTH.
+   */
+  void IncrGlobalDepth();
+
+  /** @return whether no bucket has a local depth as large as the global depth, so that the directory can halve */
+  bool CanShrink() const;
+
+  /** Halves the directory, which must be able to. */
+  void DecrGlobalDepth();
+
+  /** Asserts that every bucket is shared by the slots its local depth says, and by no others. */
+  void VerifyIntegrity() const;
+
+ private:
+  lsn_t lsn_;
+  page_id_t page_id_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+static_assert(sizeof(HashTableDirectoryPage) <= PAGE_SIZE);
+
+}  // namespace bustub
@@ -22,3 +22,13 @@
 #define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
+
+/** BUCKET_ARRAY_SIZE is the number of (key, value) pairs a bucket page of an extendible hash table holds, worked out as
+ * for BLOCK_ARRAY_SIZE once the page id of the next overflow page is taken off.*/
+#define BUCKET_ARRAY_SIZE (4 * (PAGE_SIZE - sizeof(page_id_t)) / (4 * sizeof(MappingType) + 1))
+
+/** DIRECTORY_ARRAY_SIZE is the number of slots in the directory page of an extendible hash table, a power of two: the
+ * page id and local depth of a bucket take 5 bytes a slot.*/
+#define DIRECTORY_ARRAY_SIZE 512
+
+#define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
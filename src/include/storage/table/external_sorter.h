@@ -0,0 +1,292 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sorter.h
+//
+// Identification: src/include/storage/table/external_sorter.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/exception.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TmpRecordRun is a sequence of records of a fixed size, such as index entries, written out to pages of the buffer
+ * pool byte for byte. Like TmpTupleRun, the page being written stays pinned until Finish(); pages are read back in the
+ * order they were written, and deleted as they are read.
+ */
+template <typename RecordType>
+class TmpRecordRun {
+ public:
+  explicit TmpRecordRun(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {}
+
+  ~TmpRecordRun() {
+    Finish();
+    for (size_t i = next_page_; i < page_ids_.size(); i++) {
+      buffer_pool_manager_->DeletePage(page_ids_[i]);
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(TmpRecordRun);
+
+  /** Appends a record, starting a new page when the current one is full. */
+  void Append(const RecordType &record) {
+    if (page_ == nullptr || size_ % RECORDS_PER_PAGE == 0) {
+      Finish();
+      // keep the pages of a run close together, so that reading it back is sequential
+      page_id_t page_id;
+      page_ = buffer_pool_manager_->NewPageNear(&page_id, page_ids_.empty() ? INVALID_PAGE_ID : page_ids_.back());
+      if (page_ == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+      }
+      page_ids_.push_back(page_id);
+    }
+    memcpy(page_->GetData() + size_ % RECORDS_PER_PAGE * sizeof(RecordType), static_cast<const void *>(&record),
+           sizeof(RecordType));
+    size_++;
+  }
+
+  /** Gives back the page being written. Call once after the last Append(). */
+  void Finish() {
+    if (page_ != nullptr) {
+      buffer_pool_manager_->UnpinPage(page_->GetPageId(), true);
+      page_ = nullptr;
+    }
+  }
+
+  /**
+   * Reads the records of the next page, in the order they were appended, and deletes the page.
+   * @return false once every page has been read
+   */
+  bool ReadPage(std::vector<RecordType> *records) {
+    records->clear();
+    if (next_page_ == page_ids_.size()) {
+      return false;
+    }
+    page_id_t page_id = page_ids_[next_page_];
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+    }
+    records->resize(std::min(RECORDS_PER_PAGE, size_ - next_page_ * RECORDS_PER_PAGE));
+    memcpy(static_cast<void *>(records->data()), page->GetData(), records->size() * sizeof(RecordType));
+    next_page_++;
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    return true;
+  }
+
+  /** @return the number of records in the run */
+  size_t GetSize() const { return size_; }
+
+ private:
+  static constexpr size_t RECORDS_PER_PAGE = PAGE_SIZE / sizeof(RecordType);
+
+  BufferPoolManager *buffer_pool_manager_;
+  std::vector<page_id_t> page_ids_;
+  size_t next_page_{0};
+  /** The pinned page being written, nullptr if there is none. */
+  Page *page_{nullptr};
+  size_t size_{0};
+};
+
+/**
+ * ExternalSorter sorts records that need not fit in memory, the tuples of a sort or the entries of an index build.
+ *
+ * Records are sorted in memory as long as they fit in the memory budget. Past that, every full batch is sorted and
+ * written out as a run, and the runs are merged, at most fan_in at a time, so that a merge keeps one page of every run
+ * in memory. Records that compare equal come out in the order they were added.
+ *
+ * RunType writes records out to pages of the buffer pool and reads them back a page at a time, as TmpTupleRun and
+ * TmpRecordRun do: Append(const RecordType &), Finish() and ReadPage(std::vector<RecordType> *). Less orders records.
+ */
+template <typename RecordType, typename RunType, typename Less>
+class ExternalSorter {
+ public:
+  /**
+   * Creates a new external sorter.
+   * @param new_run makes an empty run for the sorter to write out to
+   * @param less whether a record sorts before another one
+   * @param memory_bytes the bytes of records the sorter holds in memory at most
+   * @param fan_in the runs a merge reads from at once
+   */
+  ExternalSorter(std::function<std::unique_ptr<RunType>()> new_run, Less less, size_t memory_bytes, size_t fan_in)
+      : new_run_(std::move(new_run)),
+        less_(std::move(less)),
+        memory_bytes_(memory_bytes),
+        fan_in_(std::max<size_t>(2, fan_in)) {}
+
+  DISALLOW_COPY_AND_MOVE(ExternalSorter);
+
+  /** Adds a record taking bytes of memory, writing the records so far out as a run once they exceed the budget. */
+  void Add(RecordType record, size_t bytes) {
+    records_.push_back(std::move(record));
+    bytes_ += bytes;
+    if (bytes_ > memory_bytes_) {
+      SortRecords();
+      SpillRun();
+    }
+  }
+
+  /** Sorts what is left in memory and merges runs until one merge reads them all. Call once after the last Add(). */
+  void Finish() {
+    SortRecords();
+    if (runs_.empty()) {
+      return;
+    }
+    // merge runs until the ones left and the records in memory can be merged at once
+    while (runs_.size() >= fan_in_) {
+      std::vector<std::unique_ptr<RunType>> merged_runs;
+      for (size_t begin = 0; begin < runs_.size(); begin += fan_in_) {
+        size_t end = std::min(begin + fan_in_, runs_.size());
+        if (end - begin == 1) {
+          merged_runs.push_back(std::move(runs_[begin]));
+          continue;
+        }
+        StartMerge(std::vector<std::unique_ptr<RunType>>(std::make_move_iterator(runs_.begin() + begin),
+                                                         std::make_move_iterator(runs_.begin() + end)),
+                   {});
+        auto run = new_run_();
+        RecordType record;
+        while (NextMerged(&record)) {
+          run->Append(record);
+        }
+        run->Finish();
+        merged_runs.push_back(std::move(run));
+      }
+      runs_ = std::move(merged_runs);
+    }
+    StartMerge(std::move(runs_), std::move(records_));
+    runs_.clear();
+    records_.clear();
+    merging_ = true;
+  }
+
+  /** @return whether the records are sorted in memory and nothing was written out */
+  bool InMemory() const { return !merging_; }
+
+  /**
+   * Takes the next record in order.
+   * @return false once every record has been taken
+   */
+  bool Next(RecordType *record) {
+    if (merging_) {
+      return NextMerged(record);
+    }
+    if (pos_ == records_.size()) {
+      return false;
+    }
+    *record = std::move(records_[pos_++]);
+    return true;
+  }
+
+ private:
+  /** A source of a merge: a sorted run read back a page at a time, or the sorted records left in memory. */
+  struct MergeSource {
+    std::unique_ptr<RunType> run_;
+    std::vector<RecordType> records_;
+    size_t pos_{0};
+  };
+
+  /** Orders merge sources so the priority queue pops the smallest head, earlier sources first among equal ones. */
+  class HeadGreater {
+   public:
+    explicit HeadGreater(const ExternalSorter *sorter) : sorter_(sorter) {}
+
+    bool operator()(size_t lhs, size_t rhs) const {
+      const RecordType &lhs_head = sorter_->sources_[lhs].records_[sorter_->sources_[lhs].pos_];
+      const RecordType &rhs_head = sorter_->sources_[rhs].records_[sorter_->sources_[rhs].pos_];
+      return sorter_->less_(rhs_head, lhs_head) || (!sorter_->less_(lhs_head, rhs_head) && lhs > rhs);
+    }
+
+   private:
+    const ExternalSorter *sorter_;
+  };
+
+  void SortRecords() { std::stable_sort(records_.begin(), records_.end(), less_); }
+
+  void SpillRun() {
+    auto run = new_run_();
+    for (const auto &record : records_) {
+      run->Append(record);
+    }
+    run->Finish();
+    runs_.push_back(std::move(run));
+    records_.clear();
+    bytes_ = 0;
+  }
+
+  /** Starts merging runs and then the records in memory, the earlier ones first among equal records. */
+  void StartMerge(std::vector<std::unique_ptr<RunType>> &&runs, std::vector<RecordType> &&records) {
+    sources_.clear();
+    for (auto &run : runs) {
+      sources_.push_back({std::move(run), {}, 0});
+    }
+    if (!records.empty()) {
+      sources_.push_back({nullptr, std::move(records), 0});
+    }
+    heads_ = decltype(heads_)(HeadGreater(this));
+    for (size_t i = 0; i < sources_.size(); i++) {
+      PushHead(i);
+    }
+  }
+
+  /** Puts a source into the merge if it has a record left, reading the next page of its run when it needs to. */
+  void PushHead(size_t source) {
+    MergeSource *merge_source = &sources_[source];
+    if (merge_source->pos_ == merge_source->records_.size()) {
+      if (merge_source->run_ == nullptr || !merge_source->run_->ReadPage(&merge_source->records_)) {
+        merge_source->run_.reset();
+        return;
+      }
+      merge_source->pos_ = 0;
+    }
+    heads_.push(source);
+  }
+
+  bool NextMerged(RecordType *record) {
+    if (heads_.empty()) {
+      return false;
+    }
+    size_t source = heads_.top();
+    heads_.pop();
+    *record = std::move(sources_[source].records_[sources_[source].pos_++]);
+    PushHead(source);
+    return true;
+  }
+
+  std::function<std::unique_ptr<RunType>()> new_run_;
+  Less less_;
+  size_t memory_bytes_;
+  size_t fan_in_;
+
+  /** The records in memory, and the next one to be taken unless the sorter merges runs. */
+  std::vector<RecordType> records_;
+  size_t bytes_{0};
+  size_t pos_{0};
+  /** The sorted runs written out, in the order of the records they came from. */
+  std::vector<std::unique_ptr<RunType>> runs_;
+  /** Whether Next() takes records from a merge of the runs. */
+  bool merging_{false};
+  std::vector<MergeSource> sources_;
+  std::priority_queue<size_t, std::vector<size_t>, HeadGreater> heads_{HeadGreater(this)};
+};
+
+}  // namespace bustub
@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -99,6 +102,28 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
+  /**
+   * Read a batch of tuples, fetching each page they are on once and the pages in order.
+   * @param rids rids of the tuples to read
+   * @param[out] tuples the tuples that exist, each with the position of its rid in rids
+   * @param txn transaction performing the read
+   * @param keep_order whether tuples are in the order of rids, rather than in the order they are stored in
+   * @return false if a page could not be fetched
+   */
+  bool GetTuples(const std::vector<RID> &rids, std::vector<std::pair<size_t, Tuple>> *tuples, Transaction *txn,
+                 bool keep_order = true);
+
+  /**
+   * Read every tuple of a page of the table, fetching the page once.
+   * @param page_id id of the page to read
+   * @param[out] tuples the tuples on the page, each with its rid, in slot order
+   * @param[out] next_page_id id of the page after it, INVALID_PAGE_ID for the last page
+   * @param txn transaction performing the read
+   * @return false if the page could not be fetched
+   */
+  bool GetPageTuples(page_id_t page_id, std::vector<std::pair<RID, Tuple>> *tuples, page_id_t *next_page_id,
+                     Transaction *txn);
+
   /** @return the begin iterator of this table */
   TableIterator Begin(Transaction *txn);
 
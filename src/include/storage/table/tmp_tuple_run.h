@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.h
+//
+// Identification: src/include/storage/table/tmp_tuple_run.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TmpTupleRun is a sequence of tuples an operator writes out to TmpTuplePage pages of the buffer pool, such as a
+ * partition of a hash join or a sorted run of a sort. The page being written stays pinned until Finish(); pages are
+ * read back in the order they were written, and deleted as they are read.
+ */
+class TmpTupleRun {
+ public:
+  explicit TmpTupleRun(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {}
+
+  ~TmpTupleRun();
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleRun);
+
+  /** Appends a tuple, starting a new page when the current one is full. */
+  void Append(const Tuple &tuple);
+
+  /** Gives back the page being written. Call once after the last Append(). */
+  void Finish();
+
+  /**
+   * Reads the tuples of the next page, in the order they were appended, and deletes the page.
+   * @return false once every page has been read
+   */
+  bool ReadPage(std::vector<Tuple> *tuples);
+
+  /** @return the number of tuples in the run */
+  size_t GetSize() const { return size_; }
+
+  /** @return the bytes of tuple data in the run */
+  size_t GetBytes() const { return bytes_; }
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  std::vector<page_id_t> page_ids_;
+  size_t next_page_{0};
+  /** The pinned page being written, nullptr if there is none. */
+  TmpTuplePage *page_{nullptr};
+  size_t size_{0};
+  size_t bytes_{0};
+};
+
+}  // namespace bustub
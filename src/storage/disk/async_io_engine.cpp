@@ -0,0 +1,348 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_io_engine.cpp
+//
+// Identification: src/storage/disk/async_io_engine.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/async_io_engine.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define BUSTUB_HAVE_IO_URING
+#endif
+#endif
+
+namespace bustub {
+
+AsyncIOEngine::AsyncIOEngine(int fd, size_t queue_depth, size_t num_workers, bool use_io_uring)
+    : fd_(fd), queue_depth_(queue_depth) {
+  // one spare entry for the no-op that wakes the reaper at shutdown
+  if (use_io_uring && SetupRing(queue_depth_ + 1)) {
+    reaper_ = std::thread(&AsyncIOEngine::ReapCompletions, this);
+    return;
+  }
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back(&AsyncIOEngine::ServeRequests, this);
+  }
+}
+
+AsyncIOEngine::~AsyncIOEngine() {
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    stopping_ = true;
+    if (UsingIoUring()) {
+      // the reaper may be asleep in the kernel with nothing in flight
+      Enqueue(nullptr, &lock);
+      SubmitLocked();
+    }
+  }
+  cv_.notify_all();
+  if (reaper_.joinable()) {
+    reaper_.join();
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  TearDownRing();
+}
+
+std::future<void> AsyncIOEngine::Read(char *data, size_t size, off_t offset, bool submit) {
+  auto *request = new Request{false, data, size, offset, {data, size}, {}};
+  auto future = request->promise_.get_future();
+  std::unique_lock<std::mutex> lock(latch_);
+  Enqueue(request, &lock);
+  if (submit) {
+    SubmitLocked();
+  }
+  return future;
+}
+
+std::future<void> AsyncIOEngine::Write(const char *data, size_t size, off_t offset, bool submit) {
+  // the buffer is only read from, the Request just shares its layout with reads
+  auto *buffer = const_cast<char *>(data);
+  auto *request = new Request{true, buffer, size, offset, {buffer, size}, {}};
+  auto future = request->promise_.get_future();
+  std::unique_lock<std::mutex> lock(latch_);
+  Enqueue(request, &lock);
+  if (submit) {
+    SubmitLocked();
+  }
+  return future;
+}
+
+void AsyncIOEngine::Submit() {
+  std::scoped_lock lock(latch_);
+  SubmitLocked();
+}
+
+void AsyncIOEngine::Enqueue(Request *request, std::unique_lock<std::mutex> *lock) {
+  if (request != nullptr) {
+    while (in_flight_ >= queue_depth_) {
+      // requests queued without submission would otherwise never free a slot
+      SubmitLocked();
+      cv_.wait(*lock);
+    }
+  }
+  in_flight_++;
+  if (!UsingIoUring()) {
+    pending_.push_back(request);
+    cv_.notify_all();
+    return;
+  }
+#ifdef BUSTUB_HAVE_IO_URING
+  // latch_ makes this the only producer, the kernel only reads the tail
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  auto *sqe = static_cast<struct io_uring_sqe *>(sqes_) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  if (request == nullptr) {
+    sqe->opcode = IORING_OP_NOP;
+  } else {
+    sqe->opcode = request->is_write_ ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(&request->iov_);
+    sqe->len = 1;
+    sqe->off = request->offset_;
+  }
+  sqe->user_data = reinterpret_cast<uint64_t>(request);
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  unsubmitted_++;
+#endif
+}
+
+void AsyncIOEngine::SubmitLocked() {
+#ifdef BUSTUB_HAVE_IO_URING
+  while (unsubmitted_ > 0) {
+    auto rc = syscall(__NR_io_uring_enter, ring_fd_, unsubmitted_, 0, 0, nullptr, 0);
+    if (rc < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        continue;
+      }
+      LOG_WARN("io_uring_enter failed to submit: %s", strerror(errno));
+      TakeBackUnsubmitted();
+      return;
+    }
+    unsubmitted_ -= static_cast<unsigned>(rc);
+  }
+#endif
+}
+
+void AsyncIOEngine::TakeBackUnsubmitted() {
+#ifdef BUSTUB_HAVE_IO_URING
+  // the kernel only looks at the submission queue inside io_uring_enter, which runs under latch_ as well, so the
+  // entries past the ones it consumed can be taken off the tail again
+  unsigned tail = *sq_tail_;
+  std::vector<Request *> requests;
+  for (unsigned i = unsubmitted_; i > 0; i--) {
+    auto *sqe = static_cast<struct io_uring_sqe *>(sqes_) + sq_array_[(tail - i) & *sq_mask_];
+    requests.push_back(reinterpret_cast<Request *>(sqe->user_data));
+  }
+  __atomic_store_n(sq_tail_, tail - unsubmitted_, __ATOMIC_RELEASE);
+  unsubmitted_ = 0;
+  for (auto *request : requests) {
+    if (request != nullptr) {
+      Resolve(request, TransferSync(request, 0));
+    }
+    in_flight_--;
+  }
+  cv_.notify_all();
+#endif
+}
+
+void AsyncIOEngine::ReapCompletions() {
+#ifdef BUSTUB_HAVE_IO_URING
+  while (true) {
+    // this thread is the only consumer, the kernel only reads the head
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      {
+        std::scoped_lock lock(latch_);
+        if (stopping_ && in_flight_ == 0) {
+          return;
+        }
+      }
+      syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+      continue;
+    }
+    auto *cqe = static_cast<struct io_uring_cqe *>(cqes_) + (head & *cq_mask_);
+    auto *request = reinterpret_cast<Request *>(cqe->user_data);
+    int res = cqe->res;
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    if (request == nullptr) {
+      std::scoped_lock lock(latch_);
+      in_flight_--;
+      continue;
+    }
+    Complete(request, res);
+  }
+#endif
+}
+
+void AsyncIOEngine::ServeRequests() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    cv_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+    if (pending_.empty()) {
+      return;
+    }
+    Request *request = pending_.front();
+    pending_.pop_front();
+    lock.unlock();
+    Complete(request, 0);
+    lock.lock();
+  }
+}
+
+void AsyncIOEngine::Complete(Request *request, int res) {
+  int err = 0;
+  if (res < 0) {
+    err = res == -EINTR || res == -EAGAIN ? TransferSync(request, 0) : -res;
+  } else if (static_cast<size_t>(res) < request->size_) {
+    // short transfer: end of file for a read, or the kernel stopped early
+    err = TransferSync(request, res);
+  }
+  Resolve(request, err);
+  {
+    std::scoped_lock lock(latch_);
+    in_flight_--;
+  }
+  cv_.notify_all();
+}
+
+void AsyncIOEngine::Resolve(Request *request, int err) {
+  if (err == 0) {
+    request->promise_.set_value();
+  } else {
+    std::string message = std::string("asynchronous ") + (request->is_write_ ? "write" : "read") + " at offset " +
+                          std::to_string(request->offset_) + " failed: " + strerror(err);
+    LOG_WARN("%s", message.c_str());
+    request->promise_.set_exception(std::make_exception_ptr(Exception(ExceptionType::IO, message)));
+  }
+  delete request;
+}
+
+int AsyncIOEngine::TransferSync(Request *request, size_t done) {
+  while (done < request->size_) {
+    ssize_t rc = request->is_write_
+                     ? pwrite(fd_, request->data_ + done, request->size_ - done, request->offset_ + done)
+                     : pread(fd_, request->data_ + done, request->size_ - done, request->offset_ + done);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc < 0) {
+      return errno;
+    }
+    // a write that makes no progress would loop forever
+    if (rc == 0 && request->is_write_) {
+      return EIO;
+    }
+    // end of file, the rest was never written
+    if (rc == 0) {
+      memset(request->data_ + done, 0, request->size_ - done);
+      return 0;
+    }
+    done += rc;
+  }
+  return 0;
+}
+
+bool AsyncIOEngine::SetupRing(size_t entries) {
+#ifdef BUSTUB_HAVE_IO_URING
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  auto ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (ring_fd < 0) {
+    return false;
+  }
+  ring_fd_ = ring_fd;
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                  IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    TearDownRing();
+    return false;
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+    cq_ring_size_ = 0;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                    IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      TearDownRing();
+      return false;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes_ == MAP_FAILED) {
+    sqes_ = nullptr;
+    TearDownRing();
+    return false;
+  }
+
+  auto *sq = static_cast<char *>(sq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  auto *cq = static_cast<char *>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void AsyncIOEngine::TearDownRing() {
+#ifdef BUSTUB_HAVE_IO_URING
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+    sqes_ = nullptr;
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  cq_ring_ = nullptr;
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = nullptr;
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+#endif
+}
+
+}  // namespace bustub
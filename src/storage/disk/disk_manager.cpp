@@ -10,10 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <new>
 #include <string>
 #include <thread>  // NOLINT
 
@@ -25,12 +31,31 @@ namespace bustub {
 
 static char *buffer_used;
 
+/** Direct I/O transfers straight between the device and memory, which must be aligned for it. */
+static bool IsPageAligned(const char *page_data) { return reinterpret_cast<uintptr_t>(page_data) % PAGE_SIZE == 0; }
+
+/** A page-aligned page of scratch memory, for direct I/O on behalf of an unaligned caller buffer. */
+struct AlignedPage {
+  AlignedPage() : data_(new (std::align_val_t(PAGE_SIZE)) char[PAGE_SIZE]) {}
+  ~AlignedPage() { ::operator delete[](data_, std::align_val_t(PAGE_SIZE)); }
+  AlignedPage(const AlignedPage &) = delete;
+  AlignedPage &operator=(const AlignedPage &) = delete;
+  char *data_;
+};
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), next_page_id_(0), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::string &db_file, DiskIOBackend backend)
+    : backend_(backend),
+      file_name_(db_file),
+      next_page_id_(0),
+      num_flushes_(0),
+      num_writes_(0),
+      num_reads_(0),
+      flush_log_(false),
+      flush_log_f_(nullptr) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -52,26 +77,55 @@ DiskManager::DiskManager(const std::string &db_file)
     }
   }
 
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
+  if (backend_ == DiskIOBackend::DIRECT) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    if (db_fd_ < 0 && errno == EINVAL) {
+      LOG_DEBUG("direct I/O is not supported for %s", db_file.c_str());
+      backend_ = DiskIOBackend::POSITIONAL;
+    }
+  }
+  if (backend_ == DiskIOBackend::POSITIONAL) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (backend_ == DiskIOBackend::FSTREAM) {
     db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
+    // directory or file does not exist
     if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+      db_io_.clear();
+      // create a new file
+      db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
+      db_io_.close();
+      // reopen with original mode
+      db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
     }
   }
+  if (backend_ == DiskIOBackend::FSTREAM ? !db_io_.is_open() : db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
   buffer_used = nullptr;
+  LoadFreeSpaceMap();
+}
+
+DiskManager::~DiskManager() {
+  async_io_.reset();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
 }
 
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
+  // outstanding asynchronous I/O finishes before the descriptor goes away
+  async_io_.reset();
+  if (db_fd_ >= 0 || db_io_.is_open()) {
+    WriteFileHeader();
+  }
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
   db_io_.close();
   log_io_.close();
 }
@@ -80,11 +134,48 @@ void DiskManager::ShutDown() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-  // set write cursor to offset
   num_writes_ += 1;
+  WriteBlock(GetPageOffset(page_id), page_data);
+}
+
+/**
+ * Read the contents of the specified page into the given memory area
+ */
+void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  num_reads_ += 1;
+  ReadBlock(GetPageOffset(page_id), page_data);
+}
+
+/**
+ * Private helper function to write PAGE_SIZE bytes at a file offset
+ */
+void DiskManager::WriteBlock(off_t offset, const char *data) {
+  if (backend_ == DiskIOBackend::DIRECT && !IsPageAligned(data)) {
+    AlignedPage bounce;
+    memcpy(bounce.data_, data, PAGE_SIZE);
+    WriteBlock(offset, bounce.data_);
+    return;
+  }
+  if (backend_ != DiskIOBackend::FSTREAM) {
+    size_t written = 0;
+    while (written < PAGE_SIZE) {
+      ssize_t rc = pwrite(db_fd_, data + written, PAGE_SIZE - written, offset + written);
+      if (rc < 0 && errno == EINTR) {
+        continue;
+      }
+      if (rc <= 0) {
+        LOG_DEBUG("I/O error while writing");
+        return;
+      }
+      written += rc;
+    }
+    return;
+  }
+
+  std::scoped_lock db_io_lock(db_io_latch_);
+  // set write cursor to offset
   db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  db_io_.write(data, PAGE_SIZE);
   // check for I/O error
   if (db_io_.bad()) {
     LOG_DEBUG("I/O error while writing");
@@ -95,18 +186,48 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
 }
 
 /**
- * Read the contents of the specified page into the given memory area
+ * Private helper function to read PAGE_SIZE bytes at a file offset, zeros past the end of the file
  */
-void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
+void DiskManager::ReadBlock(off_t offset, char *data) {
+  if (backend_ == DiskIOBackend::DIRECT && !IsPageAligned(data)) {
+    AlignedPage bounce;
+    ReadBlock(offset, bounce.data_);
+    memcpy(data, bounce.data_, PAGE_SIZE);
+    return;
+  }
+  if (backend_ != DiskIOBackend::FSTREAM) {
+    size_t read_count = 0;
+    while (read_count < PAGE_SIZE) {
+      ssize_t rc = pread(db_fd_, data + read_count, PAGE_SIZE - read_count, offset + read_count);
+      if (rc < 0 && errno == EINTR) {
+        continue;
+      }
+      if (rc < 0) {
+        LOG_DEBUG("I/O error while reading");
+        return;
+      }
+      // end of file, the rest of the page was never written
+      if (rc == 0) {
+        break;
+      }
+      read_count += rc;
+    }
+    if (read_count < PAGE_SIZE) {
+      memset(data + read_count, 0, PAGE_SIZE - read_count);
+    }
+    return;
+  }
+
+  std::scoped_lock db_io_lock(db_io_latch_);
   // check if read beyond file length
   if (offset > GetFileSize(file_name_)) {
     LOG_DEBUG("I/O error reading past end of file");
+    memset(data, 0, PAGE_SIZE);
     // std::cerr << "I/O error while reading" << std::endl;
   } else {
     // set read cursor to offset
     db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
+    db_io_.read(data, PAGE_SIZE);
     if (db_io_.bad()) {
       LOG_DEBUG("I/O error while reading");
       return;
@@ -117,9 +238,61 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
       LOG_DEBUG("Read less than a page");
       db_io_.clear();
       // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+      memset(data + read_count, 0, PAGE_SIZE - read_count);
+    }
+  }
+}
+
+/**
+ * Start reading the specified page, completing the returned future when done
+ */
+std::future<void> DiskManager::ReadPageAsync(page_id_t page_id, char *page_data, bool submit) {
+  if (backend_ == DiskIOBackend::FSTREAM || (backend_ == DiskIOBackend::DIRECT && !IsPageAligned(page_data))) {
+    std::promise<void> done;
+    ReadPage(page_id, page_data);
+    done.set_value();
+    return done.get_future();
+  }
+  num_reads_ += 1;
+  return GetAsyncIO()->Read(page_data, PAGE_SIZE, GetPageOffset(page_id), submit);
+}
+
+/**
+ * Start writing the specified page, completing the returned future when done
+ */
+std::future<void> DiskManager::WritePageAsync(page_id_t page_id, const char *page_data, bool submit) {
+  if (backend_ == DiskIOBackend::FSTREAM || (backend_ == DiskIOBackend::DIRECT && !IsPageAligned(page_data))) {
+    std::promise<void> done;
+    WritePage(page_id, page_data);
+    done.set_value();
+    return done.get_future();
+  }
+  num_writes_ += 1;
+  return GetAsyncIO()->Write(page_data, PAGE_SIZE, GetPageOffset(page_id), submit);
+}
+
+/**
+ * Submit the asynchronous I/O queued so far
+ */
+void DiskManager::SubmitAsync() {
+  if (backend_ != DiskIOBackend::FSTREAM) {
+    GetAsyncIO()->Submit();
+  }
+}
+
+/**
+ * Make all page writes durable
+ */
+void DiskManager::Sync() {
+  WriteFileHeader();
+  if (backend_ != DiskIOBackend::FSTREAM) {
+    if (fsync(db_fd_) != 0) {
+      LOG_DEBUG("I/O error while syncing");
     }
+    return;
   }
+  std::scoped_lock db_io_lock(db_io_latch_);
+  db_io_.flush();
 }
 
 /**
@@ -186,16 +359,258 @@ bool DiskManager::ReadLog(char *log_data, int size, int offset) {
 
 /**
  * Allocate new page (operations like create index/table)
- * For now just keep an increasing counter
+ * Reuse the deallocated page closest to the hint, or else extend the file
+ */
+page_id_t DiskManager::AllocatePage(page_id_t hint) {
+  std::scoped_lock lock(free_map_latch_);
+  if (num_free_pages_ == 0) {
+    return ExtendFile();
+  }
+  return TakeFreePage(FindFreePage(hint, 1, 0));
+}
+
+/**
+ * Allocate new page whose id is shard modulo num_shards
+ * Reuse the deallocated page of the shard closest to the hint, or else extend the file up to the next id of the shard;
+ * the ids skipped on the way are deallocated pages for later allocations to reuse
  */
-page_id_t DiskManager::AllocatePage() { return next_page_id_++; }
+page_id_t DiskManager::AllocatePage(page_id_t hint, size_t num_shards, size_t shard) {
+  std::scoped_lock lock(free_map_latch_);
+  if (num_free_pages_ > 0) {
+    page_id_t page_id = FindFreePage(hint, num_shards, shard);
+    if (page_id != INVALID_PAGE_ID) {
+      return TakeFreePage(page_id);
+    }
+  }
+  page_id_t page_id = ExtendFile();
+  if (static_cast<size_t>(page_id) % num_shards == shard) {
+    return page_id;
+  }
+  size_t first_group = page_id / PAGES_PER_FREE_MAP;
+  while (static_cast<size_t>(page_id) % num_shards != shard) {
+    MarkFree(page_id);
+    page_id = ExtendFile();
+  }
+  // the skipped pages span at most two groups, as a shard has an id in every num_shards ids
+  for (size_t group = first_group; group <= (page_id - 1) / PAGES_PER_FREE_MAP; group++) {
+    WriteFreeMap(group);
+  }
+  return page_id;
+}
 
 /**
  * Deallocate page (operations like drop index/table)
- * Need bitmap in header page for tracking pages
- * This does not actually need to do anything for now.
+ * Mark the page free in the free-space map of its group, so AllocatePage can hand it out again
  */
-void DiskManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {}
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  std::scoped_lock lock(free_map_latch_);
+  if (page_id < 0 || page_id >= next_page_id_) {
+    return;
+  }
+  if (MarkFree(page_id)) {
+    WriteFreeMap(page_id / PAGES_PER_FREE_MAP);
+  }
+}
+
+/**
+ * Returns number of deallocated pages waiting to be reused
+ */
+size_t DiskManager::GetNumFreePages() {
+  std::scoped_lock lock(free_map_latch_);
+  return num_free_pages_;
+}
+
+/**
+ * Returns where a page lives in the database file
+ * The file starts with the file header, then every group of PAGES_PER_FREE_MAP pages is preceded by its free-space map
+ */
+off_t DiskManager::GetPageOffset(page_id_t page_id) {
+  off_t group = page_id / PAGES_PER_FREE_MAP;
+  off_t block = 1 + group * (PAGES_PER_FREE_MAP + 1) + 1 + page_id % PAGES_PER_FREE_MAP;
+  return block * PAGE_SIZE;
+}
+
+/**
+ * Private helper function to extend the file by one page, free_map_latch_ must be held
+ */
+page_id_t DiskManager::ExtendFile() {
+  page_id_t page_id = next_page_id_++;
+  // a restart finds the pages of every group the header knows of, even if the header was not saved since
+  if (page_id % PAGES_PER_FREE_MAP == 0) {
+    WriteFileHeader();
+  }
+  return page_id;
+}
+
+/**
+ * Private helper function to take a free page, free_map_latch_ must be held
+ */
+page_id_t DiskManager::TakeFreePage(page_id_t page_id) {
+  free_map_[page_id / 64] &= ~(uint64_t{1} << (page_id % 64));
+  num_free_pages_--;
+  // the map has to say the page is taken before anyone writes to it, or a restart could hand it out twice
+  WriteFreeMap(page_id / PAGES_PER_FREE_MAP);
+  return page_id;
+}
+
+/**
+ * Private helper function to mark a page free in memory, free_map_latch_ must be held
+ * @return false if the page was free already
+ */
+bool DiskManager::MarkFree(page_id_t page_id) {
+  size_t group = page_id / PAGES_PER_FREE_MAP;
+  if (free_map_.size() < (group + 1) * WORDS_PER_FREE_MAP) {
+    free_map_.resize((group + 1) * WORDS_PER_FREE_MAP, 0);
+  }
+  uint64_t bit = uint64_t{1} << (page_id % 64);
+  if ((free_map_[page_id / 64] & bit) != 0) {
+    return false;
+  }
+  free_map_[page_id / 64] |= bit;
+  num_free_pages_++;
+  return true;
+}
+
+/**
+ * Private helper function to find the bits of a word of the free-space map that stand for pages of the shard
+ */
+uint64_t DiskManager::ShardMask(size_t word_idx, size_t num_shards, size_t shard) {
+  if (num_shards == 1) {
+    return ~uint64_t{0};
+  }
+  uint64_t mask = 0;
+  for (size_t bit = (shard + num_shards - word_idx * 64 % num_shards) % num_shards; bit < 64; bit += num_shards) {
+    mask |= uint64_t{1} << bit;
+  }
+  return mask;
+}
+
+/**
+ * Private helper function to find the free page of the shard closest to the hint, the lowest one without a hint
+ * @return INVALID_PAGE_ID if the shard has no free page
+ */
+page_id_t DiskManager::FindFreePage(page_id_t hint, size_t num_shards, size_t shard) {
+  size_t num_bits = free_map_.size() * 64;
+  size_t from = hint < 0 ? 0 : std::min<size_t>(hint, num_bits - 1);
+
+  // first free page at or after the hint
+  int64_t after = -1;
+  size_t word_idx = from / 64;
+  uint64_t word = free_map_[word_idx] & (~uint64_t{0} << (from % 64)) & ShardMask(word_idx, num_shards, shard);
+  while (true) {
+    if (word != 0) {
+      after = word_idx * 64 + __builtin_ctzll(word);
+      break;
+    }
+    if (++word_idx == free_map_.size()) {
+      break;
+    }
+    word = free_map_[word_idx] & ShardMask(word_idx, num_shards, shard);
+  }
+  if (hint < 0 || after == static_cast<int64_t>(from)) {
+    return after < 0 ? INVALID_PAGE_ID : static_cast<page_id_t>(after);
+  }
+
+  // last free page before the hint
+  int64_t before = -1;
+  if (from > 0) {
+    word_idx = (from - 1) / 64;
+    word = free_map_[word_idx] & (~uint64_t{0} >> (63 - (from - 1) % 64)) & ShardMask(word_idx, num_shards, shard);
+    while (true) {
+      if (word != 0) {
+        before = word_idx * 64 + 63 - __builtin_clzll(word);
+        break;
+      }
+      if (word_idx-- == 0) {
+        break;
+      }
+      word = free_map_[word_idx] & ShardMask(word_idx, num_shards, shard);
+    }
+  }
+  if (after < 0 && before < 0) {
+    return INVALID_PAGE_ID;
+  }
+  if (after < 0 || (before >= 0 && static_cast<int64_t>(from) - before < after - static_cast<int64_t>(from))) {
+    return static_cast<page_id_t>(before);
+  }
+  return static_cast<page_id_t>(after);
+}
+
+/**
+ * Private helper function to write the free-space map of one group of pages, free_map_latch_ must be held
+ */
+void DiskManager::WriteFreeMap(size_t group) {
+  WriteBlock(static_cast<off_t>(1 + group * (PAGES_PER_FREE_MAP + 1)) * PAGE_SIZE,
+             reinterpret_cast<const char *>(free_map_.data() + group * WORDS_PER_FREE_MAP));
+}
+
+/**
+ * Private helper function to write the file header, which records the next page id
+ * Sync(), ShutDown() and the start of every page group save it; on opening the file, the pages written since the last
+ * save are found from the size of the file
+ */
+void DiskManager::WriteFileHeader() {
+  AlignedPage header;
+  memset(header.data_, 0, PAGE_SIZE);
+  uint32_t magic = FILE_MAGIC;
+  page_id_t next_page_id = next_page_id_;
+  memcpy(header.data_, &magic, sizeof(magic));
+  memcpy(header.data_ + sizeof(magic), &next_page_id, sizeof(next_page_id));
+  WriteBlock(0, header.data_);
+}
+
+/**
+ * Private helper function to restore the next page id and the free-space maps of an existing file, or to start a new
+ * file with its header
+ * An existing file without a header is not a database file of this format and is left alone
+ */
+void DiskManager::LoadFreeSpaceMap() {
+  off_t file_size = GetFileSize(file_name_);
+  if (file_size <= 0) {
+    WriteFileHeader();
+    return;
+  }
+  AlignedPage header;
+  uint32_t magic = 0;
+  page_id_t next_page_id = 0;
+  ReadBlock(0, header.data_);
+  memcpy(&magic, header.data_, sizeof(magic));
+  memcpy(&next_page_id, header.data_ + sizeof(magic), sizeof(next_page_id));
+  if (magic != FILE_MAGIC) {
+    db_io_.close();
+    if (db_fd_ >= 0) {
+      close(db_fd_);
+      db_fd_ = -1;
+    }
+    throw Exception(ExceptionType::IO, file_name_ + " is not a database file, or was written by an older version");
+  }
+
+  // pages written after the header was last saved still extend the file, the last block tells the highest of them
+  off_t last_block = (file_size + PAGE_SIZE - 1) / PAGE_SIZE - 1;
+  if (last_block > 0) {
+    off_t group = (last_block - 1) / (PAGES_PER_FREE_MAP + 1);
+    off_t block_in_group = (last_block - 1) % (PAGES_PER_FREE_MAP + 1);
+    next_page_id = std::max<page_id_t>(next_page_id, group * PAGES_PER_FREE_MAP + block_in_group);
+  }
+  next_page_id_ = next_page_id;
+
+  size_t num_groups = (next_page_id + PAGES_PER_FREE_MAP - 1) / PAGES_PER_FREE_MAP;
+  free_map_.assign(num_groups * WORDS_PER_FREE_MAP, 0);
+  for (size_t group = 0; group < num_groups; group++) {
+    ReadBlock(static_cast<off_t>(1 + group * (PAGES_PER_FREE_MAP + 1)) * PAGE_SIZE,
+              reinterpret_cast<char *>(free_map_.data() + group * WORDS_PER_FREE_MAP));
+  }
+  // pages freed after the header was last saved may lie past the next page id, which hands them out anyway
+  if (next_page_id % 64 != 0) {
+    free_map_[next_page_id / 64] &= ~(~uint64_t{0} << (next_page_id % 64));
+  }
+  for (size_t i = (next_page_id + 63) / 64; i < free_map_.size(); i++) {
+    free_map_[i] = 0;
+  }
+  for (uint64_t word : free_map_) {
+    num_free_pages_ += __builtin_popcountll(word);
+  }
+}
 
 /**
  * Returns number of flushes made so far
@@ -207,18 +622,33 @@ int DiskManager::GetNumFlushes() const { return num_flushes_; }
  */
 int DiskManager::GetNumWrites() const { return num_writes_; }
 
+/**
+ * Returns number of Reads made so far
+ */
+int DiskManager::GetNumReads() const { return num_reads_; }
+
 /**
  * Returns true if the log is currently being flushed
  */
 bool DiskManager::GetFlushState() const { return flush_log_; }
 
+/**
+ * Private helper function to start the asynchronous I/O engine on first use
+ */
+AsyncIOEngine *DiskManager::GetAsyncIO() {
+  std::call_once(async_io_started_, [this] {
+    async_io_ = std::make_unique<AsyncIOEngine>(db_fd_, ASYNC_IO_QUEUE_DEPTH, ASYNC_IO_WORKERS);
+  });
+  return async_io_.get();
+}
+
 /**
  * Private helper function to get disk file size
  */
-int DiskManager::GetFileSize(const std::string &file_name) {
+off_t DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? stat_buf.st_size : -1;
 }
 
 }  // namespace bustub
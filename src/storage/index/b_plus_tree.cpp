@@ -9,7 +9,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/rid.h"
@@ -19,13 +23,29 @@
 namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, bool unique)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(internal_max_size),
+      unique_(unique),
+      posting_lists_(buffer_pool_manager) {
+  // a tree the header page has a root for is opened where it was left
+  Page *header = buffer_pool_manager_->FetchPage(HEADER_PAGE_ID);
+  if (header == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+  }
+  page_id_t root_page_id;
+  if (static_cast<HeaderPage *>(header)->GetRootId(index_name_, &root_page_id)) {
+    root_page_id_ = root_page_id;
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, false);
+  if (!unique_ && !IsEmpty()) {
+    RecoverPostingLists();
+  }
+}
 
 /*
  * Helper function to decide whether current b+tree is empty
@@ -37,21 +57,35 @@ bool BPLUSTREE_TYPE::IsEmpty() { return root_page_id_ == INVALID_PAGE_ID; }
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the values associated with input key, the only one of a unique tree
  * This method is used for point query
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  // readers only take latches once writers kept getting in the way
+  for (int attempt = 0; attempt < OPTIMISTIC_READ_RETRIES; attempt++) {
+    ValueType value;
+    bool found;
+    if (OptimisticLookup(key, &value, &found)) {
+      if (found && PostingLists::IsList(value)) {
+        // a posting list is read under the leaf latch, which keeps writers from moving it
+        break;
+      }
+      result->clear();
+      if (found) {
+        result->push_back(value);
+      }
+      return found;
+    }
+  }
   Page *leaf_page = FindLeafPage(key, false, OperationType::READ, transaction);
   assert(leaf_page != nullptr);
   LeafPage *leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
   ValueType temp;
+  result->clear();
   if (leaf_node->Lookup(key, &temp, comparator_)) {
-    result->resize(1);
-    (*result)[0] = temp;
-  } else {
-    result->resize(0);
+    PostingLists::Read(buffer_pool_manager_, temp, result);
   }
   if (transaction == nullptr) {
     buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
@@ -61,6 +95,79 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   return !result->empty();
 }
 
+/*
+ * Optimistic lock coupling: remember the version of a page, read it, and check
+ * the version is unchanged before trusting what was read. A child pointer is
+ * only followed once its parent validated, and the parent is validated again
+ * after the child's version is taken, so a split or merge of the child (which
+ * write latches the parent too) restarts the lookup. Pages stay pinned while
+ * they are read, so their frames cannot be reused under the reader.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::OptimisticLookup(const KeyType &key, ValueType *value, bool *found) {
+  page_id_t page_id = root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    *found = false;
+    return true;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    return false;
+  }
+  uint64_t version;
+  // a new root may have been put above this page since root_page_id_ was read
+  if (!page->ReadVersion(&version) || page_id != root_page_id_) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return false;
+  }
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (true) {
+    // a page read mid-update may hold any size, do not search past the ones the tree can have
+    int max_size = node->IsLeafPage() ? leaf_max_size_ : internal_max_size_;
+    if constexpr (IsPrefixCompressed<KeyComparator>::value) {
+      // the more its keys share, the more entries a prefix compressed page holds
+      max_size = node->IsLeafPage() ? LeafPage::Capacity(sizeof(KeyType)) : InternalPage::Capacity(sizeof(KeyType));
+    }
+    if (node->GetSize() < (node->IsLeafPage() ? 0 : 1) || node->GetSize() > max_size) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return false;
+    }
+    if (node->IsLeafPage()) {
+      break;
+    }
+    page_id_t child_id = reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_);
+    if (!page->ValidateVersion(version)) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return false;
+    }
+    Page *child_page = buffer_pool_manager_->FetchPage(child_id);
+    if (child_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return false;
+    }
+    uint64_t child_version;
+    bool valid = child_page->ReadVersion(&child_version) && page->ValidateVersion(version);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (!valid) {
+      buffer_pool_manager_->UnpinPage(child_id, false);
+      return false;
+    }
+    page_id = child_id;
+    page = child_page;
+    version = child_version;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  ValueType tmp;
+  bool in_leaf = reinterpret_cast<LeafPage *>(node)->Lookup(key, &tmp, comparator_);
+  bool valid = page->ValidateVersion(version);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  if (valid) {
+    *found = in_leaf;
+    *value = tmp;
+  }
+  return valid;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -116,8 +223,8 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
  * User needs to first find the right leaf page as insertion target, then look
  * through leaf page to see whether insert key exist or not. If exist, return
  * immdiately, otherwise insert entry. Remember to deal with split if necessary.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: if user try to insert a duplicate key into a unique tree return
+ * false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction,
@@ -128,10 +235,16 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
     return Insert(key, value, transaction);
   }
   LeafPage *leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
-  switch (ot) {
-    case OperationType::OPTIMISTIC_READ: {
-      ValueType tmp;
-      if (!leaf_node->Lookup(key, &tmp, comparator_)) {
+  ValueType existing;
+  if (leaf_node->Lookup(key, &existing, comparator_)) {
+    // a non-unique tree adds the value to the key's posting list, which leaves the leaf the same size
+    if (!unique_) {
+      leaf_node->SetValueAt(leaf_node->KeyIndex(key, comparator_), posting_lists_.Add(existing, value));
+      ret = true;
+    }
+  } else {
+    switch (ot) {
+      case OperationType::OPTIMISTIC_READ: {
         if (leaf_node->GetSize() + 1 < leaf_node->GetMaxSize()) {
           leaf_node->Insert(key, value, comparator_);
           ret = true;
@@ -143,22 +256,22 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
           }
           return InsertIntoLeaf(key, value, transaction, OperationType::INSERT);
         }
+        break;
       }
-      break;
-    }
 
-    case OperationType::INSERT: {
-      if (leaf_node->Insert(key, value, comparator_) >= leaf_node->GetMaxSize()) {
-        // remember to unpin split_page,unpin in insertintoparent
-        LeafPage *split_node = Split<LeafPage>(leaf_node);  // return newly allocated page
-        InsertIntoParent(leaf_node, split_node->KeyAt(0), split_node, transaction);
+      case OperationType::INSERT: {
+        if (leaf_node->Insert(key, value, comparator_) >= leaf_node->GetMaxSize()) {
+          // remember to unpin split_page,unpin in insertintoparent
+          LeafPage *split_node = Split<LeafPage>(leaf_node);  // return newly allocated page
+          InsertIntoParent(leaf_node, split_node->KeyAt(0), split_node, transaction);
+        }
+        ret = true;
+        break;
       }
-      ret = true;
-      break;
-    }
 
-    default:
-      assert(0);
+      default:
+        assert(0);
+    }
   }
   if (transaction == nullptr) {
     buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), true);
@@ -179,12 +292,14 @@ INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 N *BPLUSTREE_TYPE::Split(N *node) {
   page_id_t newid;
-  Page *split_page = buffer_pool_manager_->NewPage(&newid);
+  // siblings next to each other in the file make range scans sequential
+  Page *split_page = buffer_pool_manager_->NewPageNear(&newid, node->GetPageId());
   if (split_page == nullptr) {
     throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory.");
   }
   N *split_node = reinterpret_cast<N *>(split_page->GetData());
-  split_node->Init(newid, node->GetParentPageId(), node->GetMaxSize());
+  // the max size of a prefix compressed page follows its prefix, give the new page the one the tree was created with
+  split_node->Init(newid, node->GetParentPageId(), std::is_same_v<N, LeafPage> ? leaf_max_size_ : internal_max_size_);
   node->MoveHalfTo(split_node, buffer_pool_manager_);
   // remember unpin split_page after call Split
   return split_node;
@@ -205,7 +320,7 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
   if (old_node->IsRootPage()) {
     // get newroot
     page_id_t newrootId = -1;
-    Page *new_root_page = buffer_pool_manager_->NewPage(&newrootId);
+    Page *new_root_page = buffer_pool_manager_->NewPageNear(&newrootId, old_node->GetPageId());
     if (new_root_page == nullptr) {
       throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory.");
     }
@@ -241,6 +356,180 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
   buffer_pool_manager_->UnpinPage(parentId, true);
 }
 
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+/*
+ * Fill leaves left to right. Whenever a node is full the next entry opens a
+ * new node on its level, and the full node is handed to the level above,
+ * keyed by its least key (internal pages keep it in the ignored first slot).
+ * Only the last node of each level can end up short, so at the end it either
+ * merges into or borrows from the node before it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoad(const std::function<bool(KeyType *, ValueType *)> &next, double fill_factor,
+                              Transaction *transaction) {
+  KeyType key;
+  ValueType value;
+  if (!IsEmpty()) {
+    while (next(&key, &value)) {
+      Insert(key, value, transaction);
+    }
+    return;
+  }
+  std::vector<BulkLoadLevel> levels;
+  LeafPage *leaf = nullptr;
+  // the values of the last key appended, which a non-unique tree keeps in a posting list
+  std::vector<ValueType> values;
+  auto finish_key = [this, &leaf, &values]() {
+    if (values.size() > 1) {
+      leaf->SetValueAt(leaf->GetSize() - 1, posting_lists_.Make(values));
+    }
+    values.clear();
+  };
+  while (next(&key, &value)) {
+    if (leaf != nullptr && leaf->GetSize() > 0 && comparator_(leaf->KeyAt(leaf->GetSize() - 1), key) == 0) {
+      if (!unique_) {
+        values.push_back(value);
+      }
+      continue;
+    }
+    if (leaf != nullptr) {
+      finish_key();
+    }
+    leaf = BulkLoadTarget<LeafPage>(&levels, 0, key, fill_factor);
+    leaf->Append(key, value);
+    values.push_back(value);
+  }
+  if (leaf != nullptr) {
+    finish_key();
+  }
+  for (size_t level = 0; level < levels.size(); level++) {
+    if (level == 0) {
+      BulkLoadFinishLevel<LeafPage>(&levels, level, fill_factor);
+    } else {
+      BulkLoadFinishLevel<InternalPage>(&levels, level, fill_factor);
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::BulkLoadFill(const BPlusTreePage *node, double fill_factor) const {
+  // a node splits once it reaches max size
+  int max_fill = node->GetMaxSize() - 1;
+  int fill = static_cast<int>(fill_factor * max_fill + 0.5);
+  // an internal node with a single child would never stop the tree growing
+  return std::min(max_fill, std::max({fill, NonRootMinSize(node), node->IsLeafPage() ? 1 : 2}));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename N>
+N *BPLUSTREE_TYPE::BulkLoadTarget(std::vector<BulkLoadLevel> *levels, size_t level, const KeyType &key,
+                                   double fill_factor) {
+  constexpr bool is_leaf = std::is_same_v<N, LeafPage>;
+  if (level == levels->size()) {
+    levels->emplace_back();
+  }
+  Page *open_page = (*levels)[level].page_;
+  if (open_page != nullptr) {
+    N *open_node = reinterpret_cast<N *>(open_page->GetData());
+    if (open_node->GetSize() < BulkLoadFill(open_node, fill_factor)) {
+      return open_node;
+    }
+    if constexpr (IsPrefixCompressed<KeyComparator>::value) {
+      // the fences of a page are its least key and the least key of the page after it
+      open_node->SetFences(open_node->GetLowFence(), &key);
+    }
+  }
+  page_id_t hint = open_page != nullptr ? open_page->GetPageId() : (*levels)[level].prev_page_id_;
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPageNear(&page_id, hint);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory.");
+  }
+  N *node = reinterpret_cast<N *>(page->GetData());
+  node->Init(page_id, INVALID_PAGE_ID, is_leaf ? leaf_max_size_ : internal_max_size_);
+  (*levels)[level].page_ = page;
+  if (open_page != nullptr) {
+    if constexpr (IsPrefixCompressed<KeyComparator>::value) {
+      node->SetFences(&key, nullptr);
+    }
+    if constexpr (is_leaf) {
+      reinterpret_cast<LeafPage *>(open_page->GetData())->SetNextPageId(page_id);
+    }
+    (*levels)[level].prev_page_id_ = open_page->GetPageId();
+    BulkLoadAddChild(levels, level + 1, open_page, fill_factor);
+    buffer_pool_manager_->UnpinPage(open_page->GetPageId(), true);
+  }
+  return node;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoadAddChild(std::vector<BulkLoadLevel> *levels, size_t level, Page *child_page,
+                                      double fill_factor) {
+  auto *child = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
+  KeyType low_key = child->IsLeafPage() ? reinterpret_cast<LeafPage *>(child)->KeyAt(0)
+                                        : reinterpret_cast<InternalPage *>(child)->KeyAt(0);
+  InternalPage *parent = BulkLoadTarget<InternalPage>(levels, level, low_key, fill_factor);
+  parent->Append(low_key, child_page->GetPageId());
+  child->SetParentPageId(parent->GetPageId());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename N>
+void BPLUSTREE_TYPE::BulkLoadFinishLevel(std::vector<BulkLoadLevel> *levels, size_t level, double fill_factor) {
+  constexpr bool is_leaf = std::is_same_v<N, LeafPage>;
+  Page *page = (*levels)[level].page_;
+  N *node = reinterpret_cast<N *>(page->GetData());
+  page_id_t page_id = page->GetPageId();
+  (*levels)[level].page_ = nullptr;
+  page_id_t prev_page_id = (*levels)[level].prev_page_id_;
+  if (prev_page_id == INVALID_PAGE_ID) {
+    // the only node of the top level is the root, unless the level below merged into one node
+    if (!is_leaf && node->GetSize() == 1) {
+      page_id_t child_page_id = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+      Page *child_page = buffer_pool_manager_->FetchPage(child_page_id);
+      if (child_page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+      }
+      reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(INVALID_PAGE_ID);
+      buffer_pool_manager_->UnpinPage(child_page_id, true);
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      page_id = child_page_id;
+    } else {
+      buffer_pool_manager_->UnpinPage(page_id, true);
+    }
+    root_page_id_ = page_id;
+    UpdateRootPageId(1);
+    return;
+  }
+  int min_size = NonRootMinSize(node);
+  if (node->GetSize() < min_size) {
+    Page *prev_page = buffer_pool_manager_->FetchPage(prev_page_id);
+    if (prev_page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+    }
+    N *prev = reinterpret_cast<N *>(prev_page->GetData());
+    if (prev->GetSize() + node->GetSize() < std::min(node->GetMaxSize(), prev->GetMaxSize())) {
+      // the node before already has a parent, so the merged node needs nothing more
+      node->MoveAllTo(prev, node->KeyAt(0), buffer_pool_manager_);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      return;
+    }
+    // split the two evenly, as Split() does; with an odd internal max size neither half can reach min size
+    int half = (prev->GetSize() + node->GetSize()) / 2;
+    while (node->GetSize() < half) {
+      prev->MoveLastToFrontOf(node, node->KeyAt(0), buffer_pool_manager_);
+    }
+    buffer_pool_manager_->UnpinPage(prev_page_id, true);
+  }
+  BulkLoadAddChild(levels, level + 1, page, fill_factor);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -253,30 +542,64 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction, OperationType ot) {
+  RemoveEntry(key, nullptr, transaction, ot);
+}
+
+/*
+ * Delete one value of a key. While the key holds others too, only the key's
+ * posting list changes; with the last value the key goes as Remove() takes it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveValue(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  RemoveEntry(key, &value, transaction, OperationType::OPTIMISTIC_READ);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction,
+                                 OperationType ot) {
   // unpin leaf_page after findleafpage
   Page *leaf_page = FindLeafPage(key, false, ot, transaction);
   if (leaf_page == nullptr) {
     throw Exception(ExceptionType::OUT_OF_MEMORY, "Remove: not found in key.");
   }
   LeafPage *leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+  ValueType tmp;
+  bool found = leaf_node->Lookup(key, &tmp, comparator_);
+  if (found && value != nullptr && !(tmp == *value)) {
+    // the key stays, with whatever its posting list holds besides value
+    ValueType rest;
+    bool removed = PostingLists::IsList(tmp) && posting_lists_.Remove(tmp, *value, &rest);
+    if (removed) {
+      leaf_node->SetValueAt(leaf_node->KeyIndex(key, comparator_), rest);
+    }
+    if (transaction == nullptr) {
+      buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), removed);
+    } else {
+      transaction_aftermath(false, transaction);
+    }
+    return;
+  }
   // delete and check size
   switch (ot) {
     case OperationType::OPTIMISTIC_READ: {
-      ValueType tmp;
-      if (leaf_node->Lookup(key, &tmp, comparator_)) {
+      if (found) {
         if (leaf_node->GetSize() - 1 >= leaf_node->GetMinSize()) {
+          posting_lists_.Free(tmp);
           leaf_node->RemoveAndDeleteRecord(key, comparator_);
         } else {
           if (transaction != nullptr) {
             transaction_aftermath(false, transaction);
           }
-          return Remove(key, transaction, OperationType::DELETE);
+          return RemoveEntry(key, value, transaction, OperationType::DELETE);
         }
       }
       break;
     }
 
     case OperationType::DELETE: {
+      if (found) {
+        posting_lists_.Free(tmp);
+      }
       if (leaf_node->RemoveAndDeleteRecord(key, comparator_) < leaf_node->GetMinSize()) {
         CoalesceOrRedistribute<LeafPage>(leaf_node, transaction);
       }
@@ -325,8 +648,8 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
     transaction->AddIntoPageSet(sibling_page);
   }
   N *sibling_node = reinterpret_cast<N *>(sibling_page->GetData());
-  // coalesce
-  if (sibling_node->GetSize() + node->GetSize() < node->GetMaxSize()) {
+  // coalesce; a merged prefix compressed page keeps the shorter prefix of the two, and with it the smaller max size
+  if (sibling_node->GetSize() + node->GetSize() < std::min(node->GetMaxSize(), sibling_node->GetMaxSize())) {
     // let the first para in coalesce be prenode
     if (childIdx == 0) {
       // sibling delete
@@ -471,7 +794,7 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node, Transaction *trans
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
-  KeyType tmp;
+  KeyType tmp{};
   Page *left_leaf_page = FindLeafPage(tmp, true, OperationType::READ, nullptr);
   if (left_leaf_page == nullptr) {
     return INDEXITERATOR_TYPE(buffer_pool_manager_);
@@ -494,6 +817,18 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
   LeafPage *left_leaf_node = reinterpret_cast<LeafPage *>(left_leaf_page->GetData());
   //>= key
   int kv_idx = left_leaf_node->KeyIndex(key, comparator_);
+  if (kv_idx == left_leaf_node->GetSize()) {
+    // every key of the leaf is less than key, the first one that is not is on the next leaf
+    page_id_t next_page_id = left_leaf_node->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(left_leaf_page->GetPageId(), false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return INDEXITERATOR_TYPE(buffer_pool_manager_);
+    }
+    left_leaf_page = buffer_pool_manager_->FetchPage(next_page_id);
+    assert(left_leaf_page != nullptr);
+    left_leaf_node = reinterpret_cast<LeafPage *>(left_leaf_page->GetData());
+    kv_idx = 0;
+  }
   return INDEXITERATOR_TYPE(buffer_pool_manager_, kv_idx, left_leaf_node);
 }
 
@@ -508,6 +843,45 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() { return INDEXITERATOR_TYPE(buffer_pool
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+BPlusTreeStats BPLUSTREE_TYPE::GetStats() {
+  BPlusTreeStats stats;
+  std::vector<page_id_t> level;
+  if (!IsEmpty()) {
+    level.push_back(root_page_id_);
+  }
+  // one level at a time, top down
+  while (!level.empty()) {
+    stats.height_++;
+    std::vector<page_id_t> next_level;
+    for (page_id_t page_id : level) {
+      Page *page = buffer_pool_manager_->FetchPage(page_id);
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+      }
+      auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+      if (node->IsLeafPage()) {
+        stats.leaf_pages_++;
+        stats.entries_ += node->GetSize();
+      } else {
+        auto *internal = reinterpret_cast<InternalPage *>(node);
+        stats.internal_pages_++;
+        stats.children_ += internal->GetSize();
+        for (int i = 0; i < internal->GetSize(); i++) {
+          next_level.push_back(internal->ValueAt(i));
+        }
+      }
+      if constexpr (IsPrefixCompressed<KeyComparator>::value) {
+        stats.prefix_bytes_ += node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->GetPrefixSize()
+                                                  : reinterpret_cast<InternalPage *>(node)->GetPrefixSize();
+      }
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    level = std::move(next_level);
+  }
+  return stats;
+}
+
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
  * the left most leaf page
@@ -577,16 +951,43 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost, OperationT
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-  if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
-  } else {
+  // create a new record<index_name + root_page_id> in header_page, unless a tree that emptied out left one
+  if (insert_record == 0 || !header_page->InsertRecord(index_name_, root_page_id_)) {
     // update root_page_id in header_page
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
   buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
 }
 
+/*
+ * Hand the posting pages the leaves refer to back to posting_lists_, which
+ * only knows the pages with free slots it allocated itself
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RecoverPostingLists() {
+  std::unordered_set<page_id_t> posting_page_ids;
+  KeyType tmp{};
+  Page *page = FindLeafPage(tmp, true, OperationType::READ, nullptr);
+  while (true) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      const RID &value = leaf->GetItem(i).second;
+      if (PostingLists::IsList(value) && posting_page_ids.insert(value.GetPageId()).second) {
+        posting_lists_.Recover(value.GetPageId());
+      }
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    page = buffer_pool_manager_->FetchPage(next_page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+    }
+  }
+}
+
 /*
  * This method is used for test only
  * Read data from file and insert one by one
@@ -815,4 +1216,10 @@ template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTree<GenericKey<4>, RID, MemcmpComparator<4>>;
+template class BPlusTree<GenericKey<8>, RID, MemcmpComparator<8>>;
+template class BPlusTree<GenericKey<16>, RID, MemcmpComparator<16>>;
+template class BPlusTree<GenericKey<32>, RID, MemcmpComparator<32>>;
+template class BPlusTree<GenericKey<64>, RID, MemcmpComparator<64>>;
+
 }  // namespace bustub
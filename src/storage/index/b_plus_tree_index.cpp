@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/index/b_plus_tree_index.h"
+#include "storage/index/index_entry_sorter.h"
 
 namespace bustub {
 /*
@@ -18,14 +19,16 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
     : Index(metadata),
+      buffer_pool_manager_(buffer_pool_manager),
       comparator_(metadata->GetKeySchema()),
-      container_(metadata->GetName(), buffer_pool_manager, comparator_) {}
+      container_(metadata->GetName(), buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE,
+                 metadata->IsUnique()) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct insert index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  MakeIndexKey(key, comparator_, &index_key);
 
   container_.Insert(index_key, rid, transaction);
 }
@@ -34,20 +37,39 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  MakeIndexKey(key, comparator_, &index_key);
 
-  container_.Remove(index_key, transaction);
+  if (GetMetadata()->IsUnique()) {
+    container_.Remove(index_key, transaction);
+  } else {
+    container_.RemoveValue(index_key, rid, transaction);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  MakeIndexKey(key, comparator_, &index_key);
 
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BulkLoad(const std::function<bool(Tuple *, RID *)> &next, Transaction *transaction) {
+  IndexEntrySorter<KeyType, ValueType, KeyComparator> sorter(buffer_pool_manager_, comparator_);
+  Tuple key;
+  RID rid;
+  while (next(&key, &rid)) {
+    KeyType index_key;
+    MakeIndexKey(key, comparator_, &index_key);
+    sorter.Add(index_key, rid);
+  }
+  sorter.Finish();
+  container_.BulkLoad([&sorter](KeyType *index_key, ValueType *value) { return sorter.Next(index_key, value); },
+                      INDEX_FILL_FACTOR, transaction);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() { return container_.begin(); }
 
@@ -63,4 +85,10 @@ template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTreeIndex<GenericKey<4>, RID, MemcmpComparator<4>>;
+template class BPlusTreeIndex<GenericKey<8>, RID, MemcmpComparator<8>>;
+template class BPlusTreeIndex<GenericKey<16>, RID, MemcmpComparator<16>>;
+template class BPlusTreeIndex<GenericKey<32>, RID, MemcmpComparator<32>>;
+template class BPlusTreeIndex<GenericKey<64>, RID, MemcmpComparator<64>>;
+
 }  // namespace bustub
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key.cpp
+//
+// Identification: src/storage/index/generic_key.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/generic_key.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+/** Appends bytes to the key. */
+class KeyWriter {
+ public:
+  KeyWriter(char *data, size_t size) : data_(data), size_(size) {}
+
+  void PutByte(uint8_t byte) {
+    if (offset_ == size_) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "normalized key does not fit the key size.");
+    }
+    data_[offset_++] = static_cast<char>(byte);
+  }
+
+  /** Writes the low width bytes of value, most significant first. */
+  void PutBigEndian(uint64_t value, size_t width) {
+    for (size_t i = width; i > 0; i--) {
+      PutByte(static_cast<uint8_t>(value >> ((i - 1) * 8)));
+    }
+  }
+
+  /** Zeroes the rest of the key. */
+  void Pad() { memset(data_ + offset_, 0, size_ - offset_); }
+
+ private:
+  char *data_;
+  size_t size_;
+  size_t offset_{0};
+};
+
+// NULL sorts before every value
+constexpr uint8_t NULL_PREFIX = 0x00;
+constexpr uint8_t VALUE_PREFIX = 0x01;
+// a zero byte inside a varchar, told apart from the terminator
+constexpr uint8_t VARCHAR_ESCAPE = 0xFF;
+
+}  // namespace
+
+void NormalizeKey(const Tuple &tuple, const Schema *key_schema, char *data, size_t size) {
+  KeyWriter writer(data, size);
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    Value value = tuple.GetValue(key_schema, i);
+    if (value.IsNull()) {
+      writer.PutByte(NULL_PREFIX);
+      continue;
+    }
+    writer.PutByte(VALUE_PREFIX);
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+        writer.PutByte(static_cast<uint8_t>(value.GetAs<int8_t>()));
+        break;
+      // flipping the sign bit makes two's complement order as unsigned
+      case TypeId::TINYINT:
+        writer.PutBigEndian(static_cast<uint8_t>(value.GetAs<int8_t>()) ^ 0x80U, sizeof(int8_t));
+        break;
+      case TypeId::SMALLINT:
+        writer.PutBigEndian(static_cast<uint16_t>(value.GetAs<int16_t>()) ^ 0x8000U, sizeof(int16_t));
+        break;
+      case TypeId::INTEGER:
+        writer.PutBigEndian(static_cast<uint32_t>(value.GetAs<int32_t>()) ^ 0x80000000U, sizeof(int32_t));
+        break;
+      case TypeId::BIGINT:
+        writer.PutBigEndian(static_cast<uint64_t>(value.GetAs<int64_t>()) ^ (1ULL << 63), sizeof(int64_t));
+        break;
+      case TypeId::TIMESTAMP:
+        writer.PutBigEndian(value.GetAs<uint64_t>(), sizeof(uint64_t));
+        break;
+      case TypeId::DECIMAL: {
+        // -0.0 and 0.0 compare equal as values, so they get one encoding
+        double number = value.GetAs<double>() == 0 ? 0 : value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &number, sizeof(bits));
+        // negative numbers order backwards, positive ones only need to move above them
+        bits = (bits >> 63) != 0 ? ~bits : bits ^ (1ULL << 63);
+        writer.PutBigEndian(bits, sizeof(uint64_t));
+        break;
+      }
+      case TypeId::VARCHAR: {
+        const char *str = value.GetData();
+        // the stored length counts the trailing '\0'
+        uint32_t len = value.GetLength() - 1;
+        for (uint32_t j = 0; j < len; j++) {
+          writer.PutByte(static_cast<uint8_t>(str[j]));
+          if (str[j] == '\0') {
+            writer.PutByte(VARCHAR_ESCAPE);
+          }
+        }
+        writer.PutByte(0x00);
+        writer.PutByte(0x00);
+        break;
+      }
+      default:
+        UNREACHABLE("type cannot be part of an index key");
+    }
+  }
+  writer.Pad();
+}
+
+size_t NormalizedKeySize(const Schema *key_schema) {
+  size_t size = 0;
+  for (const Column &col : key_schema->GetColumns()) {
+    // the null/value byte, then the value; a varchar ends with two zero bytes
+    size += 1 + (col.GetType() == TypeId::VARCHAR ? col.GetVariableLength() + 2 : Type::GetTypeSize(col.GetType()));
+  }
+  return size;
+}
+
+}  // namespace bustub
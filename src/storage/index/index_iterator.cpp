@@ -2,6 +2,7 @@
  * index_iterator.cpp
  */
 #include <cassert>
+#include <utility>
 
 #include "storage/index/index_iterator.h"
 
@@ -13,7 +14,11 @@ namespace bustub {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, int idx, B_PLUS_TREE_LEAF_PAGE_TYPE *leaf)
-    : buffer_pool_manager_(buffer_pool_manager), kv_idx(idx), leaf_node(leaf) {}
+    : buffer_pool_manager_(buffer_pool_manager), kv_idx(idx), leaf_node(leaf), read_ahead_(buffer_pool_manager) {
+  if (leaf_node != nullptr) {
+    read_ahead_.OnPage(leaf_node->GetPageId(), leaf_node->GetNextPageId());
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() {
@@ -22,6 +27,45 @@ INDEXITERATOR_TYPE::~IndexIterator() {
   }
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : buffer_pool_manager_(other.buffer_pool_manager_),
+      kv_idx(other.kv_idx),
+      leaf_node(other.leaf_node),
+      item_(other.item_),
+      postings_(std::move(other.postings_)),
+      posting_idx_(other.posting_idx_),
+      read_ahead_(other.buffer_pool_manager_) {
+  other.kv_idx = -1;
+  other.leaf_node = nullptr;
+  if (leaf_node != nullptr) {
+    read_ahead_.OnPage(leaf_node->GetPageId(), leaf_node->GetNextPageId());
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  if (leaf_node != nullptr && buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
+  }
+  buffer_pool_manager_ = other.buffer_pool_manager_;
+  kv_idx = other.kv_idx;
+  leaf_node = other.leaf_node;
+  item_ = other.item_;
+  postings_ = std::move(other.postings_);
+  posting_idx_ = other.posting_idx_;
+  other.kv_idx = -1;
+  other.leaf_node = nullptr;
+  read_ahead_.Reset(buffer_pool_manager_);
+  if (leaf_node != nullptr) {
+    read_ahead_.OnPage(leaf_node->GetPageId(), leaf_node->GetNextPageId());
+  }
+  return *this;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::isEnd() {
   return leaf_node == nullptr;
@@ -30,14 +74,26 @@ bool INDEXITERATOR_TYPE::isEnd() {
 
 INDEX_TEMPLATE_ARGUMENTS
 const MappingType &INDEXITERATOR_TYPE::operator*() {
-  assert(leaf_node != nullptr && kv_idx >= 0 && kv_idx < static_cast<int>(LEAF_PAGE_SIZE));
-  return leaf_node->GetItem(kv_idx);
+  assert(leaf_node != nullptr && kv_idx >= 0 && kv_idx < leaf_node->GetSize());
+  // a prefix compressed leaf holds no whole entry to point at
+  item_ = leaf_node->GetItem(kv_idx);
+  LoadPostings();
+  if (!postings_.empty()) {
+    item_.second = postings_[posting_idx_];
+  }
+  return item_;
   // throw std::runtime_error("unimplemented");
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
   assert(leaf_node != nullptr);
+  LoadPostings();
+  if (++posting_idx_ < postings_.size()) {
+    return *this;
+  }
+  postings_.clear();
+  posting_idx_ = 0;
   kv_idx++;
   if (kv_idx < leaf_node->GetSize()) {
     return *this;
@@ -52,11 +108,22 @@ INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
   Page *pe = buffer_pool_manager_->FetchPage(next_page);
   assert(pe != nullptr);
   leaf_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(pe->GetData());
+  read_ahead_.OnPage(next_page, leaf_node->GetNextPageId());
   kv_idx = 0;
   return *this;
   // throw std::runtime_error("unimplemented");
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::LoadPostings() {
+  if (postings_.empty() && kv_idx < leaf_node->GetSize()) {
+    ValueType value = leaf_node->GetItem(kv_idx).second;
+    if (PostingLists::IsList(value)) {
+      PostingLists::Read(buffer_pool_manager_, value, &postings_);
+    }
+  }
+}
+
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
 template class IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
@@ -67,4 +134,14 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<GenericKey<4>, RID, MemcmpComparator<4>>;
+
+template class IndexIterator<GenericKey<8>, RID, MemcmpComparator<8>>;
+
+template class IndexIterator<GenericKey<16>, RID, MemcmpComparator<16>>;
+
+template class IndexIterator<GenericKey<32>, RID, MemcmpComparator<32>>;
+
+template class IndexIterator<GenericKey<64>, RID, MemcmpComparator<64>>;
+
 }  // namespace bustub
@@ -0,0 +1,325 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posting_lists.cpp
+//
+// Identification: src/storage/index/posting_lists.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/posting_lists.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+BPlusTreePostingPage *AsPosting(Page *page) { return reinterpret_cast<BPlusTreePostingPage *>(page->GetData()); }
+}  // namespace
+
+uint32_t PostingLists::SlotCapacity(size_t size_class) {
+  return std::min<uint32_t>(2U << size_class, BPlusTreePostingPage::MAX_SLOT_CAPACITY);
+}
+
+size_t PostingLists::SizeClassFor(size_t size) {
+  size_t size_class = 0;
+  while (size_class + 1 < NUM_SIZE_CLASSES && SlotCapacity(size_class) < size) {
+    size_class++;
+  }
+  return size_class;
+}
+
+Page *PostingLists::FetchPage(BufferPoolManager *buffer_pool_manager, page_id_t page_id) {
+  Page *page = buffer_pool_manager->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+  }
+  return page;
+}
+
+void PostingLists::Read(BufferPoolManager *buffer_pool_manager, const RID &value, std::vector<RID> *rids) {
+  if (!IsList(value)) {
+    rids->push_back(value);
+    return;
+  }
+  uint32_t slot = SlotOf(value);
+  for (page_id_t page_id = value.GetPageId(); page_id != INVALID_PAGE_ID;) {
+    Page *page = FetchPage(buffer_pool_manager, page_id);
+    page->RLatch();
+    auto *posting = AsPosting(page);
+    rids->insert(rids->end(), posting->GetRids(slot), posting->GetRids(slot) + posting->GetSize(slot));
+    page_id_t next_page_id = posting->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    // overflow pages hold their part of the list in their only slot
+    page_id = next_page_id;
+    slot = 0;
+  }
+}
+
+RID PostingLists::Make(const std::vector<RID> &rids) {
+  assert(!rids.empty());
+  return rids.size() == 1 ? rids[0] : Store(rids);
+}
+
+RID PostingLists::Store(const std::vector<RID> &rids) {
+  assert(rids.size() > 1);
+  size_t size_class = SizeClassFor(rids.size());
+  uint32_t slot;
+  Page *page = AllocateSlot(size_class, &slot);
+  auto *posting = AsPosting(page);
+  auto count = static_cast<uint32_t>(std::min<size_t>(rids.size(), posting->GetSlotCapacity()));
+  memcpy(static_cast<void *>(posting->GetRids(slot)), rids.data(), count * sizeof(RID));
+  posting->SetSize(slot, count);
+
+  // the rest fills overflow pages, of which only the first may have room left
+  const uint32_t capacity = BPlusTreePostingPage::MAX_SLOT_CAPACITY;
+  size_t partial = (rids.size() - count) % capacity;
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  for (size_t end = rids.size(); end > count + partial; end -= capacity) {
+    next_page_id = NewOverflowPage(rids.data() + end - capacity, capacity, next_page_id);
+  }
+  if (partial > 0) {
+    next_page_id = NewOverflowPage(rids.data() + count, static_cast<uint32_t>(partial), next_page_id);
+  }
+  posting->SetNextPageId(next_page_id);
+
+  RID reference = Reference(posting->GetPageId(), slot);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  return reference;
+}
+
+RID PostingLists::Add(const RID &value, const RID &rid) {
+  if (!IsList(value)) {
+    return value == rid ? value : Store({value, rid});
+  }
+  uint32_t slot = SlotOf(value);
+  Page *page = FetchPage(buffer_pool_manager_, value.GetPageId());
+  page->WLatch();
+  auto *posting = AsPosting(page);
+  uint32_t size = posting->GetSize(slot);
+  if (size < posting->GetSlotCapacity()) {
+    posting->GetRids(slot)[size] = rid;
+    posting->SetSize(slot, size + 1);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    return value;
+  }
+
+  if (posting->GetSlotCapacity() < BPlusTreePostingPage::MAX_SLOT_CAPACITY) {
+    // move to a slot twice the size
+    std::vector<RID> rids(posting->GetRids(slot), posting->GetRids(slot) + size);
+    rids.push_back(rid);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    RID reference = Store(rids);
+    Free(value);
+    return reference;
+  }
+
+  // the first overflow page is the only one that may have room, else a new one goes in front of it
+  page_id_t first_page_id = posting->GetNextPageId();
+  if (first_page_id != INVALID_PAGE_ID) {
+    Page *first_page = FetchPage(buffer_pool_manager_, first_page_id);
+    first_page->WLatch();
+    auto *first = AsPosting(first_page);
+    uint32_t first_size = first->GetSize(0);
+    bool has_room = first_size < first->GetSlotCapacity();
+    if (has_room) {
+      first->GetRids(0)[first_size] = rid;
+      first->SetSize(0, first_size + 1);
+    }
+    first_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(first_page_id, has_room);
+    if (has_room) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return value;
+    }
+  }
+  posting->SetNextPageId(NewOverflowPage(&rid, 1, first_page_id));
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  return value;
+}
+
+bool PostingLists::Remove(const RID &value, const RID &rid, RID *rest) {
+  assert(IsList(value));
+  uint32_t slot = SlotOf(value);
+  Page *page = FetchPage(buffer_pool_manager_, value.GetPageId());
+  page->WLatch();
+  auto *posting = AsPosting(page);
+  page_id_t first_page_id = posting->GetNextPageId();
+
+  if (first_page_id == INVALID_PAGE_ID) {
+    RID *rids = posting->GetRids(slot);
+    uint32_t size = posting->GetSize(slot);
+    RID *found = std::find(rids, rids + size, rid);
+    if (found == rids + size) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return false;
+    }
+    *found = rids[--size];
+    posting->SetSize(slot, size);
+    *rest = value;
+    size_t size_class = SizeClassFor(posting->GetSlotCapacity());
+    if (size == 1 || (size_class > 0 && size <= SlotCapacity(size_class - 1) / 2)) {
+      // back into the leaf, or down to a smaller slot
+      std::vector<RID> left(rids, rids + size);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+      *rest = Make(left);
+      Free(value);
+      return true;
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    return true;
+  }
+
+  // The list has overflow pages. The hole rid leaves is filled with the last RID of the first overflow page, the only
+  // one that is not full, so that every other page stays full.
+  Page *first_page = FetchPage(buffer_pool_manager_, first_page_id);
+  first_page->WLatch();
+  auto *first = AsPosting(first_page);
+  uint32_t first_size = first->GetSize(0);
+  RID last = first->GetRids(0)[first_size - 1];
+  bool removed = false;
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID && !removed;) {
+    // the first overflow page, then the head, then the other overflow pages
+    Page *other_page = page_id == first_page_id ? first_page : page_id == page->GetPageId() ? page : nullptr;
+    if (other_page == nullptr) {
+      other_page = FetchPage(buffer_pool_manager_, page_id);
+      other_page->WLatch();
+    }
+    auto *other = AsPosting(other_page);
+    uint32_t other_slot = other_page == page ? slot : 0;
+    RID *rids = other->GetRids(other_slot);
+    RID *found = std::find(rids, rids + other->GetSize(other_slot), rid);
+    if (found != rids + other->GetSize(other_slot)) {
+      *found = last;
+      removed = true;
+    }
+    page_id_t next_page_id = page_id == first_page_id ? page->GetPageId()
+                             : other_page == page      ? first->GetNextPageId()
+                                                       : other->GetNextPageId();
+    if (other_page != first_page && other_page != page) {
+      other_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, removed);
+    }
+    page_id = next_page_id;
+  }
+  if (removed) {
+    first->SetSize(0, first_size - 1);
+    if (first_size == 1) {
+      posting->SetNextPageId(first->GetNextPageId());
+    }
+  }
+  first_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(first_page_id, removed);
+  if (removed && first_size == 1) {
+    buffer_pool_manager_->DeletePage(first_page_id);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+  *rest = value;
+  return removed;
+}
+
+void PostingLists::Free(const RID &value) {
+  if (!IsList(value)) {
+    return;
+  }
+  page_id_t next_page_id;
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    page_id_t page_id = value.GetPageId();
+    Page *page = FetchPage(buffer_pool_manager_, page_id);
+    page->WLatch();
+    auto *posting = AsPosting(page);
+    bool was_full = posting->IsFull();
+    next_page_id = posting->GetNextPageId();
+    posting->SetNextPageId(INVALID_PAGE_ID);
+    posting->FreeSlot(SlotOf(value));
+    bool empty = posting->GetNumUsed() == 0;
+    auto &free_pages = free_pages_[SizeClassFor(posting->GetSlotCapacity())];
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    if (empty) {
+      free_pages.erase(std::remove(free_pages.begin(), free_pages.end(), page_id), free_pages.end());
+      buffer_pool_manager_->DeletePage(page_id);
+    } else if (was_full) {
+      free_pages.push_back(page_id);
+    }
+  }
+  // overflow pages belong to the list alone
+  while (next_page_id != INVALID_PAGE_ID) {
+    Page *page = FetchPage(buffer_pool_manager_, next_page_id);
+    page_id_t page_id = next_page_id;
+    next_page_id = AsPosting(page)->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+}
+
+void PostingLists::Recover(page_id_t page_id) {
+  Page *page = FetchPage(buffer_pool_manager_, page_id);
+  auto *posting = AsPosting(page);
+  bool full = posting->IsFull();
+  size_t size_class = SizeClassFor(posting->GetSlotCapacity());
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  if (!full) {
+    std::lock_guard<std::mutex> guard(latch_);
+    free_pages_[size_class].push_back(page_id);
+  }
+}
+
+Page *PostingLists::AllocateSlot(size_t size_class, uint32_t *slot) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto &free_pages = free_pages_[size_class];
+  Page *page;
+  if (free_pages.empty()) {
+    page_id_t page_id;
+    page = buffer_pool_manager_->NewPage(&page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory.");
+    }
+    AsPosting(page)->Init(page_id, SlotCapacity(size_class));
+    free_pages.push_back(page_id);
+  } else {
+    page = FetchPage(buffer_pool_manager_, free_pages.back());
+  }
+  page->WLatch();
+  auto *posting = AsPosting(page);
+  *slot = posting->AllocateSlot();
+  if (posting->IsFull()) {
+    free_pages.pop_back();
+  }
+  return page;
+}
+
+page_id_t PostingLists::NewOverflowPage(const RID *rids, uint32_t count, page_id_t next_page_id) {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory.");
+  }
+  auto *posting = AsPosting(page);
+  posting->Init(page_id, BPlusTreePostingPage::MAX_SLOT_CAPACITY);
+  uint32_t slot = posting->AllocateSlot();
+  memcpy(static_cast<void *>(posting->GetRids(slot)), rids, count * sizeof(RID));
+  posting->SetSize(slot, count);
+  posting->SetNextPageId(next_page_id);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  return page_id;
+}
+
+}  // namespace bustub
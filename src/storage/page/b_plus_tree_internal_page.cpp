@@ -13,6 +13,7 @@
 #include <sstream>
 
 #include "common/exception.h"
+#include "storage/index/key_search.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 
 namespace bustub {
@@ -84,18 +85,9 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
-  int left = 1;
-  int right = GetSize() - 1;
-  // find right border
-  while (left <= right) {
-    int mid = (left + right) / 2;
-    if (comparator(key, array[mid].first) < 0) {
-      right = mid - 1;
-    } else {
-      left = mid + 1;
-    }
-  }
-  return array[right].second;
+  // the first key is invalid, follow the last pointer whose key is not greater than key
+  int idx = KeyUpperBound(array, 1, GetSize(), key, comparator);
+  return array[idx - 1].second;
 }
 
 /*****************************************************************************
@@ -197,6 +189,18 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() { return INVALID_PAGE_ID; }
+
+/*
+ * Append a child after the last one, keyed by the least key below it. The
+ * caller keeps the keys in order and sets the child's parent page id.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) {
+  assert(GetSize() < GetMaxSize() - 1);
+  array[GetSize()] = MappingType(key, value);
+  IncreaseSize(1);
+}
+
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
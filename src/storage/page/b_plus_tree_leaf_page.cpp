@@ -13,6 +13,7 @@
 #include <sstream>
 #include "common/exception.h"
 #include "common/rid.h"
+#include "storage/index/key_search.h"
 namespace bustub {
 
 /*****************************************************************************
@@ -50,22 +51,10 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_pa
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
-  int left = 0;
-  int right = GetSize() - 1;
-  // find right border
-  while (left <= right) {
-    int mid = (left + right) / 2;
-    if (comparator(array[mid].first, key) > 0) {
-      right = mid - 1;
-    } else if (comparator(array[mid].first, key) < 0) {
-      left = mid + 1;
-    } else {
-      return mid;
-    }
-  }
-  // maybe left == getsize(),
-  assert(left < GetMaxSize());
-  return left;
+  int idx = KeyLowerBound(array, 0, GetSize(), key, comparator);
+  // maybe idx == getsize(),
+  assert(idx < GetMaxSize());
+  return idx;
 }
 
 /*
@@ -90,6 +79,16 @@ const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
   return array[index];
 }
 
+/*
+ * Helper method to replace the value associated with input "index"(a.k.a
+ * array offset)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  assert(index >= 0 && index < GetSize());
+  array[index].second = value;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -101,13 +100,8 @@ INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
   assert(GetSize() + 1 <= GetMaxSize());
   int idx = KeyIndex(key, comparator);
-  if (comparator(array[idx].first, key) == 0) {
-    // check idx to avoid bugs,if size == 0,insert key with 0,comp equals,but we still need to insert,this doesn't mean
-    // duplicate
-    if (idx >= GetSize()) {
-      array[idx] = MappingType(key, value);
-      IncreaseSize(1);
-    }
+  // the slot at GetSize() holds no key, comparing it would decode whatever bytes are left there
+  if (idx < GetSize() && comparator(array[idx].first, key) == 0) {
     return GetSize();
   }
   // if idx == getsize(), means the key to insert is greater than any key in the leafnode
@@ -192,6 +186,15 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const
   return GetSize();
 }
 
+/*
+ * Append key & value pair after the last one. The caller keeps the keys in
+ * order and leaves the page short of a split.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) {
+  CopyLastFrom(MappingType(key, value));
+}
+
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
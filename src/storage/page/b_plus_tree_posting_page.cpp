@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_posting_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_posting_page.h"
+
+#include <cassert>
+
+namespace bustub {
+
+void BPlusTreePostingPage::Init(page_id_t page_id, uint32_t slot_capacity) {
+  assert(slot_capacity > 0 && slot_capacity <= MAX_SLOT_CAPACITY);
+  page_id_ = page_id;
+  next_page_id_ = INVALID_PAGE_ID;
+  slot_capacity_ = static_cast<uint16_t>(slot_capacity);
+  num_slots_ = static_cast<uint16_t>((PAGE_SIZE - HEADER_SIZE) / (sizeof(uint32_t) + slot_capacity * sizeof(RID)));
+  num_used_ = 0;
+  unused_ = 0;
+  for (uint32_t slot = 0; slot < num_slots_; slot++) {
+    SetSize(slot, 0);
+  }
+}
+
+uint32_t BPlusTreePostingPage::AllocateSlot() {
+  assert(!IsFull());
+  for (uint32_t slot = 0; slot < num_slots_; slot++) {
+    if (GetSize(slot) == 0) {
+      num_used_++;
+      return slot;
+    }
+  }
+  assert(false);
+  return 0;
+}
+
+void BPlusTreePostingPage::FreeSlot(uint32_t slot) {
+  assert(slot < num_slots_ && num_used_ > 0);
+  SetSize(slot, 0);
+  num_used_--;
+}
+
+}  // namespace bustub
@@ -0,0 +1,461 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_prefix_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_prefix_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_prefix_page.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * SHARED BY LEAF AND INTERNAL PAGES
+ *****************************************************************************/
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_PAGE_TYPE::InitPrefixPage(int max_size) {
+  assert(max_size > 0);
+  next_page_id_ = INVALID_PAGE_ID;
+  size_limit_ = max_size;
+  prefix_size_ = 0;
+  has_low_fence_ = false;
+  has_high_fence_ = false;
+  SetMaxSize(MaxSizeFor(0));
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_PAGE_TYPE::GetMinSize() const {
+  int max_size = std::min(size_limit_, Capacity(0));
+  if (IsLeafPage()) {
+    return IsRootPage() ? 1 : max_size / 2;
+  }
+  return IsRootPage() ? 2 : (max_size + 1) / 2;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+GenericKey<KeySize> B_PLUS_TREE_PREFIX_PAGE_TYPE::KeyAt(int index) const {
+  assert(index >= 0 && index < GetSize());
+  KeyType key;
+  memcpy(key.data_, low_fence_.data_, PrefixSize());
+  memcpy(key.data_ + PrefixSize(), data_ + index * EntrySize(), SuffixSize());
+  return key;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_PREFIX_PAGE_TYPE::ValueAt(int index) const {
+  ValueType value;
+  memcpy(static_cast<void *>(&value), data_ + index * EntrySize() + SuffixSize(), sizeof(ValueType));
+  return value;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_PAGE_TYPE::SetFences(const KeyType *low_fence, const KeyType *high_fence) {
+  SetEntries(GetEntries(), low_fence, high_fence);
+}
+
+/*
+ * Binary search over the suffixes. A key that does not start with the prefix
+ * sorts before or after every key of the page.
+ */
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+template <bool Upper>
+int B_PLUS_TREE_PREFIX_PAGE_TYPE::KeyBound(const KeyType &key, int begin) const {
+  int end = std::max(begin, std::min(GetSize(), Capacity(PrefixSize())));
+  int cmp = memcmp(key.data_, low_fence_.data_, PrefixSize());
+  if (cmp != 0) {
+    return cmp < 0 ? begin : end;
+  }
+  const char *suffix = key.data_ + PrefixSize();
+  while (begin < end) {
+    int mid = begin + (end - begin) / 2;
+    cmp = memcmp(data_ + mid * EntrySize(), suffix, SuffixSize());
+    if (cmp < 0 || (Upper && cmp == 0)) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_PREFIX_PAGE_TYPE::KeyEquals(int index, const KeyType &key) const {
+  return SharesPrefix(key) && memcmp(data_ + index * EntrySize(), key.data_ + PrefixSize(), SuffixSize()) == 0;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_PREFIX_PAGE_TYPE::SharesPrefix(const KeyType &key) const {
+  return memcmp(key.data_, low_fence_.data_, PrefixSize()) == 0;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_PAGE_TYPE::WriteEntry(int index, const KeyType &key, const ValueType &value) {
+  // the first key of an internal page is never looked at, it may lie outside the fences
+  assert((!IsLeafPage() && index == 0) || SharesPrefix(key));
+  char *entry = data_ + index * EntrySize();
+  memcpy(entry, key.data_ + PrefixSize(), SuffixSize());
+  memcpy(entry + SuffixSize(), static_cast<const void *>(&value), sizeof(ValueType));
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_PAGE_TYPE::SetKey(int index, const KeyType &key) {
+  assert(index >= 0 && index < GetSize());
+  WriteEntry(index, key, ValueAt(index));
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_PAGE_TYPE::SetValue(int index, const ValueType &value) {
+  assert(index >= 0 && index < GetSize());
+  memcpy(data_ + index * EntrySize() + SuffixSize(), static_cast<const void *>(&value), sizeof(ValueType));
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  assert(index >= 0 && index <= GetSize() && GetSize() < Capacity(PrefixSize()));
+  char *entry = data_ + index * EntrySize();
+  memmove(entry + EntrySize(), entry, (GetSize() - index) * EntrySize());
+  WriteEntry(index, key, value);
+  IncreaseSize(1);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_PAGE_TYPE::RemoveAt(int index) {
+  assert(index >= 0 && index < GetSize());
+  char *entry = data_ + index * EntrySize();
+  memmove(entry, entry + EntrySize(), (GetSize() - index - 1) * EntrySize());
+  IncreaseSize(-1);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+std::vector<std::pair<GenericKey<KeySize>, ValueType>> B_PLUS_TREE_PREFIX_PAGE_TYPE::GetEntries() const {
+  std::vector<EntryType> entries;
+  entries.reserve(GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    entries.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  return entries;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_PAGE_TYPE::SetEntries(const std::vector<EntryType> &entries, const KeyType *low_fence,
+                                              const KeyType *high_fence) {
+  // the fences may be this page's own
+  has_low_fence_ = low_fence != nullptr;
+  has_high_fence_ = high_fence != nullptr;
+  KeyType low = has_low_fence_ ? *low_fence : KeyType();
+  KeyType high = has_high_fence_ ? *high_fence : KeyType();
+  low_fence_ = low;
+  high_fence_ = high;
+  int prefix_size = 0;
+  if (has_low_fence_ && has_high_fence_) {
+    assert(memcmp(low.data_, high.data_, KeySize) < 0);
+    while (prefix_size < static_cast<int>(KeySize) && low.data_[prefix_size] == high.data_[prefix_size]) {
+      prefix_size++;
+    }
+  }
+  prefix_size_ = prefix_size;
+  SetMaxSize(MaxSizeFor(prefix_size));
+  assert(static_cast<int>(entries.size()) <= Capacity(prefix_size));
+  SetSize(static_cast<int>(entries.size()));
+  for (size_t i = 0; i < entries.size(); i++) {
+    WriteEntry(static_cast<int>(i), entries[i].first, entries[i].second);
+  }
+}
+
+/*****************************************************************************
+ * LEAF PAGE
+ *****************************************************************************/
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  this->SetPageType(IndexPageType::LEAF_PAGE);
+  this->SetSize(0);
+  this->SetPageId(page_id);
+  this->SetParentPageId(parent_id);
+  this->InitPrefixPage(max_size);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::GetNextPageId() const {
+  return this->next_page_id_;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
+  this->next_page_id_ = next_page_id;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  return this->template KeyBound<false>(key, 0);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+std::pair<GenericKey<KeySize>, ValueType> B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::GetItem(int index) const {
+  return {this->KeyAt(index), this->ValueAt(index)};
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value,
+                                              const KeyComparator &comparator) {
+  assert(this->GetSize() + 1 <= this->GetMaxSize());
+  int idx = KeyIndex(key, comparator);
+  if (idx < this->GetSize() && this->KeyEquals(idx, key)) {
+    return this->GetSize();
+  }
+  this->InsertAt(idx, key, value);
+  return this->GetSize();
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value,
+                                               const KeyComparator &comparator) const {
+  int idx = KeyIndex(key, comparator);
+  if (idx == this->GetSize() || !this->KeyEquals(idx, key)) {
+    return false;
+  }
+  *value = this->ValueAt(idx);
+  return true;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
+  int idx = KeyIndex(key, comparator);
+  if (idx < this->GetSize() && this->KeyEquals(idx, key)) {
+    this->RemoveAt(idx);
+  }
+  return this->GetSize();
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) {
+  assert(this->GetSize() + 1 < this->GetMaxSize());
+  this->InsertAt(this->GetSize(), key, value);
+}
+
+/*
+ * The first key moved is the separator of the two pages, the fence they now
+ * share.
+ */
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient,
+                                                   BufferPoolManager *buffer_pool_manager) {
+  assert(this->GetSize() == this->GetMaxSize());
+  auto entries = this->GetEntries();
+  auto off = entries.size() / 2;
+  KeyType separator = entries[off].first;
+  recipient->SetEntries({entries.begin() + off, entries.end()}, &separator, this->GetHighFence());
+  this->SetEntries({entries.begin(), entries.begin() + off}, this->GetLowFence(), &separator);
+  recipient->SetNextPageId(GetNextPageId());
+  SetNextPageId(recipient->GetPageId());
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient, const KeyType &middle_key,
+                                                  BufferPoolManager *buffer_pool_manager) {
+  assert(this->GetSize() + recipient->GetSize() < std::min(this->GetMaxSize(), recipient->GetMaxSize()));
+  auto entries = recipient->GetEntries();
+  auto moved = this->GetEntries();
+  entries.insert(entries.end(), moved.begin(), moved.end());
+  recipient->SetEntries(entries, recipient->GetLowFence(), this->GetHighFence());
+  this->SetSize(0);
+  recipient->SetNextPageId(GetNextPageId());
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient, const KeyType &middle_key,
+                                                         BufferPoolManager *buffer_pool_manager) {
+  auto entries = this->GetEntries();
+  auto recipient_entries = recipient->GetEntries();
+  recipient_entries.push_back(entries.front());
+  entries.erase(entries.begin());
+  KeyType separator = entries.front().first;
+  recipient->SetEntries(recipient_entries, recipient->GetLowFence(), &separator);
+  this->SetEntries(entries, &separator, this->GetHighFence());
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient, const KeyType &middle_key,
+                                                          BufferPoolManager *buffer_pool_manager) {
+  auto entries = this->GetEntries();
+  auto recipient_entries = recipient->GetEntries();
+  recipient_entries.insert(recipient_entries.begin(), entries.back());
+  entries.pop_back();
+  KeyType separator = recipient_entries.front().first;
+  this->SetEntries(entries, this->GetLowFence(), &separator);
+  recipient->SetEntries(recipient_entries, &separator, recipient->GetHighFence());
+}
+
+/*****************************************************************************
+ * INTERNAL PAGE
+ *****************************************************************************/
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  this->SetPageType(IndexPageType::INTERNAL_PAGE);
+  this->SetSize(0);
+  this->SetPageId(page_id);
+  this->SetParentPageId(parent_id);
+  this->InitPrefixPage(max_size);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  this->SetKey(index, key);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
+  for (int i = 0; i < this->GetSize(); i++) {
+    if (this->ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
+  // the first key is invalid, follow the last pointer whose key is not greater than key
+  int idx = this->template KeyBound<true>(key, 1);
+  return this->ValueAt(idx - 1);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                                            const ValueType &new_value) {
+  this->SetEntries({{new_key, old_value}, {new_key, new_value}}, nullptr, nullptr);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
+                                                           const ValueType &new_value) {
+  assert(this->GetSize() + 1 <= this->GetMaxSize());
+  this->InsertAt(ValueIndex(old_value) + 1, new_key, new_value);
+  return this->GetSize();
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::Remove(int index) {
+  this->RemoveAt(index);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() {
+  assert(this->GetSize() == 1);
+  ValueType child = this->ValueAt(0);
+  this->SetSize(0);
+  return child;
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) {
+  assert(this->GetSize() < this->GetMaxSize() - 1);
+  this->InsertAt(this->GetSize(), key, value);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::Adopt(const std::vector<EntryType> &entries, size_t begin, size_t end,
+                                                  BufferPoolManager *buffer_pool_manager) {
+  for (size_t i = begin; i < end; i++) {
+    page_id_t child_page_id = entries[i].second;
+    Page *child_page = buffer_pool_manager->FetchPage(child_page_id);
+    if (child_page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+    }
+    reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(this->GetPageId());
+    buffer_pool_manager->UnpinPage(child_page_id, true);
+  }
+}
+
+/*
+ * The first key moved goes up to the parent as the separator of the two pages,
+ * the fence they now share; the recipient keeps it in its ignored first slot.
+ */
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient,
+                                                       BufferPoolManager *buffer_pool_manager) {
+  assert(this->GetSize() == this->GetMaxSize());
+  auto entries = this->GetEntries();
+  auto off = entries.size() / 2;
+  KeyType separator = entries[off].first;
+  recipient->SetEntries({entries.begin() + off, entries.end()}, &separator, this->GetHighFence());
+  this->SetEntries({entries.begin(), entries.begin() + off}, this->GetLowFence(), &separator);
+  recipient->Adopt(entries, off, entries.size(), buffer_pool_manager);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                                      BufferPoolManager *buffer_pool_manager) {
+  auto entries = recipient->GetEntries();
+  auto moved = this->GetEntries();
+  moved.front().first = middle_key;
+  entries.insert(entries.end(), moved.begin(), moved.end());
+  recipient->SetEntries(entries, recipient->GetLowFence(), this->GetHighFence());
+  recipient->Adopt(moved, 0, moved.size(), buffer_pool_manager);
+  this->SetSize(0);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient,
+                                                             const KeyType &middle_key,
+                                                             BufferPoolManager *buffer_pool_manager) {
+  auto entries = this->GetEntries();
+  auto recipient_entries = recipient->GetEntries();
+  recipient_entries.emplace_back(middle_key, entries.front().second);
+  entries.erase(entries.begin());
+  KeyType separator = entries.front().first;
+  recipient->SetEntries(recipient_entries, recipient->GetLowFence(), &separator);
+  this->SetEntries(entries, &separator, this->GetHighFence());
+  recipient->Adopt(recipient_entries, recipient_entries.size() - 1, recipient_entries.size(), buffer_pool_manager);
+}
+
+PREFIX_PAGE_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient,
+                                                              const KeyType &middle_key,
+                                                              BufferPoolManager *buffer_pool_manager) {
+  auto entries = this->GetEntries();
+  auto recipient_entries = recipient->GetEntries();
+  recipient_entries.front().first = middle_key;
+  recipient_entries.insert(recipient_entries.begin(), entries.back());
+  entries.pop_back();
+  KeyType separator = recipient_entries.front().first;
+  this->SetEntries(entries, this->GetLowFence(), &separator);
+  recipient->SetEntries(recipient_entries, &separator, recipient->GetHighFence());
+  recipient->Adopt(recipient_entries, 0, 1, buffer_pool_manager);
+}
+
+template class BPlusTreePrefixPage<4, RID>;
+template class BPlusTreePrefixPage<8, RID>;
+template class BPlusTreePrefixPage<16, RID>;
+template class BPlusTreePrefixPage<32, RID>;
+template class BPlusTreePrefixPage<64, RID>;
+
+template class BPlusTreePrefixPage<4, page_id_t>;
+template class BPlusTreePrefixPage<8, page_id_t>;
+template class BPlusTreePrefixPage<16, page_id_t>;
+template class BPlusTreePrefixPage<32, page_id_t>;
+template class BPlusTreePrefixPage<64, page_id_t>;
+
+template class BPlusTreeLeafPage<GenericKey<4>, RID, MemcmpComparator<4>>;
+template class BPlusTreeLeafPage<GenericKey<8>, RID, MemcmpComparator<8>>;
+template class BPlusTreeLeafPage<GenericKey<16>, RID, MemcmpComparator<16>>;
+template class BPlusTreeLeafPage<GenericKey<32>, RID, MemcmpComparator<32>>;
+template class BPlusTreeLeafPage<GenericKey<64>, RID, MemcmpComparator<64>>;
+
+template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, MemcmpComparator<4>>;
+template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, MemcmpComparator<8>>;
+template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, MemcmpComparator<16>>;
+template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, MemcmpComparator<32>>;
+template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, MemcmpComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.cpp
+//
+// Identification: src/storage/page/hash_table_directory_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_directory_page.h"
+
+#include <unordered_map>
+
+namespace bustub {
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  assert(global_depth_ < MAX_DEPTH);
+  uint32_t size = Size();
+  for (uint32_t i = 0; i < size; i++) {
+    bucket_page_ids_[size + i] = bucket_page_ids_[i];
+    local_depths_[size + i] = local_depths_[i];
+  }
+  global_depth_++;
+}
+
+bool HashTableDirectoryPage::CanShrink() const {
+  if (global_depth_ == 0) {
+    return false;
+  }
+  for (uint32_t i = 0; i < Size(); i++) {
+    if (local_depths_[i] == global_depth_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HashTableDirectoryPage::DecrGlobalDepth() {
+  assert(CanShrink());
+  global_depth_--;
+}
+
+void HashTableDirectoryPage::VerifyIntegrity() const {
+  // every bucket is shared by 2^(global depth - local depth) slots, which all give it the same local depth
+  std::unordered_map<page_id_t, uint32_t> slots;
+  for (uint32_t i = 0; i < Size(); i++) {
+    assert(local_depths_[i] <= global_depth_);
+    assert(bucket_page_ids_[i] == bucket_page_ids_[i & ((1U << local_depths_[i]) - 1)]);
+    assert(local_depths_[i] == local_depths_[i & ((1U << local_depths_[i]) - 1)]);
+    slots[bucket_page_ids_[i]]++;
+  }
+  for (uint32_t i = 0; i < Size(); i++) {
+    assert(slots[bucket_page_ids_[i]] == 1U << (global_depth_ - local_depths_[i]));
+  }
+}
+
+}  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 
 #include "common/logger.h"
@@ -63,7 +64,8 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
       cur_page->WLatch();
     } else {
       // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
+      auto new_page =
+          static_cast<TablePage *>(buffer_pool_manager_->NewPageNear(&next_page_id, cur_page->GetTablePageId()));
       // If we could not create a new page,
       if (new_page == nullptr) {
         // Then life sucks and we abort the transaction.
@@ -169,6 +171,72 @@ bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
   return res;
 }
 
+bool TableHeap::GetTuples(const std::vector<RID> &rids, std::vector<std::pair<size_t, Tuple>> *tuples,
+                          Transaction *txn, bool keep_order) {
+  tuples->clear();
+  // Visit the rids by page, and within a page by slot.
+  std::vector<size_t> order(rids.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&rids](size_t lhs, size_t rhs) {
+    if (rids[lhs].GetPageId() != rids[rhs].GetPageId()) {
+      return rids[lhs].GetPageId() < rids[rhs].GetPageId();
+    }
+    return rids[lhs].GetSlotNum() != rids[rhs].GetSlotNum() ? rids[lhs].GetSlotNum() < rids[rhs].GetSlotNum()
+                                                            : lhs < rhs;
+  });
+  for (size_t begin = 0, end; begin < order.size(); begin = end) {
+    page_id_t page_id = rids[order[begin]].GetPageId();
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    // If the page could not be found, then abort the transaction.
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    // Read every tuple of the batch on the page while it is pinned.
+    page->RLatch();
+    for (end = begin; end < order.size() && rids[order[end]].GetPageId() == page_id; end++) {
+      Tuple tuple;
+      if (page->GetTuple(rids[order[end]], &tuple, txn, lock_manager_)) {
+        tuples->emplace_back(order[end], tuple);
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+  if (keep_order) {
+    std::sort(tuples->begin(), tuples->end(),
+              [](const std::pair<size_t, Tuple> &lhs, const std::pair<size_t, Tuple> &rhs) {
+                return lhs.first < rhs.first;
+              });
+  }
+  return true;
+}
+
+bool TableHeap::GetPageTuples(page_id_t page_id, std::vector<std::pair<RID, Tuple>> *tuples, page_id_t *next_page_id,
+                              Transaction *txn) {
+  tuples->clear();
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  // If the page could not be found, then abort the transaction.
+  if (page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  page->RLatch();
+  RID rid;
+  for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(rid, &rid)) {
+    Tuple tuple;
+    if (page->GetTuple(rid, &tuple, txn, lock_manager_)) {
+      tuples->emplace_back(rid, tuple);
+    }
+  }
+  *next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return true;
+}
+
 TableIterator TableHeap::Begin(Transaction *txn) {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
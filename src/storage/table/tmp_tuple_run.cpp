@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.cpp
+//
+// Identification: src/storage/table/tmp_tuple_run.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_run.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TmpTupleRun::~TmpTupleRun() {
+  Finish();
+  for (size_t i = next_page_; i < page_ids_.size(); i++) {
+    buffer_pool_manager_->DeletePage(page_ids_[i]);
+  }
+}
+
+void TmpTupleRun::Append(const Tuple &tuple) {
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  if (page_ == nullptr || !page_->Insert(tuple, &tmp_tuple)) {
+    Finish();
+    // keep the pages of a run close together, so that reading it back is sequential
+    page_id_t page_id;
+    page_ = reinterpret_cast<TmpTuplePage *>(
+        buffer_pool_manager_->NewPageNear(&page_id, page_ids_.empty() ? INVALID_PAGE_ID : page_ids_.back()));
+    if (page_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+    }
+    page_->Init(page_id, PAGE_SIZE);
+    page_ids_.push_back(page_id);
+    if (!page_->Insert(tuple, &tmp_tuple)) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "tuple does not fit in a page.");
+    }
+  }
+  size_++;
+  bytes_ += tuple.GetLength();
+}
+
+void TmpTupleRun::Finish() {
+  if (page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), true);
+    page_ = nullptr;
+  }
+}
+
+bool TmpTupleRun::ReadPage(std::vector<Tuple> *tuples) {
+  assert(page_ == nullptr);
+  tuples->clear();
+  if (next_page_ == page_ids_.size()) {
+    return false;
+  }
+  page_id_t page_id = page_ids_[next_page_++];
+  auto *page = reinterpret_cast<TmpTuplePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no space in bufferPool.");
+  }
+  Tuple tuple;
+  for (uint32_t offset = page->GetFreeSpacePointer(); offset < PAGE_SIZE;) {
+    offset = page->Get(offset, &tuple);
+    tuples->push_back(tuple);
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  buffer_pool_manager_->DeletePage(page_id);
+  // a page gives its tuples back newest first
+  std::reverse(tuples->begin(), tuples->end());
+  return true;
+}
+
+}  // namespace bustub
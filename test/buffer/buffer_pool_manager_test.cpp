@@ -11,9 +11,15 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cstdio>
+#include <fstream>
 #include <random>
 #include <string>
+#include <vector>
 #include "gtest/gtest.h"
 
 namespace bustub {
@@ -586,4 +592,395 @@ TEST(BufferPoolManagerConcurrencyTest, HardTest4) {
     delete disk_manager;
   }
 }
+
+TEST(BufferPoolManagerConcurrencyTest, MissWithReleasedLatchTest) {
+  // Misses do their I/O without the pool latch, so a page may be fetched again while its frame is still being read in
+  // or while its old contents are still being written back. Every increment must survive that.
+  const int num_threads = 8;
+  const int num_pages = 32;
+  const int ops_per_thread = 2000;
+  for (ReplacerType replacer_type : {ReplacerType::LRU, ReplacerType::CLOCK}) {
+    DiskManager *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManager(4, disk_manager, nullptr, replacer_type);
+    page_id_t temp_page_id;
+    for (int i = 0; i < num_pages; i++) {
+      auto *page = bpm->NewPage(&temp_page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(i, temp_page_id);
+      EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, true));
+    }
+
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([bpm, tid]() {
+        std::mt19937 rng(tid);
+        std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+        for (int i = 0; i < ops_per_thread; i++) {
+          page_id_t page_id = dist(rng);
+          auto *page = bpm->FetchPage(page_id);
+          while (page == nullptr) {
+            page = bpm->FetchPage(page_id);
+          }
+          EXPECT_EQ(page_id, page->GetPageId());
+          page->WLatch();
+          ++*reinterpret_cast<int *>(page->GetData());
+          page->WUnlatch();
+          EXPECT_EQ(1, bpm->UnpinPage(page_id, true));
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    int total = 0;
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      total += *reinterpret_cast<int *>(page->GetData());
+      EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+    }
+    EXPECT_EQ(num_threads * ops_per_thread, total);
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    remove("test.log");
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+TEST(BufferPoolManagerTest, WriteBackDirtyPagesTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(10, disk_manager);
+  page_id_t temp_page_id;
+  for (int i = 0; i < 10; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&temp_page_id));
+    snprintf(bpm->GetPages()[9 - i].GetData(), PAGE_SIZE, "page %d", temp_page_id);
+  }
+  // Pages 0 and 1 stay pinned and clean, pages 2-9 are unpinned and dirty.
+  for (int i = 2; i < 10; i++) {
+    EXPECT_EQ(1, bpm->UnpinPage(i, true));
+  }
+
+  // Scenario: half of the frames clean means writing three more pages, the lowest unpinned page ids.
+  int writes = disk_manager->GetNumWrites();
+  EXPECT_EQ(3, bpm->WriteBackDirtyPages(0.5));
+  EXPECT_EQ(writes + 3, disk_manager->GetNumWrites());
+  EXPECT_EQ(3, bpm->GetNumBackgroundWrites());
+  EXPECT_EQ(0, bpm->WriteBackDirtyPages(0.5));
+  for (int i = 0; i < 10; i++) {
+    Page *page = bpm->GetPages() + (9 - i);
+    EXPECT_EQ(i, page->GetPageId());
+    EXPECT_EQ(i >= 5, page->IsDirty());
+  }
+
+  // Scenario: evicting the written pages needs no foreground write, evicting the others does.
+  for (int i = 0; i < 3; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&temp_page_id));
+  }
+  EXPECT_EQ(3, bpm->GetNumEvictions());
+  EXPECT_EQ(0, bpm->GetNumDirtyEvictions());
+  for (int i = 0; i < 2; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&temp_page_id));
+  }
+  EXPECT_EQ(5, bpm->GetNumEvictions());
+  EXPECT_EQ(2, bpm->GetNumDirtyEvictions());
+
+  // Scenario: written pages read back with their contents.
+  for (int i = 10; i < 15; i++) {
+    EXPECT_EQ(1, bpm->UnpinPage(i, false));
+  }
+  for (page_id_t page_id = 2; page_id < 10; page_id++) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerConcurrencyTest, BackgroundFlusherTest) {
+  // Writers dirty random pages of a working set larger than the pool, with and without the flusher running. With it,
+  // most evictions should find the victim already clean, and no update may be lost.
+  const int num_threads = 4;
+  const int num_pages = 64;
+  const int ops_per_thread = 5000;
+  for (bool run_flusher : {false, true}) {
+    DiskManager *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManager(16, disk_manager);
+    page_id_t temp_page_id;
+    for (int i = 0; i < num_pages; i++) {
+      ASSERT_NE(nullptr, bpm->NewPage(&temp_page_id));
+      EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, true));
+    }
+    size_t evictions_before = bpm->GetNumEvictions();
+    size_t dirty_evictions_before = bpm->GetNumDirtyEvictions();
+    if (run_flusher) {
+      bpm->RunFlusherThread(0.5, std::chrono::milliseconds(1));
+    }
+
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([bpm, tid]() {
+        std::mt19937 rng(tid);
+        std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+        for (int i = 0; i < ops_per_thread; i++) {
+          page_id_t page_id = dist(rng);
+          auto *page = bpm->FetchPage(page_id);
+          while (page == nullptr) {
+            page = bpm->FetchPage(page_id);
+          }
+          page->WLatch();
+          ++*reinterpret_cast<int *>(page->GetData());
+          page->WUnlatch();
+          EXPECT_EQ(1, bpm->UnpinPage(page_id, true));
+          if (i % 8 == 0) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    bpm->StopFlusherThread();
+
+    size_t evictions = bpm->GetNumEvictions() - evictions_before;
+    size_t dirty_evictions = bpm->GetNumDirtyEvictions() - dirty_evictions_before;
+    std::string prefix = run_flusher ? "flusher_" : "no_flusher_";
+    RecordProperty(prefix + "evictions", std::to_string(evictions));
+    RecordProperty(prefix + "dirty_evictions", std::to_string(dirty_evictions));
+    RecordProperty(prefix + "background_writes", std::to_string(bpm->GetNumBackgroundWrites()));
+    if (run_flusher) {
+      EXPECT_GT(bpm->GetNumBackgroundWrites(), 0);
+    } else {
+      EXPECT_EQ(0, bpm->GetNumBackgroundWrites());
+    }
+
+    int total = 0;
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      total += *reinterpret_cast<int *>(page->GetData());
+      EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+    }
+    EXPECT_EQ(num_threads * ops_per_thread, total);
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    remove("test.log");
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+TEST(BufferPoolManagerTest, PrefetchTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(10, disk_manager);
+  page_id_t temp_page_id;
+  for (int i = 0; i < 20; i++) {
+    auto *page = bpm->NewPage(&temp_page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", temp_page_id);
+    EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, true));
+  }
+
+  // Scenario: pages 0-4 were evicted, pages 15-19 are still in the pool and pages 20-24 were never allocated, so
+  // only the first five are loaded.
+  bpm->Prefetch(0, 5);
+  bpm->Prefetch(15, 10);
+  for (int i = 0; i < 1000 && bpm->GetNumPrefetches() < 5; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(5, bpm->GetNumPrefetches());
+
+  // Scenario: prefetched pages are not pinned and fetching them does not read the disk again.
+  int reads = disk_manager->GetNumReads();
+  for (page_id_t page_id = 0; page_id < 5; page_id++) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(1, page->GetPinCount());
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(reads, disk_manager->GetNumReads());
+
+  // Scenario: a page id allocated after a prefetch of it was skipped can still be created.
+  ASSERT_NE(nullptr, bpm->NewPage(&temp_page_id));
+  EXPECT_EQ(20, temp_page_id);
+  EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, false));
+
+  // Scenario: cancelling the prefetches of one owner neither waits for nor drops those of another.
+  int owner;
+  int other_owner;
+  bpm->Prefetch(5, 5, &owner);
+  bpm->CancelPrefetches(&other_owner);
+  bpm->WaitForPrefetches();
+  EXPECT_EQ(10, bpm->GetNumPrefetches());
+  bpm->CancelPrefetches(&owner);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DirectIOTest) {
+  remove("test.db");
+  auto *disk_manager = new DiskManager("test.db", DiskIOBackend::DIRECT);
+  auto *bpm = new BufferPoolManager(5, disk_manager, nullptr, ReplacerType::LRU, true);
+  page_id_t temp_page_id;
+
+  // Scenario: frames are page aligned, so they go to and from the device without a copy.
+  for (int i = 0; i < 20; i++) {
+    auto *page = bpm->NewPage(&temp_page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(page->GetData()) % PAGE_SIZE);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", temp_page_id);
+    EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, true));
+  }
+
+  // Scenario: evicted pages come back intact.
+  for (page_id_t page_id = 0; page_id < 20; page_id++) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: unaligned buffers outside the buffer pool still work.
+  std::vector<char> buf(PAGE_SIZE + 1);
+  disk_manager->ReadPage(3, buf.data() + 1);
+  EXPECT_EQ("page 3", std::string(buf.data() + 1));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PageReuseTest) {
+  remove("test.db");
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+  page_id_t temp_page_id;
+  for (int i = 0; i < 20; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&temp_page_id));
+    EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, true));
+  }
+
+  // Scenario: deleted pages give their ids back, whether they are still in the pool or only on disk.
+  EXPECT_EQ(1, bpm->DeletePage(18));
+  EXPECT_EQ(1, bpm->DeletePage(2));
+  EXPECT_EQ(1, bpm->DeletePage(3));
+  EXPECT_EQ(3, disk_manager->GetNumFreePages());
+
+  // Scenario: a new page takes the free id closest to its hint, and comes back zeroed.
+  auto *page = bpm->NewPageNear(&temp_page_id, 15);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(18, temp_page_id);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&temp_page_id));
+  EXPECT_EQ(2, temp_page_id);
+  EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, false));
+  EXPECT_EQ(1, disk_manager->GetNumFreePages());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete bpm;
+  delete disk_manager;
+}
+
+/** @return the resident set size of this process in KB */
+static size_t ResidentKB() {
+  std::ifstream statm("/proc/self/statm");
+  size_t total = 0;
+  size_t resident = 0;
+  statm >> total >> resident;
+  return resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+/** @return how many KB of the file are in the kernel page cache */
+static size_t PageCacheKB(const std::string &file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  size_t length = lseek(fd, 0, SEEK_END);
+  void *map = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  size_t page_size = sysconf(_SC_PAGESIZE);
+  std::vector<unsigned char> in_core((length + page_size - 1) / page_size);
+  mincore(map, length, in_core.data());
+  munmap(map, length);
+  close(fd);
+  return std::count_if(in_core.begin(), in_core.end(), [](unsigned char c) { return (c & 1) != 0; }) * page_size /
+         1024;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DISABLED_DirectIOBenchmark) {
+  // Random fetches over a database 16 times the pool: with buffered I/O every page is cached twice, once in a frame
+  // and once in the kernel page cache, while direct I/O leaves the buffer pool as the only copy.
+  const size_t pool_size = 512;
+  const int num_pages = 8192;
+  const int num_fetches = 20000;
+
+  for (auto backend : {DiskIOBackend::POSITIONAL, DiskIOBackend::DIRECT}) {
+    remove("test.db");
+    auto *disk_manager = new DiskManager("test.db", backend);
+    auto *bpm = new BufferPoolManager(pool_size, disk_manager);
+    page_id_t temp_page_id;
+    for (int i = 0; i < num_pages; i++) {
+      auto *page = bpm->NewPage(&temp_page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", temp_page_id);
+      bpm->UnpinPage(temp_page_id, true);
+    }
+    bpm->FlushAllPages();
+    // start from a cold page cache either way
+    disk_manager->Sync();
+    int fd = open("test.db", O_RDONLY);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+    size_t rss_before = ResidentKB();
+
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+    std::vector<int64_t> latencies;
+    latencies.reserve(num_fetches);
+    for (int i = 0; i < num_fetches; i++) {
+      page_id_t page_id = dist(rng);
+      auto start = std::chrono::steady_clock::now();
+      auto *page = bpm->FetchPage(page_id);
+      auto end = std::chrono::steady_clock::now();
+      ASSERT_NE(nullptr, page);
+      bpm->UnpinPage(page_id, false);
+      latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+    std::string prefix = disk_manager->GetBackend() == DiskIOBackend::DIRECT ? "direct_" : "buffered_";
+    RecordProperty(prefix + "rss_delta_kb", std::to_string(static_cast<int64_t>(ResidentKB() - rss_before)));
+    RecordProperty(prefix + "page_cache_kb", std::to_string(PageCacheKB("test.db")));
+    RecordProperty(prefix + "p50_ns", std::to_string(percentile(0.5)));
+    RecordProperty(prefix + "p99_ns", std::to_string(percentile(0.99)));
+    RecordProperty(prefix + "p999_ns", std::to_string(percentile(0.999)));
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    remove("test.log");
+    delete bpm;
+    delete disk_manager;
+  }
+}
 }  // namespace bustub
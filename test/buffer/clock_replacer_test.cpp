@@ -10,16 +10,23 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
 #include <thread>  // NOLINT
 #include <vector>
 
 #include "buffer/clock_replacer.h"
+#include "buffer/lru_replacer.h"
 #include "gtest/gtest.h"
 
 namespace bustub {
 
-TEST(ClockReplacerTest, DISABLED_SampleTest) {
+TEST(ClockReplacerTest, SampleTest) {
   ClockReplacer clock_replacer(7);
 
   // Scenario: unpin six elements, i.e. add them to the replacer.
@@ -59,4 +66,143 @@ TEST(ClockReplacerTest, DISABLED_SampleTest) {
   EXPECT_EQ(4, value);
 }
 
+TEST(ClockReplacerTest, ConcurrentStressTest) {
+  const int num_threads = 8;
+  const int frames_per_thread = 64;
+  const int num_frames = num_threads * frames_per_thread;
+  ClockReplacer clock_replacer(num_frames);
+
+  // Phase 0: threads pin and unpin the same frames at once. An unpin counts its frame a moment before it shows up, so
+  // the size may run ahead by a frame per thread, but it never drops below zero and wraps around.
+  std::atomic<bool> churning{true};
+  std::atomic<size_t> max_size{0};
+  std::thread sampler([&clock_replacer, &churning, &max_size]() {
+    while (churning.load()) {
+      max_size.store(std::max(max_size.load(), clock_replacer.Size()));
+    }
+  });
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&clock_replacer, tid]() {
+      std::mt19937 rng(tid);
+      std::uniform_int_distribution<int> dist(0, 3);
+      for (int i = 0; i < 100000; i++) {
+        if (rng() % 2 == 0) {
+          clock_replacer.Unpin(dist(rng));
+        } else {
+          clock_replacer.Pin(dist(rng));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  churning.store(false);
+  sampler.join();
+  EXPECT_LE(max_size.load(), 4 + num_threads);
+  for (frame_id_t frame = 0; frame < 4; frame++) {
+    clock_replacer.Pin(frame);
+  }
+  EXPECT_EQ(0, clock_replacer.Size());
+
+  // Phase 1: every thread churns its own frames, ending with exactly the even ones unpinned.
+  threads.clear();
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&clock_replacer, tid]() {
+      std::mt19937 rng(tid);
+      std::uniform_int_distribution<int> dist(0, frames_per_thread - 1);
+      frame_id_t base = tid * frames_per_thread;
+      for (int i = 0; i < 10000; i++) {
+        frame_id_t frame = base + dist(rng);
+        if (i % 2 == 0) {
+          clock_replacer.Unpin(frame);
+        } else {
+          clock_replacer.Pin(frame);
+        }
+      }
+      for (frame_id_t frame = base; frame < base + frames_per_thread; frame++) {
+        if (frame % 2 == 0) {
+          clock_replacer.Unpin(frame);
+        } else {
+          clock_replacer.Pin(frame);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_frames / 2, clock_replacer.Size());
+
+  // Phase 2: concurrent victims must hand out every unpinned frame exactly once.
+  std::vector<std::vector<frame_id_t>> victims(num_threads);
+  threads.clear();
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&clock_replacer, &victims, tid]() {
+      frame_id_t frame;
+      while (clock_replacer.Victim(&frame)) {
+        victims[tid].push_back(frame);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::vector<frame_id_t> all_victims;
+  for (const auto &v : victims) {
+    all_victims.insert(all_victims.end(), v.begin(), v.end());
+  }
+  std::sort(all_victims.begin(), all_victims.end());
+  ASSERT_EQ(num_frames / 2, all_victims.size());
+  for (size_t i = 0; i < all_victims.size(); i++) {
+    EXPECT_EQ(static_cast<frame_id_t>(2 * i), all_victims[i]);
+  }
+  EXPECT_EQ(0, clock_replacer.Size());
+}
+
+TEST(ClockReplacerTest, DISABLED_ThroughputComparisonTest) {
+  // Every thread repeatedly pins and unpins random frames, as a buffer pool does on hits, with an occasional victim.
+  const int num_frames = 1024;
+  const int ops_per_thread = 200000;
+  for (int num_threads : {1, 4, 8}) {
+    for (bool use_clock : {false, true}) {
+      std::unique_ptr<Replacer> replacer;
+      if (use_clock) {
+        replacer = std::make_unique<ClockReplacer>(num_frames);
+      } else {
+        replacer = std::make_unique<LRUReplacer>(num_frames);
+      }
+      for (frame_id_t frame = 0; frame < num_frames; frame++) {
+        replacer->Unpin(frame);
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      std::vector<std::thread> threads;
+      for (int tid = 0; tid < num_threads; tid++) {
+        threads.emplace_back([&replacer, tid]() {
+          std::mt19937 rng(tid);
+          std::uniform_int_distribution<frame_id_t> dist(0, num_frames - 1);
+          frame_id_t victim;
+          for (int i = 0; i < ops_per_thread; i++) {
+            frame_id_t frame = dist(rng);
+            replacer->Pin(frame);
+            replacer->Unpin(frame);
+            if (i % 16 == 0 && replacer->Victim(&victim)) {
+              replacer->Unpin(victim);
+            }
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      RecordProperty(std::string(use_clock ? "clock" : "lru") + "_ops_per_sec_threads_" + std::to_string(num_threads),
+                     std::to_string(static_cast<uint64_t>(num_threads * ops_per_thread / elapsed)));
+      EXPECT_EQ(num_frames, replacer->Size());
+    }
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,220 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 7);
+
+  // Scenario: frames 1-6 hold pages 1-6, page 1 is accessed twice and all of them are unpinned.
+  for (frame_id_t frame = 1; frame <= 6; frame++) {
+    lru_k_replacer.RecordAccess(frame, frame);
+    lru_k_replacer.Unpin(frame);
+  }
+  lru_k_replacer.RecordAccess(1, 1);
+  lru_k_replacer.Unpin(1);
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Scenario: pages seen once have an infinite backward 2-distance and go first, oldest access first.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+
+  // Scenario: pinning takes a frame out of the replacer, a second access makes page 5 hotter than page 1.
+  lru_k_replacer.Pin(4);
+  EXPECT_EQ(3, lru_k_replacer.Size());
+  lru_k_replacer.RecordAccess(5, 5);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, lru_k_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, RetainedHistoryTest) {
+  LRUKReplacer lru_k_replacer(3, 2, 1);
+
+  // Scenario: page 10 is evicted after one access, then read again into another frame.
+  lru_k_replacer.RecordAccess(0, 10);
+  lru_k_replacer.Unpin(0);
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  lru_k_replacer.RecordAccess(1, 11);
+  lru_k_replacer.RecordAccess(2, 10);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Unpin(2);
+
+  // Scenario: page 10 now has two accesses, so page 11 is the victim even though it was accessed earlier.
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+
+  // Scenario: the history cap is one page, so page 11's history pushed out page 10's.
+  lru_k_replacer.RecordAccess(0, 12);
+  lru_k_replacer.RecordAccess(1, 10);
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.Unpin(1);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+}
+
+TEST(LRUKReplacerTest, RandomizedVictimOrderTest) {
+  // Scenario: random accesses, pins and unpins, every victim checked against a scan over all frames.
+  const size_t num_frames = 64;
+  const size_t k = 3;
+  LRUKReplacer lru_k_replacer(num_frames, k, 0);
+  std::vector<bool> evictable(num_frames, false);
+  std::vector<page_id_t> pages(num_frames, INVALID_PAGE_ID);
+  std::vector<std::vector<uint64_t>> accesses(num_frames);
+  uint64_t timestamp = 0;
+  std::mt19937 rng(15445);
+  for (int i = 0; i < 20000; i++) {
+    auto frame = static_cast<frame_id_t>(rng() % num_frames);
+    switch (rng() % 4) {
+      case 0: {
+        page_id_t page = frame * 4 + static_cast<page_id_t>(rng() % 4);
+        if (pages[frame] != page) {
+          pages[frame] = page;
+          accesses[frame].clear();
+        }
+        accesses[frame].push_back(++timestamp);
+        if (accesses[frame].size() > k) {
+          accesses[frame].erase(accesses[frame].begin());
+        }
+        lru_k_replacer.RecordAccess(frame, page);
+        break;
+      }
+      case 1:
+        evictable[frame] = false;
+        lru_k_replacer.Pin(frame);
+        break;
+      case 2:
+        evictable[frame] = true;
+        lru_k_replacer.Unpin(frame);
+        break;
+      default: {
+        // frames with fewer than k accesses first, then the oldest k-th access
+        auto order = [&accesses, k](size_t f) {
+          return std::make_pair(accesses[f].size() >= k, accesses[f].empty() ? 0 : accesses[f].front());
+        };
+        frame_id_t expected = -1;
+        for (size_t f = 0; f < num_frames; f++) {
+          if (!evictable[f]) {
+            continue;
+          }
+          if (expected == -1 || order(f) < order(expected)) {
+            expected = static_cast<frame_id_t>(f);
+          }
+        }
+        frame_id_t value;
+        ASSERT_EQ(expected != -1, lru_k_replacer.Victim(&value));
+        if (expected != -1) {
+          ASSERT_EQ(expected, value);
+          evictable[value] = false;
+          pages[value] = INVALID_PAGE_ID;
+          accesses[value].clear();
+        }
+      }
+    }
+    ASSERT_EQ(std::count(evictable.begin(), evictable.end(), true), lru_k_replacer.Size());
+  }
+}
+
+TEST(LRUKReplacerTest, ScanZipfHitRatioTest) {
+  // A hot set is read with a Zipfian distribution while a sequential scan over a much larger table runs alongside.
+  // The scan touches each of its pages once, so a scan-resistant policy should keep the hot set cached.
+  const size_t pool_size = 64;
+  const int num_hot_pages = 256;
+  const int num_scan_pages = 2048;
+  const int num_ops = 40000;
+  const int lookups_per_scan_page = 2;
+  const double theta = 0.99;
+
+  std::vector<double> zipf_cdf(num_hot_pages);
+  double sum = 0;
+  for (int i = 0; i < num_hot_pages; i++) {
+    sum += 1.0 / std::pow(i + 1, theta);
+    zipf_cdf[i] = sum;
+  }
+  for (auto &p : zipf_cdf) {
+    p /= sum;
+  }
+
+  const char *names[] = {"lru", "clock", "lru-k"};
+  std::vector<double> lookup_hit_ratios;
+  for (ReplacerType replacer_type : {ReplacerType::LRU, ReplacerType::CLOCK, ReplacerType::LRUK}) {
+    auto *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManager(pool_size, disk_manager, nullptr, replacer_type);
+    page_id_t temp_page_id;
+    for (int i = 0; i < num_hot_pages + num_scan_pages; i++) {
+      ASSERT_NE(nullptr, bpm->NewPage(&temp_page_id));
+      bpm->UnpinPage(temp_page_id, false);
+    }
+
+    std::mt19937 rng(15445);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    int lookups = 0;
+    int lookup_hits = 0;
+    int scan_pos = 0;
+    int reads_before = disk_manager->GetNumReads();
+    for (int i = 0; i < num_ops; i++) {
+      page_id_t page_id;
+      bool is_lookup = i % (lookups_per_scan_page + 1) != 0;
+      if (is_lookup) {
+        page_id = std::lower_bound(zipf_cdf.begin(), zipf_cdf.end(), uniform(rng)) - zipf_cdf.begin();
+        page_id = std::min(page_id, num_hot_pages - 1);
+      } else {
+        page_id = num_hot_pages + scan_pos;
+        scan_pos = (scan_pos + 1) % num_scan_pages;
+      }
+      int reads = disk_manager->GetNumReads();
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+      bpm->UnpinPage(page_id, false);
+      if (is_lookup) {
+        lookups++;
+        lookup_hits += disk_manager->GetNumReads() == reads ? 1 : 0;
+      }
+    }
+    double hit_ratio = 1.0 - static_cast<double>(disk_manager->GetNumReads() - reads_before) / num_ops;
+    lookup_hit_ratios.push_back(static_cast<double>(lookup_hits) / lookups);
+    std::string name = names[lookup_hit_ratios.size() - 1];
+    RecordProperty(name + "_hit_ratio", std::to_string(hit_ratio));
+    RecordProperty(name + "_lookup_hit_ratio", std::to_string(lookup_hit_ratios.back()));
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    remove("test.log");
+    delete bpm;
+    delete disk_manager;
+  }
+  EXPECT_GT(lookup_hit_ratios[2], lookup_hit_ratios[0]);
+}
+
+}  // namespace bustub
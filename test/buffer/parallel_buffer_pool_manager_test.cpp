@@ -0,0 +1,218 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 5;
+  const size_t pool_size = 2;
+  const size_t total_size = num_instances * pool_size;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+  EXPECT_EQ(total_size, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up every instance.
+  for (size_t i = 1; i < total_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(bpm->GetBufferPoolManager(page_id_temp), bpm->GetBufferPoolManager(page_id_temp + num_instances));
+  }
+
+  // Scenario: Once every instance is full, we should not be able to create any new pages.
+  for (size_t i = total_size; i < total_size * 2; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(INVALID_PAGE_ID, page_id_temp);
+  }
+
+  // Scenario: After unpinning pages {0, 1, 2, 3, 4} there is one free frame in each instance,
+  // so new pages are spread over the instances rather than failing on a full one.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(i, true));
+  }
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+
+  // Scenario: We should be able to fetch the data we wrote a while ago.
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  EXPECT_EQ(true, bpm->DeletePage(0));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ReusedIdTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 4;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, 2, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  // Scenario: every free id maps to instance 0, which is full, while the other instances have room.
+  for (int i = 4; i < 16; i += 4) {
+    EXPECT_EQ(true, bpm->DeletePage(i));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  ASSERT_NE(nullptr, bpm->FetchPage(16));
+
+  // The new page goes to another instance, and the free ids are left for instance 0.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_NE(0, page_id_temp % static_cast<page_id_t>(num_instances));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  EXPECT_EQ(true, bpm->UnpinPage(16, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(4, page_id_temp);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const int num_threads = 8;
+  const int num_runs = 20;
+  for (int run = 0; run < num_runs; run++) {
+    auto *disk_manager = new DiskManager("test.db");
+    std::shared_ptr<BufferPoolManager> bpm{new ParallelBufferPoolManager(4, 10, disk_manager)};
+    std::vector<std::thread> threads;
+
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.push_back(std::thread([&bpm]() {  // NOLINT
+        page_id_t temp_page_id;
+        std::vector<page_id_t> page_ids;
+        for (int i = 0; i < 10; i++) {
+          auto new_page = bpm->NewPage(&temp_page_id, nullptr);
+          if (new_page == nullptr) {
+            continue;
+          }
+          strcpy(new_page->GetData(), std::to_string(temp_page_id).c_str());  // NOLINT
+          page_ids.push_back(temp_page_id);
+          EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, true, nullptr));
+        }
+        for (auto page_id : page_ids) {
+          auto page = bpm->FetchPage(page_id, nullptr);
+          while (page == nullptr) {
+            page = bpm->FetchPage(page_id, nullptr);
+          }
+          EXPECT_EQ(0, std::strcmp(std::to_string(page_id).c_str(), (page->GetData())));
+          EXPECT_EQ(1, bpm->UnpinPage(page_id, true, nullptr));
+        }
+        for (auto page_id : page_ids) {
+          EXPECT_EQ(1, bpm->DeletePage(page_id, nullptr));
+        }
+      }));
+    }
+
+    for (int i = 0; i < num_threads; i++) {
+      threads[i].join();
+    }
+
+    remove("test.db");
+    remove("test.log");
+    delete disk_manager;
+  }
+}
+
+// A benchmark, run it with --gtest_also_run_disabled_tests; the results are recorded as test properties.
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, DISABLED_ThroughputBenchmark) {
+  // Point-lookup style load: every thread fetches and unpins random pages from a working set twice the pool size,
+  // so both hits and misses (with their disk I/O) are part of the measurement.
+  const size_t total_frames = 64;
+  const int num_pages = 128;
+  const int num_threads = 8;
+  const int ops_per_thread = 5000;
+
+  for (size_t num_instances : {1, 2, 4, 8, 16}) {
+    auto *disk_manager = new DiskManager("test.db");
+    auto *bpm = new ParallelBufferPoolManager(num_instances, total_frames / num_instances, disk_manager);
+    page_id_t temp_page_id;
+    for (int i = 0; i < num_pages; i++) {
+      auto *page = bpm->NewPage(&temp_page_id);
+      ASSERT_NE(nullptr, page);
+      bpm->UnpinPage(temp_page_id, true);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([bpm, tid]() {
+        std::mt19937 rng(tid);
+        std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+        for (int i = 0; i < ops_per_thread; i++) {
+          page_id_t page_id = dist(rng);
+          auto *page = bpm->FetchPage(page_id);
+          if (page != nullptr) {
+            bpm->UnpinPage(page_id, false);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    RecordProperty("ops_per_sec_instances_" + std::to_string(num_instances),
+                   std::to_string(static_cast<uint64_t>(num_threads * ops_per_thread / elapsed)));
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    remove("test.log");
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,305 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_test.cpp
+//
+// Identification: test/container/extendible_hash_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/hash/extendible_hash_table.h"
+#include "container/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/index/extendible_hash_table_index.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // insert a few values, and one more value for each key but the first
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 0; i < 5; i++) {
+    // the same pair twice is not allowed
+    EXPECT_EQ(i != 0, ht.Insert(nullptr, i, 2 * i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    std::sort(res.begin(), res.end());
+    std::vector<int> expected = i == 0 ? std::vector<int>{0} : std::vector<int>{i, 2 * i};
+    EXPECT_EQ(expected, res);
+  }
+
+  // look for a key that does not exist
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+  EXPECT_EQ(0, res.size());
+
+  // delete some values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    std::vector<int> expected = i == 0 ? std::vector<int>{} : std::vector<int>{2 * i};
+    EXPECT_EQ(expected, res);
+  }
+  EXPECT_FALSE(ht.Remove(nullptr, 0, 0));
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SplitMergeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  // buckets split as they fill, the directory doubling when one has to split past it
+  const int num_keys = 20000;
+  uint32_t global_depth = 0;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_LE(global_depth, ht.GetGlobalDepth());
+    global_depth = ht.GetGlobalDepth();
+  }
+  EXPECT_GE(global_depth, 5);
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(std::vector<int>{i}, res);
+  }
+
+  // emptied buckets merge back, and the directory halves along
+  std::vector<int> keys(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, keys[i], keys[i]));
+    if (i == num_keys / 2) {
+      ht.VerifyIntegrity();
+      for (int j = 0; j < num_keys; j++) {
+        std::vector<int> res;
+        EXPECT_EQ(j > i, ht.GetValue(nullptr, keys[j], &res));
+      }
+    }
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, OverflowTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // no split separates duplicates, past the largest directory their bucket chains overflow pages
+  const int num_duplicates = 2000;
+  for (int i = 0; i < num_duplicates; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, 7, i));
+  }
+  EXPECT_FALSE(ht.Insert(nullptr, 7, num_duplicates - 1));
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i + 8, i));
+  }
+  EXPECT_EQ(HashTableDirectoryPage::MAX_DEPTH, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+  std::vector<int> res;
+  EXPECT_TRUE(ht.GetValue(nullptr, 7, &res));
+  std::sort(res.begin(), res.end());
+  std::vector<int> expected(num_duplicates);
+  for (int i = 0; i < num_duplicates; i++) {
+    expected[i] = i;
+  }
+  EXPECT_EQ(expected, res);
+
+  // emptied overflow pages leave the chain, and the bucket merges back once it is empty
+  for (int i = 0; i < num_duplicates; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, 7, i));
+  }
+  EXPECT_FALSE(ht.Remove(nullptr, 7, 0));
+  res.clear();
+  ht.GetValue(nullptr, 7, &res);
+  EXPECT_EQ(num_duplicates / 2, res.size());
+  for (int i = 1; i < num_duplicates; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, 7, i));
+  }
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i + 8, i));
+  }
+  res.clear();
+  EXPECT_FALSE(ht.GetValue(nullptr, 7, &res));
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, ConcurrentTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+  const int num_stable = 1000;
+  for (int i = 0; i < num_stable; i++) {
+    ht.Insert(nullptr, i, i);
+  }
+
+  // writers split and merge buckets while readers look for keys that are there all along
+  const int num_writers = 4;
+  const int keys_per_writer = 10000;
+  std::atomic<int> writers_left{num_writers};
+  std::atomic<int> misses{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_writers; t++) {
+    threads.emplace_back([&, t] {
+      int first = num_stable + t * keys_per_writer;
+      for (int i = first; i < first + keys_per_writer; i++) {
+        ht.Insert(nullptr, i, i);
+      }
+      for (int i = first; i < first + keys_per_writer; i += 2) {
+        ht.Remove(nullptr, i, i);
+      }
+      writers_left--;
+    });
+  }
+  for (int t = 0; t < 2; t++) {
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      while (writers_left > 0) {
+        int key = static_cast<int>(rng() % num_stable);
+        std::vector<int> res;
+        if (!ht.GetValue(nullptr, key, &res) || res.size() != 1 || res[0] != key) {
+          misses++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, misses);
+  ht.VerifyIntegrity();
+
+  for (int i = 0; i < num_stable + num_writers * keys_per_writer; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i >= num_stable && (i - num_stable) % 2 == 0 ? 0 : 1, res.size()) << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, IndexTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  Schema schema({Column("a", TypeId::BIGINT)});
+  ExtendibleHashTableIndex<GenericKey<8>, RID, GenericComparator<8>> index(
+      new IndexMetadata("hash_index", "t", &schema, {0}), bpm, HashFunction<GenericKey<8>>());
+  Transaction transaction(0);
+  for (int i = 0; i < 5000; i++) {
+    index.InsertEntry(Tuple({ValueFactory::GetBigIntValue(i % 1000)}, &schema), RID(i, 0), &transaction);
+  }
+  for (int i = 0; i < 1000; i++) {
+    std::vector<RID> result;
+    index.ScanKey(Tuple({ValueFactory::GetBigIntValue(i)}, &schema), &result, &transaction);
+    EXPECT_EQ(5, result.size());
+  }
+  index.DeleteEntry(Tuple({ValueFactory::GetBigIntValue(7)}, &schema), RID(1007, 0), &transaction);
+  std::vector<RID> result;
+  index.ScanKey(Tuple({ValueFactory::GetBigIntValue(7)}, &schema), &result, &transaction);
+  EXPECT_EQ(4, result.size());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+namespace {
+
+// per insert latencies in ns, sorted
+template <typename HashTable>
+std::vector<double> InsertLatencies(HashTable *ht, int num_keys) {
+  std::vector<double> latencies(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(ht->Insert(nullptr, i, i));
+    latencies[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+  std::sort(latencies.begin(), latencies.end());
+  return latencies;
+}
+
+void RecordLatencies(const std::string &name, const std::vector<double> &latencies) {
+  ::testing::Test::RecordProperty(name + "_insert_ns_p50", std::to_string(latencies[latencies.size() / 2]));
+  ::testing::Test::RecordProperty(name + "_insert_ns_p99", std::to_string(latencies[latencies.size() * 99 / 100]));
+  ::testing::Test::RecordProperty(name + "_insert_ns_max", std::to_string(latencies.back()));
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, DISABLED_InsertLatencyBenchmark) {
+  // Inserts into tables growing from their smallest size: linear probing rehashes everything as it doubles,
+  // extendible hashing splits a bucket at a time.
+  const int num_keys = 100000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(1000, disk_manager);
+  {
+    LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+    RecordLatencies("linear_probing", InsertLatencies(&ht, num_keys));
+  }
+  {
+    ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+    RecordLatencies("extendible_hashing", InsertLatencies(&ht, num_keys));
+  }
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -10,9 +10,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <functional>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <tuple>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -22,18 +28,23 @@
 #include "concurrency/transaction_manager.h"
 #include "execution/execution_engine.h"
 #include "execution/executor_context.h"
+#include "execution/executor_factory.h"
 #include "execution/executors/aggregation_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/seq_scan_executor.h"
 #include "execution/expressions/aggregate_value_expression.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
 #include "execution/plans/delete_plan.h"
+#include "execution/plans/hash_join_plan.h"
 #include "execution/plans/index_scan_plan.h"
 #include "execution/plans/limit_plan.h"
+#include "execution/plans/merge_join_plan.h"
 #include "execution/plans/nested_index_join_plan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
 #include "execution/plans/update_plan.h"
 #include "gtest/gtest.h"
 #include "storage/b_plus_tree_test_util.h"  // NOLINT
@@ -201,6 +212,126 @@ TEST_F(GradingExecutorTest, SimpleIndexScanTest) {
   delete key_schema;
 }
 
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, RangeIndexScanTest) {
+  // SELECT colA, colB FROM test_1 WHERE <range on colA>, through an index on colA
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  auto index_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "index1", "test_1", table_info->schema_, *key_schema, {0}, 8);
+
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  auto *const_a = MakeConstantValueExpression(ValueFactory::GetIntegerValue(250));
+  auto *out_colA = MakeColumnValueExpression(*out_schema, 0, "colA");
+
+  auto scan = [&](const IndexScanPlanNode &plan, int32_t low, int32_t high) {
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(static_cast<size_t>(high - low), result_set.size());
+    for (size_t i = 0; i < result_set.size(); i++) {
+      ASSERT_EQ(low + static_cast<int32_t>(i),
+                result_set[i].GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+    }
+  };
+
+  // colA < 250: [0, 250)
+  scan(IndexScanPlanNode{out_schema, MakeComparisonExpression(out_colA, const_a, ComparisonType::LessThan),
+                         index_info->index_oid_},
+       0, 250);
+  // colA = 250: [250, 251)
+  scan(IndexScanPlanNode{out_schema, MakeComparisonExpression(out_colA, const_a, ComparisonType::Equal),
+                         index_info->index_oid_},
+       250, 251);
+  // 250 <= colA: [250, 1000)
+  scan(IndexScanPlanNode{out_schema, MakeComparisonExpression(const_a, out_colA, ComparisonType::LessThanOrEqual),
+                         index_info->index_oid_},
+       250, 1000);
+  // bounds given by the plan: [100, 110)
+  scan(IndexScanPlanNode{out_schema, nullptr, index_info->index_oid_,
+                         IndexScanBound{ValueFactory::GetIntegerValue(100), true},
+                         IndexScanBound{ValueFactory::GetIntegerValue(110), false}},
+       100, 110);
+  // bounds given by the plan narrow the predicate: [100, 110) and colB = 3
+  auto *const3 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(3));
+  auto *out_colB = MakeColumnValueExpression(*out_schema, 0, "colB");
+  IndexScanPlanNode plan{out_schema, MakeComparisonExpression(out_colB, const3, ComparisonType::Equal),
+                         index_info->index_oid_, IndexScanBound{ValueFactory::GetIntegerValue(100), true},
+                         IndexScanBound{ValueFactory::GetIntegerValue(110), false}};
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+  for (const auto &tuple : result_set) {
+    int32_t a = tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>();
+    ASSERT_TRUE(a >= 100 && a < 110);
+    ASSERT_EQ(3, tuple.GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<int32_t>());
+  }
+  // tuples fetched a batch at a time in the order they are stored in: the same range
+  IndexScanPlanNode unordered_plan{out_schema, MakeComparisonExpression(out_colA, const_a, ComparisonType::LessThan),
+                                   index_info->index_oid_, std::nullopt, std::nullopt, false};
+  result_set.clear();
+  GetExecutionEngine()->Execute(&unordered_plan, &result_set, GetTxn(), GetExecutorContext());
+  std::vector<int32_t> values;
+  for (const auto &tuple : result_set) {
+    values.push_back(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+  }
+  std::sort(values.begin(), values.end());
+  ASSERT_EQ(250, values.size());
+  for (int32_t i = 0; i < 250; i++) {
+    ASSERT_EQ(i, values[i]);
+  }
+
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, NonUniqueIndexScanTest) {
+  // SELECT colA, colB FROM test_1 WHERE colB = 3, through a non-unique index on colB
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+
+  Schema *key_schema = ParseCreateStatement("b bigint");
+  auto index_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "index1", "test_1", table_info->schema_, *key_schema, {1}, 8, false);
+
+  std::unordered_set<int64_t> expected;
+  for (auto itr = table_info->table_->Begin(GetTxn()); itr != table_info->table_->End(); ++itr) {
+    if (itr->GetValue(&schema, 1).GetAs<int32_t>() == 3) {
+      expected.insert(itr->GetRid().Get());
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+
+  // every tuple with the key, from a lookup
+  std::vector<RID> rids;
+  Tuple key({ValueFactory::GetIntegerValue(3)}, key_schema);
+  index_info->index_->ScanKey(key, &rids, GetTxn());
+  std::unordered_set<int64_t> found;
+  for (const RID &rid : rids) {
+    found.insert(rid.Get());
+  }
+  ASSERT_EQ(expected, found);
+
+  // and from a scan
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  auto *out_colB = MakeColumnValueExpression(*out_schema, 0, "colB");
+  auto *const3 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(3));
+  IndexScanPlanNode plan{out_schema, MakeComparisonExpression(out_colB, const3, ComparisonType::Equal),
+                         index_info->index_oid_};
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(expected.size(), result_set.size());
+  for (const auto &tuple : result_set) {
+    ASSERT_EQ(3, tuple.GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<int32_t>());
+  }
+
+  delete key_schema;
+}
+
 // NOLINTNEXTLINE
 TEST_F(GradingExecutorTest, SimpleRawInsertWithIndexTest) {
   // INSERT INTO empty_table2 VALUES (200, 20), (201, 21), (202, 22)
@@ -509,6 +640,446 @@ TEST_F(GradingExecutorTest, SimpleNestedLoopJoinTest) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, BlockNestedLoopJoinTest) {
+  // SELECT l.colA, r.colA FROM test_1 l JOIN test_1 r ON l.colB = r.colB, with the left side in one block and in many
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  const Schema *scan_schema = MakeOutputSchema(
+      {{"colA", MakeColumnValueExpression(schema, 0, "colA")}, {"colB", MakeColumnValueExpression(schema, 0, "colB")}});
+  SeqScanPlanNode left_scan(scan_schema, nullptr, table_info->oid_);
+  SeqScanPlanNode right_scan(scan_schema, nullptr, table_info->oid_);
+  const Schema *out_schema = MakeOutputSchema({{"l_colA", MakeColumnValueExpression(*scan_schema, 0, "colA")},
+                                               {"r_colA", MakeColumnValueExpression(*scan_schema, 1, "colA")}});
+  auto *predicate = MakeComparisonExpression(MakeColumnValueExpression(*scan_schema, 0, "colB"),
+                                             MakeColumnValueExpression(*scan_schema, 1, "colB"), ComparisonType::Equal);
+
+  std::vector<Tuple> scan_result;
+  GetExecutionEngine()->Execute(&left_scan, &scan_result, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(TEST1_SIZE, scan_result.size());
+  std::multiset<std::pair<int32_t, int32_t>> expected;
+  for (const auto &l : scan_result) {
+    for (const auto &r : scan_result) {
+      if (l.GetValue(scan_schema, 1).GetAs<int32_t>() == r.GetValue(scan_schema, 1).GetAs<int32_t>()) {
+        expected.emplace(l.GetValue(scan_schema, 0).GetAs<int32_t>(), r.GetValue(scan_schema, 0).GetAs<int32_t>());
+      }
+    }
+  }
+
+  // a page holds some hundred left tuples, so a one page block takes several scans of the right side
+  for (int block_pages : {NESTED_LOOP_JOIN_BLOCK_PAGES, 1}) {
+    SCOPED_TRACE(block_pages);
+    NestedLoopJoinPlanNode join_plan(out_schema, {&left_scan, &right_scan}, predicate, block_pages);
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    std::multiset<std::pair<int32_t, int32_t>> rows;
+    for (const auto &tuple : result_set) {
+      rows.emplace(tuple.GetValue(out_schema, 0).GetAs<int32_t>(), tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+    }
+    EXPECT_EQ(expected, rows);
+
+    // and a tuple at a time
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+    executor->Init();
+    Tuple tuple;
+    RID rid;
+    size_t count = 0;
+    while (executor->Next(&tuple, &rid)) {
+      count++;
+    }
+    EXPECT_EQ(expected.size(), count);
+  }
+
+  // nothing joins with an empty right side
+  auto empty_info = GetExecutorContext()->GetCatalog()->GetTable("empty_table");
+  const Schema *empty_schema =
+      MakeOutputSchema({{"colA", MakeColumnValueExpression(empty_info->schema_, 0, "colA")}});
+  SeqScanPlanNode empty_scan(empty_schema, nullptr, empty_info->oid_);
+  NestedLoopJoinPlanNode empty_plan(out_schema, {&left_scan, &empty_scan}, nullptr, 1);
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&empty_plan, &result_set, GetTxn(), GetExecutorContext());
+  EXPECT_TRUE(result_set.empty());
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, SimpleHashJoinTest) {
+  // SELECT test_1.colA, test_1.colB, test_2.col1, test_2.col3 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1 AND
+  // test_1.colA < 50
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    auto const50 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(50));
+    auto predicate = MakeComparisonExpression(colA, const50, ComparisonType::LessThan);
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, predicate, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col3 = MakeColumnValueExpression(schema, 0, "col3");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col3", col3}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<HashJoinPlanNode> join_plan;
+  const Schema *out_final;
+  {
+    auto colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+    auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+    auto col3 = MakeColumnValueExpression(*out_schema2, 1, "col3");
+    out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}, {"col3", col3}});
+    // the keys of each side are evaluated on the tuples of that side alone
+    join_plan = std::make_unique<HashJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()},
+        std::vector<const AbstractExpression *>{MakeColumnValueExpression(*out_schema1, 0, "colA")},
+        std::vector<const AbstractExpression *>{MakeColumnValueExpression(*out_schema2, 0, "col1")});
+  }
+
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(join_plan.get(), &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 50);
+
+  for (const auto &tuple : result_set) {
+    auto col_a_val = tuple.GetValue(out_final, out_final->GetColIdx("colA")).GetAs<int32_t>();
+    auto col_1_val = tuple.GetValue(out_final, out_final->GetColIdx("col1")).GetAs<int16_t>();
+    ASSERT_EQ(col_a_val, col_1_val);
+    ASSERT_LT(col_a_val, 50);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, HashJoinSpillTest) {
+  // SELECT l.id, l.k, r.id FROM l JOIN r ON l.k = r.k AND l.id < r.id, in memory and partitioned to disk
+  Schema schema({Column("id", TypeId::INTEGER), Column("k", TypeId::INTEGER)});
+  auto make_table = [&](const std::string &name, int num_tuples, const std::function<Value(int)> &key_of) {
+    TableMetadata *table_info = GetCatalog()->CreateTable(GetTxn(), name, schema);
+    for (int i = 0; i < num_tuples; i++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(i), key_of(i)}, &schema);
+      RID rid;
+      EXPECT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+    }
+    return table_info;
+  };
+  // null keys join with nothing
+  auto *left_info = make_table("l", 3000, [](int i) {
+    return i % 97 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i % 400);
+  });
+  auto *right_info = make_table("r", 2000, [](int i) { return ValueFactory::GetIntegerValue(i * 7 % 500); });
+  // every tuple has the same key, so that partitioning never splits them up
+  auto *skew_info = make_table("skew", 300, [](int i) { return ValueFactory::GetIntegerValue(5); });
+
+  auto make_scan = [&](TableMetadata *table_info, const Schema **out_schema) {
+    *out_schema = MakeOutputSchema({{"id", MakeColumnValueExpression(table_info->schema_, 0, "id")},
+                                    {"k", MakeColumnValueExpression(table_info->schema_, 0, "k")}});
+    return std::make_unique<SeqScanPlanNode>(*out_schema, nullptr, table_info->oid_);
+  };
+  const Schema *left_schema;
+  const Schema *right_schema;
+  const Schema *skew_schema;
+  auto left_scan = make_scan(left_info, &left_schema);
+  auto right_scan = make_scan(right_info, &right_schema);
+  auto skew_scan = make_scan(skew_info, &skew_schema);
+  const Schema *out_schema = MakeOutputSchema({{"l_id", MakeColumnValueExpression(*left_schema, 0, "id")},
+                                               {"l_k", MakeColumnValueExpression(*left_schema, 0, "k")},
+                                               {"r_id", MakeColumnValueExpression(*right_schema, 1, "id")}});
+  auto *predicate = MakeComparisonExpression(MakeColumnValueExpression(*left_schema, 0, "id"),
+                                             MakeColumnValueExpression(*right_schema, 1, "id"),
+                                             ComparisonType::LessThan);
+
+  using Row = std::tuple<int32_t, int32_t, int32_t>;
+  std::multiset<Row> expected;
+  for (int l = 0; l < 3000; l++) {
+    for (int r = l + 1; r < 2000; r++) {
+      if (l % 97 != 0 && l % 400 == r * 7 % 500) {
+        expected.emplace(l, l % 400, r);
+      }
+    }
+  }
+  std::multiset<Row> expected_skew;
+  for (int l = 0; l < 300; l++) {
+    for (int r = 0; r < 300; r++) {
+      expected_skew.emplace(l, 5, r);
+    }
+  }
+
+  auto to_rows = [&](const std::vector<Tuple> &tuples) {
+    std::multiset<Row> rows;
+    for (const auto &tuple : tuples) {
+      rows.emplace(tuple.GetValue(out_schema, 0).GetAs<int32_t>(), tuple.GetValue(out_schema, 1).GetAs<int32_t>(),
+                   tuple.GetValue(out_schema, 2).GetAs<int32_t>());
+    }
+    return rows;
+  };
+  for (int memory_pages : {HASH_JOIN_MEMORY_PAGES, 4, 1}) {
+    SCOPED_TRACE(memory_pages);
+    HashJoinPlanNode join_plan(out_schema, {left_scan.get(), right_scan.get()},
+                               {MakeColumnValueExpression(*left_schema, 0, "k")},
+                               {MakeColumnValueExpression(*right_schema, 0, "k")}, predicate, memory_pages);
+    // a batch at a time through the engine, and a tuple at a time
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    EXPECT_EQ(expected, to_rows(result_set));
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+    executor->Init();
+    result_set.clear();
+    Tuple tuple;
+    RID rid;
+    while (executor->Next(&tuple, &rid)) {
+      result_set.push_back(tuple);
+    }
+    EXPECT_EQ(expected, to_rows(result_set));
+
+    HashJoinPlanNode skew_plan(out_schema, {skew_scan.get(), skew_scan.get()},
+                               {MakeColumnValueExpression(*skew_schema, 0, "k")},
+                               {MakeColumnValueExpression(*skew_schema, 0, "k")}, nullptr, memory_pages);
+    result_set.clear();
+    GetExecutionEngine()->Execute(&skew_plan, &result_set, GetTxn(), GetExecutorContext());
+    EXPECT_EQ(expected_skew, to_rows(result_set));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, HashJoinSmallRightTest) {
+  // SELECT l.id, l.k, r.id FROM l JOIN r ON l.k = r.k, the right side a sliver of the left
+  Schema schema({Column("id", TypeId::INTEGER), Column("k", TypeId::INTEGER)});
+  auto make_table = [&](const std::string &name, int num_tuples, const std::function<int(int)> &key_of) {
+    TableMetadata *table_info = GetCatalog()->CreateTable(GetTxn(), name, schema);
+    for (int i = 0; i < num_tuples; i++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(key_of(i))}, &schema);
+      RID rid;
+      EXPECT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+    }
+    return table_info;
+  };
+  auto *left_info = make_table("big", 5000, [](int i) { return i % 100; });
+  auto *right_info = make_table("small", 20, [](int i) { return 99 - i * 5; });
+  auto make_scan = [&](TableMetadata *table_info, const Schema **out_schema) {
+    *out_schema = MakeOutputSchema({{"id", MakeColumnValueExpression(table_info->schema_, 0, "id")},
+                                    {"k", MakeColumnValueExpression(table_info->schema_, 0, "k")}});
+    return std::make_unique<SeqScanPlanNode>(*out_schema, nullptr, table_info->oid_);
+  };
+  const Schema *left_schema;
+  const Schema *right_schema;
+  auto left_scan = make_scan(left_info, &left_schema);
+  auto right_scan = make_scan(right_info, &right_schema);
+  const Schema *out_schema = MakeOutputSchema({{"l_id", MakeColumnValueExpression(*left_schema, 0, "id")},
+                                               {"l_k", MakeColumnValueExpression(*left_schema, 0, "k")},
+                                               {"r_id", MakeColumnValueExpression(*right_schema, 1, "id")}});
+
+  // the hash table is built on the right side, so the left side probes it in order, even past a budget it exceeds
+  for (int memory_pages : {HASH_JOIN_MEMORY_PAGES, 1}) {
+    SCOPED_TRACE(memory_pages);
+    HashJoinPlanNode join_plan(out_schema, {left_scan.get(), right_scan.get()},
+                               {MakeColumnValueExpression(*left_schema, 0, "k")},
+                               {MakeColumnValueExpression(*right_schema, 0, "k")}, nullptr, memory_pages);
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(20 * 50, result_set.size());
+    int32_t last_l_id = -1;
+    for (const auto &tuple : result_set) {
+      int32_t l_id = tuple.GetValue(out_schema, 0).GetAs<int32_t>();
+      int32_t l_k = tuple.GetValue(out_schema, 1).GetAs<int32_t>();
+      int32_t r_id = tuple.GetValue(out_schema, 2).GetAs<int32_t>();
+      EXPECT_LT(last_l_id, l_id);
+      EXPECT_EQ(l_id % 100, l_k);
+      EXPECT_EQ(99 - r_id * 5, l_k);
+      last_l_id = l_id;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, DISABLED_HashJoinBenchmark) {
+  // SELECT l.colA, r.colB FROM test_1 l JOIN test_1 r ON l.colA = r.colA, nested loop join against hash join
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  const Schema *scan_schema = MakeOutputSchema(
+      {{"colA", MakeColumnValueExpression(schema, 0, "colA")}, {"colB", MakeColumnValueExpression(schema, 0, "colB")}});
+  SeqScanPlanNode left_scan(scan_schema, nullptr, table_info->oid_);
+  SeqScanPlanNode right_scan(scan_schema, nullptr, table_info->oid_);
+  auto *left_colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *right_colA = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  const Schema *out_schema =
+      MakeOutputSchema({{"colA", left_colA}, {"colB", MakeColumnValueExpression(*scan_schema, 1, "colB")}});
+
+  NestedLoopJoinPlanNode nested_loop_plan(out_schema, {&left_scan, &right_scan},
+                                          MakeComparisonExpression(left_colA, right_colA, ComparisonType::Equal));
+  std::vector<Tuple> nested_loop_result;
+  auto start = std::chrono::steady_clock::now();
+  GetExecutionEngine()->Execute(&nested_loop_plan, &nested_loop_result, GetTxn(), GetExecutorContext());
+  auto nested_loop_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  HashJoinPlanNode hash_plan(out_schema, {&left_scan, &right_scan},
+                             {MakeColumnValueExpression(*scan_schema, 0, "colA")},
+                             {MakeColumnValueExpression(*scan_schema, 0, "colA")});
+  std::vector<Tuple> hash_result;
+  start = std::chrono::steady_clock::now();
+  GetExecutionEngine()->Execute(&hash_plan, &hash_result, GetTxn(), GetExecutorContext());
+  auto hash_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_EQ(TEST1_SIZE, hash_result.size());
+  EXPECT_EQ(nested_loop_result.size(), hash_result.size());
+  RecordProperty("nested_loop_join_seconds", std::to_string(nested_loop_elapsed));
+  RecordProperty("hash_join_seconds", std::to_string(hash_elapsed));
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, SortTest) {
+  // SELECT * FROM t ORDER BY k DESC, g ASC, in memory, merged from runs on disk, and under a limit
+  Schema schema({Column("id", TypeId::INTEGER), Column("k", TypeId::INTEGER), Column("g", TypeId::INTEGER)});
+  TableMetadata *table_info = GetCatalog()->CreateTable(GetTxn(), "t", schema);
+  const int num_tuples = 5000;
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    Value k = i % 101 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                           : ValueFactory::GetIntegerValue(i * 7919 % 300);
+    Tuple tuple({ValueFactory::GetIntegerValue(i), k, ValueFactory::GetIntegerValue(i % 3)}, &schema);
+    EXPECT_TRUE(table_info->table_->InsertTuple(tuple, &rids[i], GetTxn()));
+  }
+  const Schema *out_schema = MakeOutputSchema({{"id", MakeColumnValueExpression(schema, 0, "id")},
+                                               {"k", MakeColumnValueExpression(schema, 0, "k")},
+                                               {"g", MakeColumnValueExpression(schema, 0, "g")}});
+  SeqScanPlanNode scan_plan(out_schema, nullptr, table_info->oid_);
+
+  // null keys sort last in descending order, and equal keys keep the order of the scan
+  std::vector<std::pair<int32_t, int32_t>> expected;
+  for (int i = 0; i < num_tuples; i++) {
+    expected.emplace_back(i, i % 101 == 0 ? -1 : i * 7919 % 300);
+  }
+  std::stable_sort(expected.begin(), expected.end(), [](const auto &lhs, const auto &rhs) {
+    return lhs.second != rhs.second ? lhs.second > rhs.second : lhs.first % 3 < rhs.first % 3;
+  });
+  auto to_rows = [&](const std::vector<Tuple> &tuples) {
+    std::vector<std::pair<int32_t, int32_t>> rows;
+    for (const auto &tuple : tuples) {
+      Value k = tuple.GetValue(out_schema, 1);
+      rows.emplace_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>(), k.IsNull() ? -1 : k.GetAs<int32_t>());
+    }
+    return rows;
+  };
+
+  // a page holds some hundred tuples, so that a one page budget writes many runs and merges them in several passes
+  for (int memory_pages : {SORT_MEMORY_PAGES, 8, 1}) {
+    SCOPED_TRACE(memory_pages);
+    SortPlanNode sort_plan(
+        out_schema, &scan_plan,
+        {MakeColumnValueExpression(*out_schema, 0, "k"), MakeColumnValueExpression(*out_schema, 0, "g")},
+        {OrderByType::Desc, OrderByType::Asc}, memory_pages);
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&sort_plan, &result_set, GetTxn(), GetExecutorContext());
+    EXPECT_EQ(expected, to_rows(result_set));
+
+    // every tuple keeps the RID the scan returned it with, whether it went through a run on disk or not
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &sort_plan);
+    executor->Init();
+    Tuple tuple;
+    RID rid;
+    size_t num_checked = 0;
+    while (executor->Next(&tuple, &rid)) {
+      EXPECT_EQ(rids[tuple.GetValue(out_schema, 0).GetAs<int32_t>()], rid);
+      num_checked++;
+    }
+    EXPECT_EQ(static_cast<size_t>(num_tuples), num_checked);
+
+    // a limit right above the sort makes it keep the tuples the limit returns, or sort everything once they do not
+    // fit in memory
+    for (size_t limit : {static_cast<size_t>(0), static_cast<size_t>(10), static_cast<size_t>(3000)}) {
+      SCOPED_TRACE(limit);
+      LimitPlanNode limit_plan(out_schema, &sort_plan, limit, 5);
+      result_set.clear();
+      GetExecutionEngine()->Execute(&limit_plan, &result_set, GetTxn(), GetExecutorContext());
+      std::vector<std::pair<int32_t, int32_t>> expected_limit(expected.begin() + 5, expected.begin() + 5 + limit);
+      EXPECT_EQ(expected_limit, to_rows(result_set));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, MergeJoinTest) {
+  // SELECT l.id, l.k, r.id FROM l JOIN r ON l.k = r.k AND l.id < r.id, both sides sorted on k
+  Schema schema({Column("id", TypeId::INTEGER), Column("k", TypeId::INTEGER)});
+  auto make_table = [&](const std::string &name, int num_tuples, const std::function<Value(int)> &key_of) {
+    TableMetadata *table_info = GetCatalog()->CreateTable(GetTxn(), name, schema);
+    for (int i = 0; i < num_tuples; i++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(i), key_of(i)}, &schema);
+      RID rid;
+      EXPECT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+    }
+    return table_info;
+  };
+  // runs of equal keys on both sides, keys on one side only, and null keys, which join with nothing
+  auto *left_info = make_table("l", 1500, [](int i) {
+    return i % 97 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i % 400);
+  });
+  auto *right_info = make_table("r", 1000, [](int i) {
+    return i % 89 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i * 7 % 500);
+  });
+
+  auto make_sorted_scan = [&](TableMetadata *table_info, const Schema **out_schema,
+                              std::unique_ptr<SeqScanPlanNode> *scan_plan) {
+    *out_schema = MakeOutputSchema({{"id", MakeColumnValueExpression(table_info->schema_, 0, "id")},
+                                    {"k", MakeColumnValueExpression(table_info->schema_, 0, "k")}});
+    *scan_plan = std::make_unique<SeqScanPlanNode>(*out_schema, nullptr, table_info->oid_);
+    std::vector<const AbstractExpression *> order_bys{MakeColumnValueExpression(**out_schema, 0, "k")};
+    return std::make_unique<SortPlanNode>(*out_schema, scan_plan->get(), std::move(order_bys),
+                                          std::vector<OrderByType>{OrderByType::Asc});
+  };
+  const Schema *left_schema;
+  const Schema *right_schema;
+  std::unique_ptr<SeqScanPlanNode> left_scan;
+  std::unique_ptr<SeqScanPlanNode> right_scan;
+  auto left_sort = make_sorted_scan(left_info, &left_schema, &left_scan);
+  auto right_sort = make_sorted_scan(right_info, &right_schema, &right_scan);
+  const Schema *out_schema = MakeOutputSchema({{"l_id", MakeColumnValueExpression(*left_schema, 0, "id")},
+                                               {"l_k", MakeColumnValueExpression(*left_schema, 0, "k")},
+                                               {"r_id", MakeColumnValueExpression(*right_schema, 1, "id")}});
+  auto *predicate = MakeComparisonExpression(MakeColumnValueExpression(*left_schema, 0, "id"),
+                                             MakeColumnValueExpression(*right_schema, 1, "id"),
+                                             ComparisonType::LessThan);
+  MergeJoinPlanNode join_plan(out_schema, {left_sort.get(), right_sort.get()},
+                              {MakeColumnValueExpression(*left_schema, 0, "k")},
+                              {MakeColumnValueExpression(*right_schema, 0, "k")}, predicate);
+
+  using Row = std::tuple<int32_t, int32_t, int32_t>;
+  std::multiset<Row> expected;
+  for (int l = 0; l < 1500; l++) {
+    for (int r = l + 1; r < 1000; r++) {
+      if (l % 97 != 0 && r % 89 != 0 && l % 400 == r * 7 % 500) {
+        expected.emplace(l, l % 400, r);
+      }
+    }
+  }
+  auto to_rows = [&](const std::vector<Tuple> &tuples) {
+    std::multiset<Row> rows;
+    for (const auto &tuple : tuples) {
+      rows.emplace(tuple.GetValue(out_schema, 0).GetAs<int32_t>(), tuple.GetValue(out_schema, 1).GetAs<int32_t>(),
+                   tuple.GetValue(out_schema, 2).GetAs<int32_t>());
+    }
+    return rows;
+  };
+
+  // a batch at a time through the engine, and a tuple at a time
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+  EXPECT_EQ(expected, to_rows(result_set));
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+  executor->Init();
+  result_set.clear();
+  Tuple tuple;
+  RID rid;
+  while (executor->Next(&tuple, &rid)) {
+    result_set.push_back(tuple);
+  }
+  EXPECT_EQ(expected, to_rows(result_set));
+}
+
 // NOLINTNEXTLINE
 TEST_F(GradingExecutorTest, SimpleAggregationTest) {
   // SELECT COUNT(colA), SUM(colA), min(colA), max(colA) from test_1;
@@ -612,6 +1183,135 @@ TEST_F(GradingExecutorTest, SimpleGroupByAggregation) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, BatchGroupByAggregationTest) {
+  // SELECT colB, count(colA), sum(colC), max(colD) FROM test_1 WHERE colA >= 100 GROUP BY colB HAVING count(colA) > 80
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")},
+                                        {"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colC", MakeColumnValueExpression(schema, 0, "colC")},
+                                        {"colD", MakeColumnValueExpression(schema, 0, "colD")}});
+  auto *predicate =
+      MakeComparisonExpression(MakeColumnValueExpression(*scan_schema, 0, "colA"),
+                               MakeConstantValueExpression(ValueFactory::GetIntegerValue(100)),
+                               ComparisonType::GreaterThanOrEqual);
+  SeqScanPlanNode scan_plan{scan_schema, predicate, table_info->oid_};
+
+  const AbstractExpression *countA = MakeAggregateValueExpression(false, 0);
+  const AbstractExpression *having = MakeComparisonExpression(
+      countA, MakeConstantValueExpression(ValueFactory::GetIntegerValue(80)), ComparisonType::GreaterThan);
+  auto *agg_schema = MakeOutputSchema({{"colB", MakeAggregateValueExpression(true, 0)},
+                                       {"countA", countA},
+                                       {"sumC", MakeAggregateValueExpression(false, 1)},
+                                       {"maxD", MakeAggregateValueExpression(false, 2)}});
+  AggregationPlanNode agg_plan{agg_schema,
+                               &scan_plan,
+                               having,
+                               {MakeColumnValueExpression(*scan_schema, 0, "colB")},
+                               {MakeColumnValueExpression(*scan_schema, 0, "colA"),
+                                MakeColumnValueExpression(*scan_schema, 0, "colC"),
+                                MakeColumnValueExpression(*scan_schema, 0, "colD")},
+                               {AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                AggregationType::MaxAggregate}};
+
+  // what the query should give, worked out from the table
+  std::map<int32_t, std::vector<int32_t>> expected;
+  for (auto itr = table_info->table_->Begin(GetTxn()); itr != table_info->table_->End(); ++itr) {
+    if (itr->GetValue(&schema, 0).GetAs<int32_t>() < 100) {
+      continue;
+    }
+    auto &group = expected[itr->GetValue(&schema, 1).GetAs<int32_t>()];
+    group.resize(3, 0);
+    group[0]++;
+    group[1] += itr->GetValue(&schema, 2).GetAs<int32_t>();
+    group[2] = std::max(group[2], itr->GetValue(&schema, 3).GetAs<int32_t>());
+  }
+  for (auto it = expected.begin(); it != expected.end();) {
+    it = it->second[0] > 80 ? std::next(it) : expected.erase(it);
+  }
+  ASSERT_FALSE(expected.empty());
+
+  auto to_groups = [&](const std::vector<Tuple> &tuples) {
+    std::map<int32_t, std::vector<int32_t>> groups;
+    for (const auto &tuple : tuples) {
+      groups[tuple.GetValue(agg_schema, 0).GetAs<int32_t>()] = {tuple.GetValue(agg_schema, 1).GetAs<int32_t>(),
+                                                                tuple.GetValue(agg_schema, 2).GetAs<int32_t>(),
+                                                                tuple.GetValue(agg_schema, 3).GetAs<int32_t>()};
+    }
+    return groups;
+  };
+
+  // batches, as the engine drives them
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(expected.size(), result_set.size());
+  ASSERT_EQ(expected, to_groups(result_set));
+
+  // and tuple at a time
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &agg_plan);
+  executor->Init();
+  result_set.clear();
+  Tuple tuple;
+  RID rid;
+  while (executor->Next(&tuple, &rid)) {
+    result_set.push_back(tuple);
+  }
+  ASSERT_EQ(expected, to_groups(result_set));
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, DISABLED_BatchScanBenchmark) {
+  // SELECT colA, colC FROM big WHERE colB < 5, over a table of 20000 tuples, tuple at a time and a batch at a time
+  Schema schema({Column("colA", TypeId::INTEGER), Column("colB", TypeId::INTEGER), Column("colC", TypeId::INTEGER),
+                 Column("colD", TypeId::INTEGER)});
+  TableMetadata *table_info = GetCatalog()->CreateTable(GetTxn(), "big", schema);
+  const int num_tuples = 20000;
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i % 10),
+                 ValueFactory::GetIntegerValue(i * 7 % 10000), ValueFactory::GetIntegerValue(i % 99999)},
+                &schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  auto *out_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(table_info->schema_, 0, "colA")},
+                                       {"colC", MakeColumnValueExpression(table_info->schema_, 0, "colC")},
+                                       {"colB", MakeColumnValueExpression(table_info->schema_, 0, "colB")}});
+  auto *predicate = MakeComparisonExpression(MakeColumnValueExpression(*out_schema, 0, "colB"),
+                                             MakeConstantValueExpression(ValueFactory::GetIntegerValue(5)),
+                                             ComparisonType::LessThan);
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+  // without a lock manager, so that both scans read the same way
+  ExecutorContext exec_ctx(GetTxn(), GetCatalog(), GetBPM(), GetTxnManager(), nullptr);
+
+  int64_t tuple_sum = 0;
+  SeqScanExecutor tuple_executor(&exec_ctx, &plan);
+  tuple_executor.Init();
+  auto start = std::chrono::steady_clock::now();
+  Tuple tuple;
+  RID rid;
+  while (tuple_executor.Next(&tuple, &rid)) {
+    tuple_sum += tuple.GetValue(out_schema, 1).GetAs<int32_t>();
+  }
+  auto tuple_elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  int64_t batch_sum = 0;
+  SeqScanExecutor batch_executor(&exec_ctx, &plan);
+  batch_executor.Init();
+  start = std::chrono::steady_clock::now();
+  TupleBatch batch;
+  while (batch_executor.NextBatch(&batch)) {
+    for (const Value &value : batch.GetColumn(1)) {
+      batch_sum += value.GetAs<int32_t>();
+    }
+  }
+  auto batch_elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_EQ(tuple_sum, batch_sum);
+  RecordProperty("tuple_at_a_time_ns_per_tuple", std::to_string(tuple_elapsed / num_tuples));
+  RecordProperty("batch_at_a_time_ns_per_tuple", std::to_string(batch_elapsed / num_tuples));
+}
+
 // NOLINTNEXTLINE
 TEST_F(GradingExecutorTest, SimpleNestedIndexJoinTest) {
   // SELECT test_1.colA, test_1.colB, test_3.col1, test_3.col3 FROM test_1 JOIN test_3 ON test_1.colA = test_3.col1
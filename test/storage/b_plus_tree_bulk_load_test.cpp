@@ -0,0 +1,334 @@
+/**
+ * b_plus_tree_bulk_load_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/index_entry_sorter.h"
+
+namespace bustub {
+
+namespace {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using LeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+using InternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+
+const int kLeafPageSize = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, RID>);
+const int kInternalPageSize = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, page_id_t>);
+
+/** Hands out the keys as entries whose slot number is the key. */
+std::function<bool(GenericKey<8> *, RID *)> KeySource(const std::vector<int64_t> &keys) {
+  auto next = std::make_shared<size_t>(0);
+  return [&keys, next](GenericKey<8> *key, RID *rid) {
+    if (*next == keys.size()) {
+      return false;
+    }
+    key->SetFromInteger(keys[*next]);
+    rid->Set(0, static_cast<uint32_t>(keys[*next]));
+    ++*next;
+    return true;
+  };
+}
+
+/** Checks sizes, parent pointers and key order below page_id; returns the depth of its leaves. */
+int CheckSubtree(BufferPoolManager *bpm, page_id_t page_id, page_id_t parent_id, int64_t low, int64_t high) {
+  Page *page = bpm->FetchPage(page_id);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  EXPECT_EQ(parent_id, node->GetParentPageId());
+  // an internal node of odd max size splits into halves below its min size
+  int min_size = node->IsLeafPage() ? node->GetMinSize() : std::min(node->GetMinSize(), node->GetMaxSize() / 2);
+  EXPECT_GE(node->GetSize(), min_size);
+  EXPECT_LT(node->GetSize(), node->GetMaxSize());
+  int depth = 0;
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      EXPECT_GE(leaf->KeyAt(i).ToString(), low);
+      EXPECT_LT(leaf->KeyAt(i).ToString(), high);
+    }
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      int64_t child_low = i == 0 ? low : internal->KeyAt(i).ToString();
+      int64_t child_high = i + 1 == internal->GetSize() ? high : internal->KeyAt(i + 1).ToString();
+      int child_depth = CheckSubtree(bpm, internal->ValueAt(i), page_id, child_low, child_high);
+      EXPECT_TRUE(i == 0 || child_depth == depth);
+      depth = child_depth;
+    }
+    depth++;
+  }
+  bpm->UnpinPage(page_id, false);
+  return depth;
+}
+
+int CountPages(BufferPoolManager *bpm, page_id_t page_id) {
+  auto *node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  int pages = 1;
+  if (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      pages += CountPages(bpm, internal->ValueAt(i));
+    }
+  }
+  bpm->UnpinPage(page_id, false);
+  return pages;
+}
+
+page_id_t GetRootPageId(BufferPoolManager *bpm) {
+  auto *header_page = reinterpret_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  page_id_t root_page_id = INVALID_PAGE_ID;
+  header_page->GetRootId("foo_pk", &root_page_id);
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  return root_page_id;
+}
+
+void CheckTree(BufferPoolManager *bpm, Tree *tree, const std::vector<int64_t> &keys) {
+  if (keys.empty()) {
+    EXPECT_TRUE(tree->IsEmpty());
+    return;
+  }
+  page_id_t root_page_id = GetRootPageId(bpm);
+  ASSERT_NE(INVALID_PAGE_ID, root_page_id);
+  CheckSubtree(bpm, root_page_id, INVALID_PAGE_ID, INT64_MIN, INT64_MAX);
+
+  size_t i = 0;
+  for (auto iterator = tree->begin(); iterator != tree->end(); ++iterator, i++) {
+    ASSERT_LT(i, keys.size());
+    EXPECT_EQ(keys[i], (*iterator).first.ToString());
+    EXPECT_EQ(keys[i], (*iterator).second.GetSlotNum());
+  }
+  EXPECT_EQ(keys.size(), i);
+  std::vector<RID> rids;
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree->GetValue(index_key, &rids)) << key;
+  }
+}
+
+}  // namespace
+
+TEST(BPlusTreeBulkLoadTests, BulkLoadTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  for (auto max_sizes : {std::make_pair(3, 3), std::make_pair(4, 5), std::make_pair(7, 6),
+                         std::make_pair(kLeafPageSize, kInternalPageSize)}) {
+    for (double fill_factor : {0.0, 0.5, 0.9, 1.0}) {
+      for (int num_keys : {0, 1, 2, 3, 5, 8, 13, 21, 50, 200, 2000}) {
+        SCOPED_TRACE(testing::Message() << "max sizes " << max_sizes.first << "/" << max_sizes.second << " fill "
+                                        << fill_factor << " keys " << num_keys);
+        DiskManager *disk_manager = new DiskManager("test.db");
+        BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+        page_id_t page_id;
+        bpm->NewPage(&page_id);
+        Tree tree("foo_pk", bpm, comparator, max_sizes.first, max_sizes.second);
+
+        std::vector<int64_t> keys;
+        for (int i = 0; i < num_keys; i++) {
+          keys.push_back(2 * i);
+        }
+        tree.BulkLoad(KeySource(keys), fill_factor);
+        CheckTree(bpm, &tree, keys);
+
+        bpm->UnpinPage(HEADER_PAGE_ID, true);
+        delete bpm;
+        delete disk_manager;
+        remove("test.db");
+      }
+    }
+  }
+  delete key_schema;
+}
+
+TEST(BPlusTreeBulkLoadTests, LoadThenModifyTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator);
+
+  // full nodes, so the inserts split them
+  const int num_keys = 20000;
+  std::vector<int64_t> keys;
+  for (int i = 0; i < num_keys; i++) {
+    keys.push_back(2 * i);
+  }
+  tree.BulkLoad(KeySource(keys), 1.0);
+
+  // the loaded tree takes inserts and removes as usual
+  Transaction transaction(0);
+  GenericKey<8> index_key;
+  for (int i = 0; i < num_keys; i++) {
+    index_key.SetFromInteger(2 * i + 1);
+    tree.Insert(index_key, RID(0, 2 * i + 1), &transaction);
+  }
+  for (int i = 0; i < num_keys; i += 2) {
+    index_key.SetFromInteger(2 * i);
+    tree.Remove(index_key, &transaction);
+  }
+  std::vector<int64_t> left;
+  for (int i = 0; i < 2 * num_keys; i++) {
+    if (i % 2 == 1 || i % 4 == 2) {
+      left.push_back(i);
+    }
+  }
+  CheckTree(bpm, &tree, left);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+}
+
+TEST(BPlusTreeBulkLoadTests, DuplicateAndNonEmptyTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator, 4, 4);
+
+  // of equal keys the first one stays
+  std::vector<int64_t> keys = {1, 1, 2, 3, 3, 3, 4};
+  size_t next = 0;
+  tree.BulkLoad([&](GenericKey<8> *key, RID *rid) {
+    if (next == keys.size()) {
+      return false;
+    }
+    key->SetFromInteger(keys[next]);
+    rid->Set(static_cast<page_id_t>(next), static_cast<uint32_t>(keys[next]));
+    next++;
+    return true;
+  });
+  std::vector<RID> rids;
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(3);
+  ASSERT_TRUE(tree.GetValue(index_key, &rids));
+  EXPECT_EQ(3, rids[0].GetPageId());
+
+  // a tree that is not empty gets the entries inserted
+  std::vector<int64_t> more_keys = {0, 5, 6, 7, 8, 9};
+  tree.BulkLoad(KeySource(more_keys));
+  std::vector<int64_t> all_keys = {1, 2, 3, 4, 0, 5, 6, 7, 8, 9};
+  for (auto key : all_keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids)) << key;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+}
+
+TEST(BPlusTreeBulkLoadTests, EntrySorterTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(10, disk_manager);
+
+  std::mt19937 rng(15445);
+  for (int num_entries : {0, 1, 100, 5000}) {
+    // one page of memory, so every few hundred entries are spilled as a run
+    IndexEntrySorter<GenericKey<8>, RID, GenericComparator<8>> sorter(bpm, comparator, 1);
+    std::vector<std::pair<int64_t, uint32_t>> entries;
+    for (int i = 0; i < num_entries; i++) {
+      entries.emplace_back(rng() % 1000, i);
+      GenericKey<8> key;
+      key.SetFromInteger(entries.back().first);
+      sorter.Add(key, RID(0, i));
+    }
+    sorter.Finish();
+    EXPECT_EQ(num_entries < 200, sorter.InMemory());
+    // equal keys keep the order they were added in
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+    GenericKey<8> key;
+    RID rid;
+    for (const auto &entry : entries) {
+      ASSERT_TRUE(sorter.Next(&key, &rid));
+      EXPECT_EQ(entry.first, key.ToString());
+      EXPECT_EQ(entry.second, rid.GetSlotNum());
+    }
+    EXPECT_FALSE(sorter.Next(&key, &rid));
+  }
+
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+}
+
+TEST(BPlusTreeBulkLoadTests, DISABLED_BulkLoadBenchmark) {
+  // Builds an index over shuffled keys by inserting them one by one and by sorting and bulk loading them.
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  const int num_keys = 100000;
+  std::vector<int64_t> keys(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+
+  for (bool bulk_load : {false, true}) {
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManager(256, disk_manager);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+    Tree tree("foo_pk", bpm, comparator);
+
+    auto start = std::chrono::steady_clock::now();
+    GenericKey<8> index_key;
+    if (bulk_load) {
+      IndexEntrySorter<GenericKey<8>, RID, GenericComparator<8>> sorter(bpm, comparator);
+      for (auto key : keys) {
+        index_key.SetFromInteger(key);
+        sorter.Add(index_key, RID(0, static_cast<uint32_t>(key)));
+      }
+      sorter.Finish();
+      tree.BulkLoad([&sorter](GenericKey<8> *key, RID *rid) { return sorter.Next(key, rid); });
+    } else {
+      for (auto key : keys) {
+        index_key.SetFromInteger(key);
+        tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+      }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int entries = 0;
+    for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator, entries++) {
+      ASSERT_EQ(entries, (*iterator).second.GetSlotNum());
+    }
+    EXPECT_EQ(num_keys, entries);
+    std::string prefix = bulk_load ? "bulk_load_" : "insert_";
+    RecordProperty(prefix + "seconds", std::to_string(elapsed));
+    RecordProperty(prefix + "tree_pages", std::to_string(CountPages(bpm, GetRootPageId(bpm))));
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+    remove("test.db");
+  }
+  delete key_schema;
+}
+
+}  // namespace bustub
@@ -5,11 +5,14 @@
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
-#include <future>                   // NOLINT
+#include <future>  // NOLINT
+#include <random>
+#include <string>
 #include <thread>                   // NOLINT
 #include "b_plus_tree_test_util.h"  // NOLINT
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "storage/index/b_plus_tree.h"
 // Macro for time out mechanism
@@ -994,4 +997,61 @@ TEST(BPlusTreeConcurrentTest, MixTest3) {
   TEST_TIMEOUT_FAIL_END(1000 * 600)
 }
 
+TEST(BPlusTreeConcurrentTest, DISABLED_OptimisticLookupBenchmark) {
+  // Random point lookups from 1 to 64 threads over a tree that fits in the buffer pool. Lookups take no page latch,
+  // so the threads only share the buffer pool instances they pin pages in.
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new ParallelBufferPoolManager(16, 64, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 50000;
+  const int lookups_per_thread = 5000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    keys.push_back(key);
+  }
+  InsertHelper(&tree, keys, 1);
+
+  for (int num_threads : {1, 2, 4, 8, 16, 32, 64}) {
+    std::atomic<int> misses{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([&tree, &misses, tid]() {
+        Transaction transaction(tid);
+        std::mt19937_64 rng(tid);
+        std::uniform_int_distribution<int64_t> dist(1, num_keys);
+        GenericKey<8> index_key;
+        std::vector<RID> result;
+        for (int i = 0; i < lookups_per_thread; i++) {
+          int64_t key = dist(rng);
+          index_key.SetFromInteger(key);
+          if (!tree.GetValue(index_key, &result, &transaction) || result[0].GetSlotNum() != key) {
+            misses++;
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(misses, 0);
+    RecordProperty("lookups_per_sec_threads_" + std::to_string(num_threads),
+                   std::to_string(static_cast<uint64_t>(num_threads * lookups_per_thread / elapsed)));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
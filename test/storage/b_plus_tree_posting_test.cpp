@@ -0,0 +1,268 @@
+/**
+ * b_plus_tree_posting_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+// values per key, from an inline RID through every slot size to lists with overflow pages
+const std::vector<int> DUPLICATES = {1, 2, 3, 5, 17, 130, 600, 1200};
+
+template <typename KeyComparator>
+GenericKey<8> MakeKey(int64_t i, Schema *schema, const KeyComparator &comparator) {
+  Tuple tuple({ValueFactory::GetIntegerValue(static_cast<int32_t>(i))}, schema);
+  GenericKey<8> key;
+  MakeIndexKey(tuple, comparator, &key);
+  return key;
+}
+
+// the default max sizes of GenericKey<8> pages
+const int FULL_LEAF = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, RID>);
+const int FULL_INTERNAL = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, page_id_t>);
+
+using Expected = std::map<int64_t, std::set<int64_t>>;
+
+template <typename KeyComparator>
+void CheckTree(BPlusTree<GenericKey<8>, RID, KeyComparator> *tree, const Expected &expected, int num_keys,
+               Schema *schema, const KeyComparator &comparator) {
+  // every key gives back all of its values
+  for (int64_t k = 0; k < num_keys; k++) {
+    std::vector<RID> rids;
+    auto it = expected.find(k);
+    bool found = tree->GetValue(MakeKey(k, schema, comparator), &rids);
+    ASSERT_EQ(it != expected.end(), found) << k;
+    std::set<int64_t> values;
+    for (const RID &rid : rids) {
+      EXPECT_EQ(k, rid.GetPageId());
+      values.insert(rid.Get());
+    }
+    EXPECT_EQ(rids.size(), values.size()) << k;
+    if (found) {
+      EXPECT_EQ(it->second, values) << k;
+    }
+  }
+
+  // so does the iterator, key after key
+  Expected scanned;
+  int64_t last_key = -1;
+  for (auto iterator = tree->begin(); iterator != tree->end(); ++iterator) {
+    RID rid = (*iterator).second;
+    EXPECT_LE(last_key, rid.GetPageId());
+    last_key = rid.GetPageId();
+    EXPECT_TRUE(scanned[rid.GetPageId()].insert(rid.Get()).second);
+  }
+  EXPECT_EQ(expected, scanned);
+}
+
+template <typename KeyComparator>
+void RunPostingTest(int leaf_max_size, int internal_max_size) {
+  Schema *key_schema = ParseCreateStatement("a integer");
+  KeyComparator comparator(key_schema);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(128, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, KeyComparator> tree("foo_pk", bpm, comparator, leaf_max_size, internal_max_size,
+                                                    false);
+  Transaction transaction(0);
+
+  const int num_keys = 64;
+  std::vector<std::pair<int64_t, RID>> entries;
+  for (int64_t k = 0; k < num_keys; k++) {
+    for (int j = 0; j < DUPLICATES[k % DUPLICATES.size()]; j++) {
+      entries.emplace_back(k, RID(static_cast<page_id_t>(k), j));
+    }
+  }
+  std::mt19937 rng(15445);
+  std::shuffle(entries.begin(), entries.end(), rng);
+  Expected expected;
+  for (const auto &[k, rid] : entries) {
+    EXPECT_TRUE(tree.Insert(MakeKey(k, key_schema, comparator), rid, &transaction));
+    expected[k].insert(rid.Get());
+  }
+  CheckTree(&tree, expected, num_keys, key_schema, comparator);
+
+  // lists shrink to smaller slots and back into the leaf, their keys go with their last value
+  std::shuffle(entries.begin(), entries.end(), rng);
+  size_t removed = entries.size() * 3 / 4;
+  for (size_t i = 0; i < removed; i++) {
+    auto [k, rid] = entries[i];
+    tree.RemoveValue(MakeKey(k, key_schema, comparator), rid, &transaction);
+    expected[k].erase(rid.Get());
+    if (expected[k].empty()) {
+      expected.erase(k);
+    }
+  }
+  // values the tree does not hold leave it as it is
+  tree.RemoveValue(MakeKey(num_keys - 1, key_schema, comparator), RID(num_keys - 1, 100000), &transaction);
+  CheckTree(&tree, expected, num_keys, key_schema, comparator);
+
+  for (size_t i = 0; i < removed / 2; i++) {
+    auto [k, rid] = entries[i];
+    EXPECT_TRUE(tree.Insert(MakeKey(k, key_schema, comparator), rid, &transaction));
+    expected[k].insert(rid.Get());
+  }
+  CheckTree(&tree, expected, num_keys, key_schema, comparator);
+
+  // removing a key drops its whole list
+  for (int64_t k = 0; k < num_keys; k += 2) {
+    if (expected.count(k) > 0) {
+      tree.Remove(MakeKey(k, key_schema, comparator), &transaction);
+      expected.erase(k);
+    }
+  }
+  CheckTree(&tree, expected, num_keys, key_schema, comparator);
+  for (const auto &[k, values] : expected) {
+    for (int64_t value : values) {
+      tree.RemoveValue(MakeKey(k, key_schema, comparator), RID(value), &transaction);
+    }
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace
+
+TEST(BPlusTreePostingTests, SmallPagesTest) { RunPostingTest<GenericComparator<8>>(4, 4); }
+
+TEST(BPlusTreePostingTests, FullPagesTest) { RunPostingTest<GenericComparator<8>>(FULL_LEAF, FULL_INTERNAL); }
+
+TEST(BPlusTreePostingTests, PrefixCompressedTest) { RunPostingTest<MemcmpComparator<8>>(4, 4); }
+
+TEST(BPlusTreePostingTests, UniqueTest) {
+  Schema *key_schema = ParseCreateStatement("a integer");
+  GenericComparator<8> comparator(key_schema);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  Transaction transaction(0);
+
+  GenericKey<8> key = MakeKey(1, key_schema, comparator);
+  EXPECT_TRUE(tree.Insert(key, RID(1, 0), &transaction));
+  EXPECT_FALSE(tree.Insert(key, RID(1, 1), &transaction));
+  std::vector<RID> rids;
+  EXPECT_TRUE(tree.GetValue(key, &rids));
+  EXPECT_EQ(std::vector<RID>{RID(1, 0)}, rids);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreePostingTests, ReopenTest) {
+  Schema *key_schema = ParseCreateStatement("a integer");
+  GenericComparator<8> comparator(key_schema);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Transaction transaction(0);
+
+  // two lists share a posting page, and one of them goes back into its leaf, leaving a free slot
+  {
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, FULL_LEAF, FULL_INTERNAL,
+                                                             false);
+    for (int64_t k : {1, 2}) {
+      for (int j = 0; j < 2; j++) {
+        EXPECT_TRUE(tree.Insert(MakeKey(k, key_schema, comparator), RID(static_cast<page_id_t>(k), j), &transaction));
+      }
+    }
+    tree.RemoveValue(MakeKey(1, key_schema, comparator), RID(1, 1), &transaction);
+  }
+
+  // opened again, the tree finds its values and fills the free slot rather than a new page
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, FULL_LEAF, FULL_INTERNAL,
+                                                           false);
+  std::vector<RID> rids;
+  EXPECT_TRUE(tree.GetValue(MakeKey(2, key_schema, comparator), &rids));
+  EXPECT_EQ(2, rids.size());
+  page_id_t next_page_id;
+  bpm->NewPage(&next_page_id);
+  bpm->UnpinPage(next_page_id, false);
+  bpm->DeletePage(next_page_id);
+  for (int j = 0; j < 2; j++) {
+    EXPECT_TRUE(tree.Insert(MakeKey(3, key_schema, comparator), RID(3, j), &transaction));
+  }
+  rids.clear();
+  EXPECT_TRUE(tree.GetValue(MakeKey(3, key_schema, comparator), &rids));
+  EXPECT_EQ(2, rids.size());
+  bpm->NewPage(&page_id);
+  EXPECT_EQ(next_page_id, page_id);
+  bpm->UnpinPage(page_id, false);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreePostingTests, BulkLoadTest) {
+  Schema *key_schema = ParseCreateStatement("a integer");
+  GenericComparator<8> comparator(key_schema);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(128, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, FULL_LEAF, FULL_INTERNAL,
+                                                           false);
+
+  const int num_keys = 2000;
+  Expected expected;
+  std::vector<std::pair<int64_t, RID>> entries;
+  for (int64_t k = 0; k < num_keys; k++) {
+    for (int j = 0; j < DUPLICATES[k % DUPLICATES.size()] % 50; j++) {
+      entries.emplace_back(k, RID(static_cast<page_id_t>(k), j));
+      expected[k].insert(entries.back().second.Get());
+    }
+  }
+  size_t next = 0;
+  tree.BulkLoad([&](GenericKey<8> *key, RID *rid) {
+    if (next == entries.size()) {
+      return false;
+    }
+    *key = MakeKey(entries[next].first, key_schema, comparator);
+    *rid = entries[next].second;
+    next++;
+    return true;
+  });
+  CheckTree(&tree, expected, num_keys, key_schema, comparator);
+  // a key takes one leaf entry however many values it has
+  EXPECT_EQ(static_cast<int64_t>(expected.size()), tree.GetStats().entries_);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
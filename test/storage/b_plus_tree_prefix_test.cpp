@@ -0,0 +1,272 @@
+/**
+ * b_plus_tree_prefix_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/header_page.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+using Key = GenericKey<32>;
+using Comparator = MemcmpComparator<32>;
+using Tree = BPlusTree<Key, RID, Comparator>;
+using LeafPage = BPlusTreeLeafPage<Key, RID, Comparator>;
+using InternalPage = BPlusTreeInternalPage<Key, page_id_t, Comparator>;
+
+/** (integer, varchar) keys whose varchars share a long prefix. */
+Key MakeKey(int i, Schema *schema) {
+  char name[32];
+  snprintf(name, sizeof(name), "customer#%08d", i);
+  Tuple tuple({ValueFactory::GetIntegerValue(i % 3), ValueFactory::GetVarcharValue(name)}, schema);
+  Key key;
+  key.SetFromKey(tuple, schema);
+  return key;
+}
+
+std::string KeyBytes(const Key &key) { return std::string(key.data_, sizeof(key.data_)); }
+
+bool SameFence(const Key *fence, const Key *bound) {
+  return fence == nullptr ? bound == nullptr : bound != nullptr && KeyBytes(*fence) == KeyBytes(*bound);
+}
+
+/**
+ * Checks that the keys below page_id are in order between the separators bounding the page, and that every page has
+ * those separators as its fences; returns the depth of its leaves.
+ */
+int CheckSubtree(BufferPoolManager *bpm, page_id_t page_id, const Key *low, const Key *high,
+                 std::vector<std::string> *keys) {
+  Page *page = bpm->FetchPage(page_id);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  EXPECT_LE(node->GetSize(), node->GetMaxSize());
+  int depth = 0;
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    EXPECT_TRUE(SameFence(leaf->GetLowFence(), low));
+    EXPECT_TRUE(SameFence(leaf->GetHighFence(), high));
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      std::string key = KeyBytes(leaf->KeyAt(i));
+      EXPECT_TRUE(low == nullptr || KeyBytes(*low) <= key);
+      EXPECT_TRUE(high == nullptr || key < KeyBytes(*high));
+      EXPECT_TRUE(keys->empty() || keys->back() < key);
+      keys->push_back(key);
+    }
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    EXPECT_TRUE(SameFence(internal->GetLowFence(), low));
+    EXPECT_TRUE(SameFence(internal->GetHighFence(), high));
+    std::vector<Key> separators(internal->GetSize());
+    for (int i = 1; i < internal->GetSize(); i++) {
+      separators[i] = internal->KeyAt(i);
+    }
+    for (int i = 0; i < internal->GetSize(); i++) {
+      const Key *child_low = i == 0 ? low : &separators[i];
+      const Key *child_high = i + 1 == internal->GetSize() ? high : &separators[i + 1];
+      int child_depth = CheckSubtree(bpm, internal->ValueAt(i), child_low, child_high, keys);
+      EXPECT_TRUE(i == 0 || child_depth == depth);
+      depth = child_depth;
+    }
+    depth++;
+  }
+  bpm->UnpinPage(page_id, false);
+  return depth;
+}
+
+page_id_t GetRootPageId(BufferPoolManager *bpm) {
+  auto *header_page = reinterpret_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  page_id_t root_page_id = INVALID_PAGE_ID;
+  header_page->GetRootId("foo_pk", &root_page_id);
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  return root_page_id;
+}
+
+void CheckTree(BufferPoolManager *bpm, Tree *tree, const std::map<std::string, int> &expected, Schema *schema) {
+  if (expected.empty()) {
+    EXPECT_TRUE(tree->IsEmpty());
+    return;
+  }
+  std::vector<std::string> keys;
+  CheckSubtree(bpm, GetRootPageId(bpm), nullptr, nullptr, &keys);
+  ASSERT_EQ(expected.size(), keys.size());
+
+  auto iterator = tree->begin();
+  for (const auto &[key, i] : expected) {
+    ASSERT_NE(tree->end(), iterator);
+    EXPECT_EQ(key, KeyBytes((*iterator).first));
+    EXPECT_EQ(i, (*iterator).second.GetSlotNum());
+    ++iterator;
+    std::vector<RID> rids;
+    ASSERT_TRUE(tree->GetValue(MakeKey(i, schema), &rids)) << i;
+    EXPECT_EQ(i, rids[0].GetSlotNum());
+  }
+  EXPECT_EQ(tree->end(), iterator);
+}
+
+void RunRandomTest(int leaf_max_size, int internal_max_size, int num_keys) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 20)});
+  Comparator comparator(&schema);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(256, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator, leaf_max_size, internal_max_size);
+  Transaction transaction(0);
+
+  std::vector<int> order(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    order[i] = i;
+  }
+  std::mt19937 rng(15445);
+  std::shuffle(order.begin(), order.end(), rng);
+  std::map<std::string, int> expected;
+  for (int i : order) {
+    Key key = MakeKey(i, &schema);
+    EXPECT_TRUE(tree.Insert(key, RID(0, i), &transaction));
+    expected[KeyBytes(key)] = i;
+  }
+  EXPECT_FALSE(tree.Insert(MakeKey(order[0], &schema), RID(0, 0), &transaction));
+  CheckTree(bpm, &tree, expected, &schema);
+
+  // merges and redistributions move fences around, as does growing back
+  std::shuffle(order.begin(), order.end(), rng);
+  for (int n = 0; n < num_keys * 3 / 4; n++) {
+    Key key = MakeKey(order[n], &schema);
+    tree.Remove(key, &transaction);
+    expected.erase(KeyBytes(key));
+  }
+  CheckTree(bpm, &tree, expected, &schema);
+  for (int n = 0; n < num_keys / 4; n++) {
+    Key key = MakeKey(order[n], &schema);
+    tree.Insert(key, RID(0, order[n]), &transaction);
+    expected[KeyBytes(key)] = order[n];
+  }
+  CheckTree(bpm, &tree, expected, &schema);
+  for (const auto &entry : expected) {
+    tree.Remove(MakeKey(entry.second, &schema), &transaction);
+  }
+  CheckTree(bpm, &tree, {}, &schema);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+}
+
+/** Inserts the keys, then looks all of them up; returns the shape of the tree. */
+template <typename KeyComparator>
+BPlusTreeStats BuildAndLookUp(const std::string &name, const std::vector<Tuple> &tuples, Schema *schema) {
+  KeyComparator comparator(schema);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(1024, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<64>, RID, KeyComparator> tree("foo_pk", bpm, comparator);
+
+  std::vector<GenericKey<64>> keys(tuples.size());
+  for (size_t i = 0; i < tuples.size(); i++) {
+    MakeIndexKey(tuples[i], comparator, &keys[i]);
+    tree.Insert(keys[i], RID(0, static_cast<uint32_t>(i)));
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::vector<RID> result;
+  size_t found = 0;
+  for (const auto &key : keys) {
+    found += tree.GetValue(key, &result) ? 1 : 0;
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(keys.size(), found);
+  BPlusTreeStats stats = tree.GetStats();
+  EXPECT_EQ(static_cast<int64_t>(keys.size()), stats.entries_);
+  ::testing::Test::RecordProperty(name + "_stats", stats.ToString());
+  ::testing::Test::RecordProperty(name + "_lookups_per_sec",
+                                 std::to_string(static_cast<uint64_t>(keys.size() / elapsed)));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  return stats;
+}
+
+}  // namespace
+
+TEST(BPlusTreePrefixTests, SmallPagesTest) { RunRandomTest(6, 6, 2000); }
+
+TEST(BPlusTreePrefixTests, FullPagesTest) {
+  // pages as full as their prefix lets them get
+  RunRandomTest(INT_MAX, INT_MAX, 20000);
+}
+
+TEST(BPlusTreePrefixTests, BulkLoadTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 20)});
+  Comparator comparator(&schema);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(256, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  Tree tree("foo_pk", bpm, comparator);
+
+  std::map<std::string, int> expected;
+  for (int i = 0; i < 20000; i++) {
+    expected[KeyBytes(MakeKey(i, &schema))] = i;
+  }
+  auto next = expected.begin();
+  tree.BulkLoad([&next, &expected](Key *key, RID *rid) {
+    if (next == expected.end()) {
+      return false;
+    }
+    memcpy(key->data_, next->first.data(), sizeof(key->data_));
+    rid->Set(0, next->second);
+    ++next;
+    return true;
+  });
+  CheckTree(bpm, &tree, expected, &schema);
+  Transaction transaction(0);
+  for (int i = 20000; i < 30000; i++) {
+    Key key = MakeKey(i, &schema);
+    tree.Insert(key, RID(0, i), &transaction);
+    expected[KeyBytes(key)] = i;
+  }
+  CheckTree(bpm, &tree, expected, &schema);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+}
+
+TEST(BPlusTreePrefixTests, PrefixCompressionTest) {
+  // Keys of an integer and a URL, the URLs sharing a long prefix. Compared through Value, pages store whole keys;
+  // normalized, they store what the keys of a page do not share.
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 48)});
+  const int num_keys = 30000;
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < num_keys; i++) {
+    std::string url = "https://example.com/item/" + std::to_string(i);
+    tuples.emplace_back(std::vector<Value>{ValueFactory::GetIntegerValue(i % 4), ValueFactory::GetVarcharValue(url)},
+                        &schema);
+  }
+  std::shuffle(tuples.begin(), tuples.end(), std::mt19937(0));
+  BPlusTreeStats whole = BuildAndLookUp<GenericComparator<64>>("whole_keys", tuples, &schema);
+  BPlusTreeStats prefix = BuildAndLookUp<MemcmpComparator<64>>("prefix_compressed", tuples, &schema);
+  EXPECT_LT(prefix.leaf_pages_, whole.leaf_pages_);
+  EXPECT_LE(prefix.height_, whole.height_);
+}
+
+}  // namespace bustub
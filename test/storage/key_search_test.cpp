@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_search_test.cpp
+//
+// Identification: test/storage/key_search_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/rid.h"
+#include "gtest/gtest.h"
+#include "storage/index/key_search.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+// sorted keys with gaps between them, so searches hit both present and missing keys
+template <size_t KeySize>
+std::vector<std::pair<GenericKey<KeySize>, RID>> MakeEntries(Schema *schema, const std::vector<int64_t> &values) {
+  std::vector<std::pair<GenericKey<KeySize>, RID>> entries(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    Value value = schema->GetColumn(0).GetType() == TypeId::BIGINT
+                      ? ValueFactory::GetBigIntValue(values[i])
+                      : ValueFactory::GetIntegerValue(static_cast<int32_t>(values[i]));
+    Tuple tuple({value}, schema);
+    entries[i].first.SetFromKey(tuple);
+    entries[i].second = RID(static_cast<page_id_t>(i), 0);
+  }
+  return entries;
+}
+
+template <size_t KeySize>
+void CheckSearches(Schema *schema) {
+  GenericComparator<KeySize> comparator(schema);
+  std::mt19937 rng(15445);
+  for (int size : {0, 1, 3, 16, 17, 40, 255}) {
+    std::vector<int64_t> values;
+    for (int i = 0; i < size; i++) {
+      values.push_back(3 * i - 200);
+    }
+    auto entries = MakeEntries<KeySize>(schema, values);
+    for (int probe = -210; probe < 3 * size - 190; probe++) {
+      auto key = MakeEntries<KeySize>(schema, {probe})[0].first;
+      int begin = size == 0 ? 0 : static_cast<int>(rng() % size);
+      int lower = std::lower_bound(values.begin() + begin, values.end(), probe) - values.begin();
+      int upper = std::upper_bound(values.begin() + begin, values.end(), probe) - values.begin();
+      ASSERT_EQ(lower, KeyLowerBound(entries.data(), begin, size, key, comparator)) << size << " " << probe;
+      ASSERT_EQ(upper, KeyUpperBound(entries.data(), begin, size, key, comparator)) << size << " " << probe;
+    }
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(KeySearchTest, IntegerKeyTest) {
+  Schema bigint_schema({Column("a", TypeId::BIGINT)});
+  GenericComparator<8> bigint_comparator(&bigint_schema);
+  EXPECT_EQ(8, bigint_comparator.GetIntegerKeyWidth());
+  CheckSearches<8>(&bigint_schema);
+  CheckSearches<16>(&bigint_schema);
+
+  Schema integer_schema({Column("a", TypeId::INTEGER)});
+  GenericComparator<4> integer_comparator(&integer_schema);
+  EXPECT_EQ(4, integer_comparator.GetIntegerKeyWidth());
+  CheckSearches<4>(&integer_schema);
+  CheckSearches<8>(&integer_schema);
+}
+
+// NOLINTNEXTLINE
+TEST(KeySearchTest, FallbackTest) {
+  // two columns are compared through Value, one after the other
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::INTEGER)});
+  GenericComparator<8> comparator(&schema);
+  EXPECT_EQ(0, comparator.GetIntegerKeyWidth());
+
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  for (int32_t a = 0; a < 10; a++) {
+    for (int32_t b = 0; b < 10; b += 2) {
+      Tuple tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetIntegerValue(b)}, &schema);
+      entries.emplace_back();
+      entries.back().first.SetFromKey(tuple);
+    }
+  }
+  auto size = static_cast<int>(entries.size());
+  for (int32_t a = 0; a < 10; a++) {
+    for (int32_t b = 0; b < 10; b++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetIntegerValue(b)}, &schema);
+      GenericKey<8> key;
+      key.SetFromKey(tuple);
+      EXPECT_EQ(a * 5 + (b + 1) / 2, KeyLowerBound(entries.data(), 0, size, key, comparator));
+      EXPECT_EQ(a * 5 + b / 2 + 1, KeyUpperBound(entries.data(), 0, size, key, comparator));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(KeySearchTest, DISABLED_LeafSearchBenchmark) {
+  // Lower bound searches over a full leaf of bigint keys, comparing through Value as before and with the integer path.
+  Schema schema({Column("a", TypeId::BIGINT)});
+  GenericComparator<8> comparator(&schema);
+  auto value_comparator = [&schema](const GenericKey<8> &lhs, const GenericKey<8> &rhs) {
+    Value lhs_value = lhs.ToValue(&schema, 0);
+    Value rhs_value = rhs.ToValue(&schema, 0);
+    if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    return lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue ? 1 : 0;
+  };
+  const int size = 255;
+  const int num_searches = 200000;
+  std::vector<int64_t> values;
+  for (int i = 0; i < size; i++) {
+    values.push_back(2 * i);
+  }
+  auto entries = MakeEntries<8>(&schema, values);
+  std::vector<GenericKey<8>> keys(1024);
+  std::mt19937 rng(0);
+  for (auto &key : keys) {
+    key.SetFromInteger(rng() % (2 * size));
+  }
+
+  int64_t checksum[2] = {0, 0};
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_searches; i++) {
+    checksum[0] += ComparatorKeyBound<false>(entries.data(), 0, size, keys[i % keys.size()], value_comparator);
+  }
+  auto value_elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_searches; i++) {
+    checksum[1] += KeyLowerBound(entries.data(), 0, size, keys[i % keys.size()], comparator);
+  }
+  auto integer_elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(checksum[0], checksum[1]);
+  RecordProperty("value_compare_ns_per_search", std::to_string(value_elapsed / num_searches));
+  RecordProperty("integer_search_ns_per_search", std::to_string(integer_elapsed / num_searches));
+}
+
+}  // namespace bustub
@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// normalized_key_test.cpp
+//
+// Identification: test/storage/normalized_key_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+// compares like the columns do one after the other, with NULL first
+int CompareValues(const Tuple &lhs, const Tuple &rhs, const Schema *schema) {
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    Value lhs_value = lhs.GetValue(schema, i);
+    Value rhs_value = rhs.GetValue(schema, i);
+    if (lhs_value.IsNull() || rhs_value.IsNull()) {
+      if (lhs_value.IsNull() != rhs_value.IsNull()) {
+        return lhs_value.IsNull() ? -1 : 1;
+      }
+      continue;
+    }
+    if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int Sign(int value) { return value < 0 ? -1 : (value > 0 ? 1 : 0); }
+
+template <typename KeyComparator>
+void RunTreeBenchmark(const std::string &name, const std::vector<Tuple> &tuples, Schema *key_schema) {
+  KeyComparator comparator(key_schema);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(1024, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  BPlusTree<GenericKey<32>, RID, KeyComparator> tree("foo_pk", bpm, comparator);
+
+  std::vector<GenericKey<32>> keys(tuples.size());
+  for (size_t i = 0; i < tuples.size(); i++) {
+    MakeIndexKey(tuples[i], comparator, &keys[i]);
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < keys.size(); i++) {
+    tree.Insert(keys[i], RID(static_cast<page_id_t>(i), 0));
+  }
+  auto insert_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  start = std::chrono::steady_clock::now();
+  std::vector<RID> result;
+  size_t found = 0;
+  for (const auto &key : keys) {
+    found += tree.GetValue(key, &result) ? 1 : 0;
+  }
+  auto lookup_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(found, keys.size());
+  ::testing::Test::RecordProperty(name + "_inserts_per_sec",
+                                 std::to_string(static_cast<uint64_t>(keys.size() / insert_elapsed)));
+  ::testing::Test::RecordProperty(name + "_lookups_per_sec",
+                                 std::to_string(static_cast<uint64_t>(keys.size() / lookup_elapsed)));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(NormalizedKeyTest, OrderTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::DECIMAL), Column("c", TypeId::VARCHAR, 8),
+                 Column("d", TypeId::BIGINT), Column("e", TypeId::SMALLINT)});
+  std::mt19937 rng(15445);
+  auto pick = [&rng](int n) { return static_cast<int>(rng() % n); };
+  std::vector<std::string> strings = {"", "a", "ab", "abc", "b", "ba", std::string("a\0b", 3), std::string("a\0", 2)};
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 400; i++) {
+    // few distinct values per column, so later columns get to break ties
+    std::vector<Value> values;
+    values.push_back(pick(8) == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                  : ValueFactory::GetIntegerValue(pick(5) - 2));
+    values.push_back(pick(8) == 0 ? ValueFactory::GetNullValueByType(TypeId::DECIMAL)
+                                  : ValueFactory::GetDecimalValue((pick(5) - 2) * 0.75));
+    // a tuple cannot hold a NULL varchar
+    values.push_back(ValueFactory::GetVarcharValue(strings[pick(strings.size())]));
+    values.push_back(ValueFactory::GetBigIntValue(pick(2) == 0 ? -(int64_t{1} << 40) : int64_t{1} << 40));
+    values.push_back(ValueFactory::GetSmallIntValue(static_cast<int16_t>(pick(3) - 1)));
+    tuples.emplace_back(values, &schema);
+  }
+  std::vector<GenericKey<64>> keys(tuples.size());
+  for (size_t i = 0; i < tuples.size(); i++) {
+    keys[i].SetFromKey(tuples[i], &schema);
+  }
+  MemcmpComparator<64> comparator(&schema);
+  for (size_t i = 0; i < tuples.size(); i++) {
+    for (size_t j = 0; j < tuples.size(); j++) {
+      ASSERT_EQ(CompareValues(tuples[i], tuples[j], &schema), Sign(comparator(keys[i], keys[j]))) << i << " " << j;
+    }
+  }
+
+  // -0.0 and 0.0 are the same key
+  Schema decimal_schema({Column("a", TypeId::DECIMAL)});
+  GenericKey<16> positive_zero;
+  GenericKey<16> negative_zero;
+  positive_zero.SetFromKey(Tuple({ValueFactory::GetDecimalValue(0.0)}, &decimal_schema), &decimal_schema);
+  negative_zero.SetFromKey(Tuple({ValueFactory::GetDecimalValue(-0.0)}, &decimal_schema), &decimal_schema);
+  EXPECT_EQ(0, MemcmpComparator<16>(&decimal_schema)(positive_zero, negative_zero));
+}
+
+// NOLINTNEXTLINE
+TEST(NormalizedKeyTest, KeySizeTest) {
+  // a bigint takes 9 bytes normalized, its null/value byte included, so it does not fit a GenericKey<8>
+  Schema bigint_schema({Column("a", TypeId::BIGINT)});
+  EXPECT_EQ(9, NormalizedKeySize(&bigint_schema));
+  EXPECT_THROW(MemcmpComparator<8>{&bigint_schema}, Exception);
+  GenericKey<8> short_key;
+  EXPECT_THROW(short_key.SetFromKey(Tuple({ValueFactory::GetBigIntValue(1)}, &bigint_schema), &bigint_schema),
+               Exception);
+
+  // bigints differing only in their low byte are different keys once the key is large enough
+  MemcmpComparator<16> comparator(&bigint_schema);
+  GenericKey<16> lhs;
+  GenericKey<16> rhs;
+  lhs.SetFromKey(Tuple({ValueFactory::GetBigIntValue(0x100)}, &bigint_schema), &bigint_schema);
+  rhs.SetFromKey(Tuple({ValueFactory::GetBigIntValue(0x101)}, &bigint_schema), &bigint_schema);
+  EXPECT_GT(0, comparator(lhs, rhs));
+  EXPECT_LT(0, comparator(rhs, lhs));
+
+  // a varchar whose escaped zero bytes outgrow the key is refused rather than cut off
+  Schema varchar_schema({Column("a", TypeId::VARCHAR, 8)});
+  EXPECT_EQ(11, NormalizedKeySize(&varchar_schema));
+  GenericKey<16> varchar_key;
+  EXPECT_NO_THROW(varchar_key.SetFromKey(Tuple({ValueFactory::GetVarcharValue("abcdefgh")}, &varchar_schema),
+                                         &varchar_schema));
+  EXPECT_THROW(varchar_key.SetFromKey(Tuple({ValueFactory::GetVarcharValue(std::string(8, '\0'))}, &varchar_schema),
+                                      &varchar_schema),
+               Exception);
+}
+
+// NOLINTNEXTLINE
+TEST(NormalizedKeyTest, DISABLED_TreeBenchmark) {
+  // Inserts and lookups of (integer, varchar) keys in random order, compared through Value as before and with memcmp
+  // on normalized keys.
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 12)});
+  const int num_keys = 20000;
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < num_keys; i++) {
+    tuples.emplace_back(std::vector<Value>{ValueFactory::GetIntegerValue(i % 100),
+                                           ValueFactory::GetVarcharValue("key" + std::to_string(i))},
+                        &schema);
+  }
+  std::shuffle(tuples.begin(), tuples.end(), std::mt19937(0));
+  RunTreeBenchmark<GenericComparator<32>>("value_compare", tuples, &schema);
+  RunTreeBenchmark<MemcmpComparator<32>>("memcmp_compare", tuples, &schema);
+}
+
+}  // namespace bustub
@@ -19,7 +19,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
+TEST(TmpTuplePageTest, BasicTest) {
   // There are many ways to do this assignment, and this is only one of them.
   // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
   // You will get full credit as long as you are correctly using a linear probe hash table.
@@ -46,6 +46,21 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), PAGE_SIZE - 8);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 8), 4);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 4), 123);
+  ASSERT_EQ(TmpTuple(page_id, PAGE_SIZE - 8), tmp_tuple);
+
+  // the page takes tuples until it is full, and gives them back newest first
+  int32_t inserted = 1;
+  while (page.Insert(Tuple({ValueFactory::GetIntegerValue(123 + inserted)}, &schema), &tmp_tuple)) {
+    inserted++;
+  }
+  ASSERT_EQ((PAGE_SIZE - 12) / 8, inserted);
+  int32_t read = 0;
+  Tuple read_tuple;
+  for (uint32_t offset = page.GetFreeSpacePointer(); offset < PAGE_SIZE; read++) {
+    offset = page.Get(offset, &read_tuple);
+    ASSERT_EQ(123 + inserted - 1 - read, read_tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  }
+  ASSERT_EQ(inserted, read);
 }
 
 }  // namespace bustub
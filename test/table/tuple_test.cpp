@@ -13,7 +13,9 @@
 #include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -21,6 +23,7 @@
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -71,4 +74,110 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapReadAheadTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Column col3{"c", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2, col3};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManager(16, disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, nullptr, nullptr, transaction);
+  const int num_tuples = 5000;
+  for (int i = 0; i < num_tuples; ++i) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+  }
+  // the table is several times larger than the pool, so the scan below starts cold
+  ASSERT_GT(disk_manager->GetNextPageId(), 2 * 16);
+
+  // Scenario: the scan sees every tuple, and its sequential page chain triggers read-ahead.
+  int count = 0;
+  for (auto itr = table->Begin(transaction); itr != table->End(); ++itr) {
+    count++;
+  }
+  EXPECT_EQ(num_tuples, count);
+  EXPECT_GT(buffer_pool_manager->GetNumPrefetches(), 0);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete table;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapBatchedGetTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 100};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManager(16, disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, nullptr, nullptr, transaction);
+  const int num_tuples = 5000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; ++i) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(80, 'x'))}, &schema);
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    rids.push_back(rid);
+  }
+  ASSERT_GT(disk_manager->GetNextPageId(), 4 * 16);
+  // the order of an index on a column the table is not clustered on
+  std::shuffle(rids.begin(), rids.end(), std::mt19937(0));
+  rids.emplace_back(rids[0].GetPageId(), 1000);  // no such slot
+
+  // Scenario: fetching one rid at a time fetches a page per tuple, a batch fetches each page once.
+  size_t evictions = buffer_pool_manager->GetNumEvictions();
+  for (int i = 0; i < num_tuples; ++i) {
+    Tuple tuple;
+    ASSERT_TRUE(table->GetTuple(rids[i], &tuple, transaction));
+  }
+  size_t single_evictions = buffer_pool_manager->GetNumEvictions() - evictions;
+
+  evictions = buffer_pool_manager->GetNumEvictions();
+  std::vector<std::pair<size_t, Tuple>> tuples;
+  ASSERT_TRUE(table->GetTuples(rids, &tuples, transaction));
+  size_t batched_evictions = buffer_pool_manager->GetNumEvictions() - evictions;
+  EXPECT_LT(batched_evictions * 4, single_evictions);
+
+  // Scenario: tuples come back in the order of the rids, the missing one left out.
+  ASSERT_EQ(num_tuples, tuples.size());
+  for (int i = 0; i < num_tuples; ++i) {
+    EXPECT_EQ(static_cast<size_t>(i), tuples[i].first);
+    EXPECT_EQ(rids[i], tuples[i].second.GetRid());
+  }
+
+  // Scenario: without keeping the order, tuples come back in the order they are stored in.
+  ASSERT_TRUE(table->GetTuples(rids, &tuples, transaction, false));
+  ASSERT_EQ(num_tuples, tuples.size());
+  for (int i = 0; i < num_tuples; ++i) {
+    EXPECT_EQ(rids[tuples[i].first], tuples[i].second.GetRid());
+    if (i > 0) {
+      RID prev = tuples[i - 1].second.GetRid();
+      RID cur = tuples[i].second.GetRid();
+      EXPECT_TRUE(prev.GetPageId() < cur.GetPageId() ||
+                  (prev.GetPageId() == cur.GetPageId() && prev.GetSlotNum() < cur.GetSlotNum()));
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete table;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
 }  // namespace bustub